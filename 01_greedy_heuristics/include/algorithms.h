@@ -2,15 +2,22 @@
 #define ALGORITHMS_H
 
 #include "utils.h"
+#include "rng.h"
+#include "spatial_grid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 // Forward declaration of Algo structure
 typedef struct Algo Algo;
 
 // Define the Algo structure with a name and a solve function pointer
+// Every random decision of solve draws from rng, so a seeded rng makes a run reproducible
 struct Algo
 {
     const char *name;
-    Result (*solve)(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions);
+    Result (*solve)(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng);
 };
 
 // Function declarations for algorithms
@@ -27,17 +34,28 @@ RandomSearch *create_RandomSearch();
 typedef struct
 {
     Algo base;
+    // Index over the instance the solver runs on, owned by the caller; with NULL every
+    // step scans a row of the distance matrix
+    const SpatialGrid *grid;
+    int solution_size; // nodes every construction selects, 0 for (num_nodes + 1) / 2
 } NearestNeighboursEndInsert;
 
-NearestNeighboursEndInsert *create_NearestNeighboursEndInsert();
+// grid is the spatial_grid_build index of the instances solved, or NULL for the linear scan
+NearestNeighboursEndInsert *create_NearestNeighboursEndInsert(const SpatialGrid *grid);
 
 // NearestNeighboursAnywhereInsert Algorithm
 typedef struct
 {
     Algo base;
+    // Index over the instance the solver runs on, owned by the caller. With it, every step
+    // prices the insertions of only the nodes whose lower bound can reach the insertion of
+    // the grid's nearest node; with NULL it prices every node. Both build the same tours.
+    const SpatialGrid *grid;
+    int solution_size; // nodes every construction selects, 0 for (num_nodes + 1) / 2
 } NearestNeighboursAnywhereInsert;
 
-NearestNeighboursAnywhereInsert *create_NearestNeighboursAnywhereInsert();
+// grid is the spatial_grid_build index of the instances solved, or NULL for the full scan
+NearestNeighboursAnywhereInsert *create_NearestNeighboursAnywhereInsert(const SpatialGrid *grid);
 
 // GreedyCycle Algorithm
 typedef struct
@@ -66,7 +84,24 @@ Greedy2RegretWeighted *create_Greedy2RegretWeighted();
 // Function to free a Result structure
 void free_Result(Result res);
 
+// Result returned by a solver that failed, with no solutions
+Result result_failed(void);
+
+// Allocates the best and worst buffers of a Result once, for solutions of at most
+// solution_size nodes; returns 0 (and a failed Result) if the allocation failed
+int result_init(Result *res, int solution_size);
+
+// Copies the solution into the best and/or worst buffer if it beats them, without allocating
+void result_record(Result *res, const int *solution, int solution_size, int cost);
+
+// Sets the average cost and releases the buffers if no solution was recorded
+void result_finish(Result *res, long long total_cost, int num_solutions);
+
 // Function to print the Result
 void print_Result(const Result res, const int **distances, const int *costs);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -0,0 +1,62 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Alignment of every arena allocation, enough for any scalar type. */
+#define ARENA_ALIGNMENT 16
+
+typedef struct ArenaBlock ArenaBlock;
+
+/**
+ * @brief Bump allocator for per-iteration scratch of a solver.
+ * Allocations are carved out of one block and released all at once by arena_reset, so an
+ * iteration that allocates the same buffers as the previous one does not call malloc.
+ * When a block is exhausted the arena chains a larger one; the next reset merges all
+ * blocks into a single block of their total size, so the arena settles after one iteration.
+ * An arena is owned by a single thread.
+ */
+typedef struct {
+    ArenaBlock* current; // Block allocations are carved from, NULL if initialization failed
+} Arena;
+
+/**
+ * @brief Allocates the first block of an arena.
+ *
+ * @param arena Arena to initialize.
+ * @param capacity Expected bytes per iteration; exceeding it only costs one extra block.
+ * @return 1 on success, 0 if the allocation failed (the arena is then empty but can be destroyed).
+ */
+int arena_init(Arena* arena, size_t capacity);
+
+/**
+ * @brief Releases every block of an arena.
+ */
+void arena_destroy(Arena* arena);
+
+/**
+ * @brief Returns size bytes aligned to ARENA_ALIGNMENT, valid until the next reset.
+ *
+ * @return Pointer to the memory, or NULL if a new block was needed and could not be allocated.
+ */
+void* arena_alloc(Arena* arena, size_t size);
+
+/**
+ * @brief Like arena_alloc for count elements of size bytes, zero-filled.
+ */
+void* arena_calloc(Arena* arena, size_t count, size_t size);
+
+/**
+ * @brief Releases all allocations at once, merging the blocks if the arena grew.
+ */
+void arena_reset(Arena* arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_H
@@ -0,0 +1,72 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Polls between two clock reads, about a microsecond of move evaluations. */
+#define DEADLINE_CHECK_INTERVAL 256
+
+/**
+ * @brief Cooperative time budget polled from the inner loops of a search.
+ * deadline_poll costs a decrement per call and reads the clock every DEADLINE_CHECK_INTERVAL
+ * calls; on x86 the clock is the time-stamp counter, calibrated against CLOCK_MONOTONIC once
+ * per process. Every clock read also reads the optional cancellation flag. Expiry is sticky.
+ * A deadline is polled by a single thread.
+ */
+typedef struct {
+    uint64_t end_ticks;     // Clock value at which the budget is used up
+    const int* cancel_flag; // Expires the budget once non-zero, NULL if none
+    int countdown;          // Polls left until the next clock read
+    int expired;
+} Deadline;
+
+/**
+ * @brief Starts a budget of budget_us microseconds from now.
+ */
+void deadline_init(Deadline* deadline, long long budget_us);
+
+/**
+ * @brief Starts a budget of budget_us microseconds from now that also expires once *cancel_flag
+ * is non-zero (NULL for none). The flag may be set from another thread with an atomic store,
+ * e.g. __atomic_store_n(flag, 1, __ATOMIC_RELAXED); it is read with an atomic load.
+ */
+void deadline_init_cancellable(Deadline* deadline, long long budget_us, const int* cancel_flag);
+
+/**
+ * @brief Reads the clock now.
+ *
+ * @return 1 if the budget is used up, 0 otherwise.
+ */
+int deadline_check(Deadline* deadline);
+
+/**
+ * @brief Cheap expiry test for inner loops; NULL never expires.
+ *
+ * @return 1 if the budget is used up, 0 otherwise (possibly up to DEADLINE_CHECK_INTERVAL polls late).
+ */
+static inline int deadline_poll(Deadline* deadline)
+{
+    if (!deadline)
+        return 0;
+    if (--deadline->countdown > 0)
+        return deadline->expired;
+    return deadline_check(deadline);
+}
+
+/**
+ * @brief Whether a previous poll or check saw the budget used up; NULL never expires.
+ */
+static inline int deadline_expired(const Deadline* deadline)
+{
+    return deadline && deadline->expired;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEADLINE_H
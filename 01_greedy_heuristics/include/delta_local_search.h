@@ -3,6 +3,17 @@
 
 #include "utils.h"
 #include "algorithms.h"
+#include "arena.h"
+#include "deadline.h"
+#include "tour_hash.h"
+#include <limits.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Returned by a descent, instead of a cost, that reached a tour recorded in its SeenSet
+#define DESCENT_SEEN INT_MIN
 
 // Define DeltaLocalSearch struct
 // delta_local_search.h
@@ -16,4 +27,27 @@ typedef struct {
 // Function to create a DeltaLocalSearch algorithm
 DeltaLocalSearch* create_DeltaLocalSearch(int method_index, int* initial_solution, int initial_solution_size);
 
+// Runs the move-list steepest descent on solution in place and returns its cost, or INT_MAX
+// if scratch could not provide memory. All scratch comes from the arena, which the caller
+// resets; reusing one arena makes repeated descents allocation-free. The descent stops
+// early, with a valid solution, once deadline expires (NULL for no limit).
+// With a SeenSet (NULL for none), the hash of every tour on the path goes into it, and the
+// descent returns DESCENT_SEEN as soon as it reaches a tour already there, as its remaining
+// path was explored before; solution is then valid but not a local optimum.
+int delta_local_search_run(int* solution, int solution_size, const int** distances, const int* costs, int num_nodes, Arena* scratch, Deadline* deadline, SeenSet* seen);
+
+// Arena capacity a descent usually needs (the move list may still grow beyond it)
+size_t delta_local_search_scratch_size(int num_nodes);
+
+#ifdef TOUR_HASH_CHECK
+// Test builds recompute the hash of the tour after every move a descent with a SeenSet
+// applies and count the moves checked and those whose running hash differed; not thread-safe
+extern long long tour_hash_checked_moves;
+extern long long tour_hash_check_failures;
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // DELTA_LOCAL_SEARCH_H
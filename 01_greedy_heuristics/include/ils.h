@@ -2,19 +2,44 @@
 #define ILS_H
 
 #include "algorithms.h"
+#include "trace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /**
  * @brief Structure for Iterated Local Search (ILS) algorithm.
  * Inherits from the base Algo structure.
+ * Runs as an island model: every island is an ILS chain on its own thread, and islands
+ * periodically pass their best solution to the next island in a ring.
  */
 typedef struct {
     Algo base;              // Base algorithm structure
-    int max_time_ms;       // Maximum running time in milliseconds
+    int max_time_ms;       // Maximum running time in milliseconds (shared deadline of all islands)
     int perturbation_strength; // Number of perturbation moves
+    int num_islands;       // Number of concurrently running ILS chains
+    int migration_interval_ms; // Period of elite migration between islands
+    int solution_size;     // Nodes every island selects, 0 for (num_nodes + 1) / 2
+    int seen_capacity;     // Tours the islands remember together to skip repeated descents, 0 disables
+    Trace* trace;          // Optional convergence trace of the best solution, NULL to disable
+    int quiet;             // Non-zero stops solve from printing its iteration count to stdout
+    const int* cancel_flag; // Ends every island early once non-zero, NULL to disable (see deadline_init_cancellable)
+    int last_iterations;   // Iterations (descents started) of all islands in the last solve
+    int last_abandoned;    // Of those, descents abandoned at a seen tour
 } ILS;
 
 /**
  * @brief Creates an instance of the ILS algorithm.
+ * Defaults to 20 islands migrating every max_time_ms / 10 milliseconds, without a trace or
+ * a cancellation flag, printing the iteration count of every solve. A cancelled solve returns
+ * the best solution found so far; the first descent of every island is kept even if cut short.
+ * By default the islands share a set of 2^20 tours: a descent that reaches a tour any island
+ * passed through before is abandoned, as its remaining path leads to a known local optimum.
+ * It still counts as an iteration, so iterations keep meaning descents started, and solve
+ * prints the number abandoned after the iteration count.
+ * When a trace is attached, every solve clears it and records each improvement of the
+ * best solution over all islands; the iteration is the one of the island that found it.
  *
  * @param max_time_ms Maximum running time in milliseconds.
  * @param perturbation_strength Number of moves to perturb the solution.
@@ -22,4 +47,8 @@ typedef struct {
  */
 ILS* create_ILS(int max_time_ms, int perturbation_strength);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif // ILS_H
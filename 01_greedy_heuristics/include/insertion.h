@@ -0,0 +1,59 @@
+#ifndef INSERTION_H
+#define INSERTION_H
+
+#include <stddef.h>
+#include "arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Incremental cheapest-insertion state of a cycle grown by the greedy constructors.
+ * Every node outside the cycle keeps its cheapest and second-cheapest insertion cost (path
+ * increase plus node cost) and the edge each one refers to, an edge being named by its tail.
+ * Inserting a node into edge (a, b) only replaces that edge, so a node is rescanned over the
+ * whole cycle only when one of its two entries referred to (a, b); every other node compares
+ * the two new edges. A construction then takes about O(n^2) instead of O(n^3).
+ */
+typedef struct {
+    const int** distances;
+    const int* costs;
+    int num_nodes;
+    int size;         // Nodes in the cycle
+    int head;         // Any node of the cycle, where rescans start
+    int* next;        // Successor of each node of the cycle
+    char* in_cycle;
+    int* best_cost;   // Cheapest insertion cost of each node outside the cycle
+    int* best_edge;   // Tail of the edge best_cost refers to
+    int* second_cost; // Second-cheapest cost, equal to best_cost on a tie between two edges
+    int* second_edge;
+} InsertionCache;
+
+/**
+ * @brief Arena capacity insertion_init takes.
+ */
+size_t insertion_scratch_size(int num_nodes);
+
+/**
+ * @brief Starts the cycle first -> second -> first and computes the costs of all other nodes.
+ *
+ * @return 1 on success, 0 if scratch could not provide the buffers.
+ */
+int insertion_init(InsertionCache* cache, const int** distances, const int* costs, int num_nodes, int first, int second, Arena* scratch);
+
+/**
+ * @brief Inserts node, which must be outside the cycle, into its cheapest edge and updates the other nodes.
+ */
+void insertion_insert(InsertionCache* cache, int node);
+
+/**
+ * @brief Writes the cycle into solution (cache->size entries), starting at node start.
+ */
+void insertion_write_cycle(const InsertionCache* cache, int start, int* solution);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INSERTION_H
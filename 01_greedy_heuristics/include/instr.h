@@ -0,0 +1,76 @@
+#ifndef INSTR_H
+#define INSTR_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Hot-path counters and phase times of one run.
+ * Every thread accumulates into its own instance, so the hot path needs no locking.
+ */
+typedef struct {
+    int64_t inter_route_evals;  // delta_inter_route_exchange and candidate variant calls
+    int64_t intra_nodes_evals;  // delta_two_nodes_exchange calls
+    int64_t intra_edges_evals;  // delta_two_edges_exchange and candidate variant calls
+    int64_t applied_moves;      // improving moves applied by the local searches
+    int64_t perturbation_ns;    // time spent perturbing (destroying) ILS solutions
+    int64_t local_search_ns;    // time spent in local search descents
+    int64_t move_list_hits;     // move list entries that were still applicable
+    int64_t move_list_stale;    // move list entries dropped as invalid or reversed
+    int64_t local_searches;     // local search descents started by perform_local_search
+    int64_t descents_seen;      // descents abandoned on reaching a tour seen before
+} InstrCounters;
+
+/** @brief Counters of the calling thread; C++ code outside the C solvers uses instr_take. */
+#ifdef __cplusplus
+extern thread_local InstrCounters instr_counters;
+#else
+extern _Thread_local InstrCounters instr_counters;
+#endif
+
+/**
+ * @brief Returns the counters of the calling thread and clears them.
+ */
+InstrCounters instr_take(void);
+
+/**
+ * @brief Adds counters gathered on another thread (e.g. a worker) to the calling thread's.
+ */
+void instr_merge(const InstrCounters* other);
+
+/**
+ * @brief Monotonic clock in nanoseconds, used for the phase times.
+ */
+int64_t instr_now_ns(void);
+
+/**
+ * @brief Writes the counters as one JSON line.
+ *
+ * @param out Output stream.
+ * @param algorithm Name of the algorithm, stored in the "algorithm" field.
+ * @param instance Name of the instance, stored in the "instance" field.
+ * @param counters Counters to write.
+ */
+void instr_print_json(FILE* out, const char* algorithm, const char* instance, const InstrCounters* counters);
+
+// Instrumentation is compiled in only with -DINSTRUMENTATION (make INSTRUMENTATION=1);
+// otherwise these expand to nothing.
+#ifdef INSTRUMENTATION
+#define INSTR_COUNT(field, amount) (instr_counters.field += (amount))
+#define INSTR_PHASE_BEGIN(name) int64_t instr_phase_##name = instr_now_ns()
+#define INSTR_PHASE_END(name, field) (instr_counters.field += instr_now_ns() - instr_phase_##name)
+#else
+#define INSTR_COUNT(field, amount) ((void)0)
+#define INSTR_PHASE_BEGIN(name) ((void)0)
+#define INSTR_PHASE_END(name, field) ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INSTR_H
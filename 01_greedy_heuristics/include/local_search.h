@@ -3,6 +3,9 @@
 
 #include "utils.h"
 #include "algorithms.h"
+#include "arena.h"
+#include "deadline.h"
+#include "tour_hash.h"
 
 // Define LocalSearch struct
 typedef struct
@@ -17,7 +20,11 @@ typedef struct
 // Function to create a LocalSearch algorithm
 LocalSearch* create_LocalSearch(int local_search_type, int intra_route_move_type, int starting_solution_type, int method_index);
 
-Result perform_local_search(int* current_solution, int solution_size, const int** distances, const int* costs, int num_nodes);
+// Improves solution in place with the delta local search, using scratch (reset first) for its buffers
+// and stopping early once deadline expires (NULL for no limit)
+// Returns the cost of the improved solution, INT_MAX if scratch could not be grown, or
+// DESCENT_SEEN if the descent reached a tour recorded in seen (NULL for none)
+int perform_local_search(int* solution, int solution_size, const int** distances, const int* costs, int num_nodes, Arena* scratch, Deadline* deadline, SeenSet* seen);
 
 
 #endif // LOCAL_SEARCH_H
@@ -0,0 +1,40 @@
+#ifndef MOVES_H
+#define MOVES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Change of the objective after swapping the nodes at positions i and j of the cycle.
+ *
+ * @param solution Cycle as an array of node indices.
+ * @param solution_size Number of nodes in the cycle.
+ * @param distances Distance matrix.
+ * @param i Position of the first node.
+ * @param j Position of the second node.
+ * @return Objective delta (negative means improvement).
+ */
+int delta_two_nodes_exchange(const int* solution, int solution_size, const int** distances, int i, int j);
+
+/**
+ * @brief Change of the objective after a 2-opt move removing edges (i, i+1) and (j, j+1).
+ * Returns 0 for identical or adjacent edges.
+ */
+int delta_two_edges_exchange(const int* solution, int solution_size, const int** distances, int i, int j);
+
+/**
+ * @brief Change of the objective after replacing the node at position i with the unselected node_j.
+ */
+int delta_inter_route_exchange(const int* solution, int solution_size, const int** distances, const int* costs, int i, int node_j);
+
+/**
+ * @brief Reverses the cyclic segment solution[start..end] in place (applies a 2-opt move).
+ */
+void reverse_segment(int* solution, int start, int end, int solution_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MOVES_H
@@ -3,6 +3,10 @@
 
 #include "algorithms.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * @brief Structure for Multiple Start Local Search (MSLS) algorithm.
  * Inherits from the base Algo structure.
@@ -10,14 +14,20 @@
 typedef struct {
     Algo base;              // Base algorithm structure
     int num_iterations;    // Number of local search iterations
+    int num_threads;       // Number of worker threads running local searches
 } MSLS;
 
 /**
  * @brief Creates an instance of the MSLS algorithm.
+ * Uses all available processors by default.
  *
  * @param num_iterations Number of local search iterations to perform.
  * @return Pointer to the created MSLS instance.
  */
 MSLS* create_MSLS(int num_iterations);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif // MSLS_H
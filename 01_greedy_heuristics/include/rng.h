@@ -0,0 +1,64 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief State of a xoshiro256** pseudo-random number generator.
+ * Each thread owns its own state, so no locking is needed.
+ */
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+/**
+ * @brief Seeds the generator from a 64-bit value (expanded with splitmix64).
+ *
+ * @param rng Generator to seed.
+ * @param seed Seed value.
+ */
+void rng_seed(Rng* rng, uint64_t seed);
+
+/**
+ * @brief Returns the next 64-bit output of the generator.
+ */
+uint64_t rng_next(Rng* rng);
+
+/**
+ * @brief Returns a uniformly distributed integer in [0, bound).
+ * Uses multiply-shift rejection sampling, which avoids the modulo bias of rand() % n.
+ *
+ * @param rng Generator to draw from.
+ * @param bound Exclusive upper bound, must be positive.
+ */
+uint32_t rng_bounded(Rng* rng, uint32_t bound);
+
+/**
+ * @brief Advances the generator by 2^128 outputs.
+ * Calling it k times on a copy of a seeded state gives k non-overlapping streams.
+ */
+void rng_jump(Rng* rng);
+
+/**
+ * @brief Fills streams[0..count) with consecutive non-overlapping streams derived from one seed.
+ *
+ * @param streams Output array of generators.
+ * @param count Number of streams.
+ * @param seed Seed of the first stream.
+ */
+void rng_split(Rng* streams, int count, uint64_t seed);
+
+/**
+ * @brief Fisher-Yates shuffle driven by the given generator.
+ */
+void rng_shuffle(Rng* rng, int* array, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RNG_H
@@ -0,0 +1,82 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Uniform grid over the node coordinates of an instance, about two nodes per cell.
+ * The grid itself is read-only once built and can be shared by threads; removals go to a
+ * SpatialView, the per-construction copy of the cell contents.
+ */
+typedef struct {
+    int num_nodes;
+    int cells_x;
+    int cells_y;
+    int min_x;
+    int min_y;
+    double cell_size;
+    int min_cost;    // Smallest node cost, the cost part of every lower bound
+    int* xs;
+    int* ys;
+    int* cell_of;    // Cell of each node
+    int* cell_start; // Offsets of the cells in cell_nodes, cells_x * cells_y + 1 entries
+    int* cell_nodes; // Nodes grouped by cell
+} SpatialGrid;
+
+/**
+ * @brief Nodes still available to one construction, removed in O(1).
+ */
+typedef struct {
+    const SpatialGrid* grid;
+    int* cell_count; // Nodes left in each cell, at the front of its range
+    int* nodes;      // Copy of cell_nodes, reordered by removals
+    int* slot;       // Index of each node in nodes
+} SpatialView;
+
+/**
+ * @brief Builds the grid from rows of (x, y, cost) as produced by read_file.
+ *
+ * @return 1 on success, 0 if an allocation failed (the grid can still be freed).
+ */
+int spatial_grid_build(SpatialGrid* grid, int** data, int num_nodes);
+
+/**
+ * @brief Releases the buffers of a grid.
+ */
+void spatial_grid_free(SpatialGrid* grid);
+
+/**
+ * @brief Arena capacity spatial_view_init takes.
+ */
+size_t spatial_view_scratch_size(const SpatialGrid* grid);
+
+/**
+ * @brief Starts a view with every node of the grid available.
+ *
+ * @return 1 on success, 0 if scratch could not provide the buffers.
+ */
+int spatial_view_init(SpatialView* view, const SpatialGrid* grid, Arena* scratch);
+
+/**
+ * @brief Marks a node as used; it must still be available.
+ */
+void spatial_view_remove(SpatialView* view, int node);
+
+/**
+ * @brief Finds the available nodes minimizing distances[from][j] + costs[j] (costs may be NULL).
+ * Searches rings of cells around from and stops once no further cell can tie the best value.
+ *
+ * @param nearest Receives every node attaining the minimum, in increasing index order.
+ * @return Number of nodes written to nearest, 0 if no node is available.
+ */
+int spatial_view_nearest(const SpatialView* view, const int** distances, const int* costs, int from, int* nearest);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPATIAL_GRID_H
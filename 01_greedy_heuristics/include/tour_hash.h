@@ -0,0 +1,82 @@
+#ifndef TOUR_HASH_H
+#define TOUR_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Zobrist-style hash of a tour: the XOR of a key per selected node and a key per
+ * undirected edge of the cycle, so rotations and reversals hash equally and every move
+ * updates it in O(1) by toggling the keys it changes.
+ * Keys are mixed from the node indices rather than drawn from a table, so any instance size
+ * works; the hashes equal those of Solution::getHash in the C++ solvers.
+ */
+static inline uint64_t tour_hash_mix(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Key of a selected node; the top bit keeps it apart from every edge key.
+ */
+static inline uint64_t tour_hash_node(int node)
+{
+    return tour_hash_mix((uint64_t)(uint32_t)node | (1ULL << 63));
+}
+
+/**
+ * @brief Key of the undirected edge between nodes a and b.
+ */
+static inline uint64_t tour_hash_edge(int a, int b)
+{
+    uint32_t low = (uint32_t)(a < b ? a : b);
+    uint32_t high = (uint32_t)(a < b ? b : a);
+    return tour_hash_mix(((uint64_t)low << 32) | high);
+}
+
+/**
+ * @brief Hash of the cycle solution[0..solution_size), computed from scratch.
+ */
+uint64_t tour_hash(const int* solution, int solution_size);
+
+/**
+ * @brief Fixed-capacity set of tour hashes that concurrent searches share without locks.
+ */
+typedef struct SeenSet SeenSet;
+
+/**
+ * @brief Creates an empty set of about capacity hashes (rounded up to a power of two).
+ *
+ * @return The set, or NULL if it could not be allocated.
+ */
+SeenSet* seen_set_create(size_t capacity);
+
+/**
+ * @brief Releases a set; NULL is ignored.
+ */
+void seen_set_destroy(SeenSet* set);
+
+/**
+ * @brief Returns 1 if hash was inserted before, 0 otherwise.
+ */
+int seen_set_contains(const SeenSet* set, uint64_t hash);
+
+/**
+ * @brief Inserts hash. A set too full to place it leaves it out, so it degrades to
+ * filtering less rather than failing.
+ *
+ * @return 0 if hash was already in the set, 1 otherwise.
+ */
+int seen_set_insert(SeenSet* set, uint64_t hash);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TOUR_HASH_H
@@ -0,0 +1,92 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief One improvement of the best solution during a time-budgeted run.
+ */
+typedef struct {
+    int64_t elapsed_us; // Time since the start of the run
+    int iteration;      // Iteration of the run that found the solution
+    int best_eval;      // Objective of the new best solution
+} TracePoint;
+
+/**
+ * @brief Convergence trace kept in a ring buffer allocated up front.
+ * Recording never allocates; once the buffer is full the oldest points are overwritten,
+ * so the end of the run (the plateau) is always kept.
+ */
+typedef struct {
+    TracePoint* points;
+    int capacity;
+    int next;           // Slot written by the next record
+    long long recorded; // Number of points recorded since the last clear
+} Trace;
+
+/**
+ * @brief Allocates the ring buffer of a trace.
+ *
+ * @param trace Trace to initialize.
+ * @param capacity Maximum number of points kept.
+ * @return 1 on success, 0 if the allocation failed.
+ */
+int trace_init(Trace* trace, int capacity);
+
+/**
+ * @brief Releases the ring buffer of a trace.
+ */
+void trace_free(Trace* trace);
+
+/**
+ * @brief Forgets all recorded points, keeping the buffer.
+ */
+void trace_clear(Trace* trace);
+
+/**
+ * @brief Appends a point, overwriting the oldest one when the buffer is full.
+ */
+static inline void trace_record(Trace* trace, int64_t elapsed_us, int iteration, int best_eval)
+{
+    TracePoint* point = &trace->points[trace->next];
+    point->elapsed_us = elapsed_us;
+    point->iteration = iteration;
+    point->best_eval = best_eval;
+    trace->next = trace->next + 1 == trace->capacity ? 0 : trace->next + 1;
+    trace->recorded++;
+}
+
+/**
+ * @brief Number of points currently held (at most the capacity).
+ */
+int trace_size(const Trace* trace);
+
+/**
+ * @brief Returns the i-th held point in chronological order.
+ */
+const TracePoint* trace_at(const Trace* trace, int i);
+
+/**
+ * @brief Writes the trace as CSV with the header elapsed_us;iteration;best_eval.
+ *
+ * @return 1 on success, 0 if the file could not be written.
+ */
+int trace_write_csv(const Trace* trace, const char* filename);
+
+/**
+ * @brief Writes the trace in binary: the magic "TRC1", a uint32 point count, then per point
+ * an int64 elapsed_us, int32 iteration and int32 best_eval in native byte order.
+ *
+ * @return 1 on success, 0 if the file could not be written.
+ */
+int trace_write_binary(const Trace* trace, const char* filename);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRACE_H
@@ -8,6 +8,10 @@
 #include <limits.h>
 #include <time.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 // Define the Result structure to store algorithm results
 typedef struct
 {
@@ -26,8 +30,8 @@ int calculate_cost(const int *solution, int solution_size, const int **distances
 // Function to calculate cost breakdown into path length and node costs
 void calculate_cost_breakdown(const int *solution, int solution_size, const int **distances, const int *costs, int *path_length, int *node_costs);
 
-// Fisher-Yates shuffle algorithm to shuffle an array
-void shuffle_array(int *array, int n);
+// Function to get the number of online processors (at least 1)
+int available_threads(void);
 
 // Function to read a CSV file with ';' delimiter
 // Assumes each line has at least three integers: x, y, cost
@@ -51,4 +55,8 @@ void free_data(int **data, int num_nodes);
 // Function to free distances matrix
 void free_distances(int **distances, int num_nodes);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -1,15 +1,19 @@
 #include "algorithms.h"
 #include "utils.h"
+#include "arena.h"
+#include "insertion.h"
 #include <limits.h>
 #include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 // Function prototypes (forward declarations)
-static Result RandomSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions);
-static Result NearestNeighboursEndInsert_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions);
-static Result NearestNeighboursAnywhereInsert_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions);
-static Result GreedyCycle_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions);
-static Result Greedy2Regret_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions);
-static Result Greedy2RegretWeighted_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions);
+static Result RandomSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng);
+static Result NearestNeighboursEndInsert_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng);
+static Result NearestNeighboursAnywhereInsert_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng);
+static Result GreedyCycle_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng);
+static Result Greedy2Regret_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng);
+static Result Greedy2RegretWeighted_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng);
 
 // ------------------ RandomSearch Algorithm ------------------
 
@@ -26,47 +30,42 @@ RandomSearch *create_RandomSearch()
     return rs;
 }
 
-static Result RandomSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions)
+static Result RandomSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng)
 {
     int solution_size = (num_nodes + 1) / 2; // Corrected to round up
 
+    // Both buffers are reused by every iteration, so one arena that is never reset suffices
+    Arena scratch;
+    Result res;
+    if (!arena_init(&scratch, (num_nodes + solution_size) * sizeof(int) + 2 * ARENA_ALIGNMENT) ||
+        !result_init(&res, solution_size))
+    {
+        fprintf(stderr, "Error: Memory allocation failed in RandomSearch\n");
+        arena_destroy(&scratch);
+        return result_failed();
+    }
+
     // Initialize array of all nodes
-    int *all_nodes = (int *)malloc(num_nodes * sizeof(int));
-    if (!all_nodes)
+    int *all_nodes = (int *)arena_alloc(&scratch, num_nodes * sizeof(int));
+    int *current_solution = (int *)arena_alloc(&scratch, solution_size * sizeof(int));
+    if (!all_nodes || !current_solution)
     {
-        fprintf(stderr, "Error: Memory allocation failed for all_nodes in RandomSearch\n");
-        Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-        return res;
+        fprintf(stderr, "Error: Memory allocation failed in RandomSearch\n");
+        arena_destroy(&scratch);
+        free_Result(res);
+        return result_failed();
     }
     for (int i = 0; i < num_nodes; i++)
     {
         all_nodes[i] = i;
     }
 
-    // Initialize best and worst
-    int bestCost = INT_MAX;
-    int worstCost = INT_MIN;
     long long totalCost = 0;
 
-    int *bestSolution = NULL;
-    int bestSolutionSize = 0;
-    int *worstSolution = NULL;
-    int worstSolutionSize = 0;
-
-    // Allocate memory for current_solution
-    int *current_solution = (int *)malloc(solution_size * sizeof(int));
-    if (!current_solution)
-    {
-        fprintf(stderr, "Error: Memory allocation failed for current_solution in RandomSearch\n");
-        free(all_nodes);
-        Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-        return res;
-    }
-
     for (int i = 0; i < num_solutions; i++)
     {
         // Shuffle all_nodes
-        shuffle_array(all_nodes, num_nodes);
+        rng_shuffle(rng, all_nodes, num_nodes);
         // Take first solution_size elements
         memcpy(current_solution, all_nodes, solution_size * sizeof(int));
 
@@ -80,58 +79,249 @@ static Result RandomSearch_solve(Algo *algo, const int **distances, int num_node
         int current_cost = calculate_cost(current_solution, solution_size, distances, costs);
         totalCost += current_cost;
 
-        // Update best
-        if (current_cost < bestCost)
+        result_record(&res, current_solution, solution_size, current_cost);
+    }
+
+    arena_destroy(&scratch);
+    result_finish(&res, totalCost, num_solutions);
+
+    return res;
+}
+
+// ------------------ All-starts sweep ------------------
+
+// Builds one solution from start_node into solution, which has room for solution_size + 1 nodes.
+// Returns its size, 0 if no solution exists for this start node, or -1 if scratch ran out.
+// Every buffer of the construction comes from scratch, which the sweep resets before each one.
+typedef int (*StartConstructor)(const Algo *algo, int start_node, const int **distances, int num_nodes, const int *costs,
+                                int solution_size, int *solution, Rng *rng, Arena *scratch);
+
+// Settings shared by the workers of one sweep
+typedef struct
+{
+    StartConstructor construct;
+    const Algo *algo;
+    const int **distances;
+    const int *costs;
+    int num_nodes;
+    int num_solutions;  // Constructions per start node
+    int solution_size;
+    uint64_t seed;      // Start node k draws from a stream seeded with seed + k
+    size_t scratch_size;
+    atomic_int next_start; // Next start node to hand out
+} StartSweep;
+
+// Per-thread state of a sweep; scratch and result buffers are allocated before the workers start
+typedef struct
+{
+    StartSweep *sweep;
+    Arena scratch;
+    Result res;
+    int best_start;  // Start node of res.bestSolution
+    int worst_start; // Start node of res.worstSolution
+    long long totalCost;
+    int failed;
+} StartWorker;
+
+static void *start_worker_run(void *arg)
+{
+    StartWorker *worker = (StartWorker *)arg;
+    StartSweep *sweep = worker->sweep;
+    int start_node;
+    while ((start_node = atomic_fetch_add_explicit(&sweep->next_start, 1, memory_order_relaxed)) < sweep->num_nodes)
+    {
+        // The stream depends on the start node only, so results do not depend on the schedule
+        Rng rng;
+        rng_seed(&rng, sweep->seed + (uint64_t)start_node);
+
+        // Generate num_solutions starting from this node
+        for (int s = 0; s < sweep->num_solutions; s++)
         {
-            bestCost = current_cost;
-            if (bestSolution)
-                free(bestSolution);
-            bestSolution = (int *)malloc(solution_size * sizeof(int));
-            if (bestSolution)
+            arena_reset(&worker->scratch);
+            int *current_solution = (int *)arena_alloc(&worker->scratch, (sweep->solution_size + 1) * sizeof(int));
+            int count = current_solution ? sweep->construct(sweep->algo, start_node, sweep->distances, sweep->num_nodes, sweep->costs,
+                                                            sweep->solution_size, current_solution, &rng, &worker->scratch)
+                                         : -1;
+            if (count < 0)
+            {
+                worker->failed = 1;
+                return NULL;
+            }
+            if (count == 0)
             {
-                memcpy(bestSolution, current_solution, solution_size * sizeof(int));
-                bestSolutionSize = solution_size;
+                continue;
             }
+
+            // Check if valid solution
+            if (!is_valid_solution(current_solution, count, sweep->num_nodes))
+            {
+                fprintf(stderr, "Error: The generated solution is not valid\n");
+            }
+
+            int current_cost = calculate_cost(current_solution, count, sweep->distances, sweep->costs);
+            worker->totalCost += current_cost;
+
+            // Start nodes of a worker increase, so a tie keeps the earlier start node
+            if (current_cost < worker->res.bestCost)
+            {
+                worker->best_start = start_node;
+            }
+            if (current_cost > worker->res.worstCost)
+            {
+                worker->worst_start = start_node;
+            }
+            result_record(&worker->res, current_solution, count, current_cost);
         }
+    }
+    return NULL;
+}
 
-        // Update worst
-        if (current_cost > worstCost)
+// Runs construct num_solutions times from every start node, spreading the start nodes over all
+// processors. Every construction selects solution_size nodes, (num_nodes + 1) / 2 if it is 0. Ties between workers go to the earlier start node, so the Result only depends on
+// the rng state, not on the thread count or the schedule.
+static Result solve_all_starts(const Algo *algo, StartConstructor construct, const char *caller, const int **distances, int num_nodes,
+                               const int *costs, int num_solutions, int solution_size, Rng *rng, size_t scratch_size)
+{
+    if (solution_size == 0)
+    {
+        solution_size = (num_nodes + 1) / 2;
+    }
+    if (solution_size < 1 || solution_size > num_nodes)
+    {
+        fprintf(stderr, "Error: %s cannot select %d of %d nodes\n", caller, solution_size, num_nodes);
+        return result_failed();
+    }
+    int total_iterations = num_nodes * num_solutions;
+
+    StartSweep sweep;
+    sweep.construct = construct;
+    sweep.algo = algo;
+    sweep.distances = distances;
+    sweep.costs = costs;
+    sweep.num_nodes = num_nodes;
+    sweep.num_solutions = num_solutions;
+    sweep.solution_size = solution_size;
+    sweep.seed = rng_next(rng);
+    sweep.scratch_size = (solution_size + 1) * sizeof(int) + scratch_size + ARENA_ALIGNMENT;
+    atomic_init(&sweep.next_start, 0);
+
+    int num_threads = available_threads();
+    if (num_threads > num_nodes)
+        num_threads = num_nodes > 0 ? num_nodes : 1;
+
+    StartWorker *workers = (StartWorker *)calloc(num_threads, sizeof(StartWorker));
+    pthread_t *threads = (pthread_t *)malloc(num_threads * sizeof(pthread_t));
+    char *started = (char *)calloc(num_threads, sizeof(char));
+    if (!workers || !threads || !started)
+    {
+        fprintf(stderr, "Error: Memory allocation failed in %s\n", caller);
+        free(workers);
+        free(threads);
+        free(started);
+        return result_failed();
+    }
+
+    // Preallocate all per-thread buffers before any thread starts; a failed init leaves
+    // the arena and the Result releasable
+    int alloc_failed = 0;
+    for (int t = 0; t < num_threads; t++)
+    {
+        StartWorker *worker = &workers[t];
+        worker->sweep = &sweep;
+        worker->res = result_failed();
+        worker->best_start = -1;
+        worker->worst_start = -1;
+        if (!arena_init(&worker->scratch, sweep.scratch_size))
+        {
+            alloc_failed = 1;
+        }
+        if (!result_init(&worker->res, solution_size + 1))
         {
-            worstCost = current_cost;
-            if (worstSolution)
-                free(worstSolution);
-            worstSolution = (int *)malloc(solution_size * sizeof(int));
-            if (worstSolution)
+            alloc_failed = 1;
+        }
+    }
+
+    if (!alloc_failed)
+    {
+        for (int t = 0; t < num_threads; t++)
+        {
+            if (pthread_create(&threads[t], NULL, start_worker_run, &workers[t]) == 0)
             {
-                memcpy(worstSolution, current_solution, solution_size * sizeof(int));
-                worstSolutionSize = solution_size;
+                started[t] = 1;
             }
+            else
+            {
+                // Could not spawn a thread: run its share on the calling thread
+                start_worker_run(&workers[t]);
+            }
+        }
+        for (int t = 0; t < num_threads; t++)
+        {
+            if (started[t])
+                pthread_join(threads[t], NULL);
         }
     }
 
-    // Calculate average cost
-    double averageCost = (num_solutions > 0) ? ((double)totalCost / num_solutions) : 0.0;
+    // Reduce per-thread results in thread order, breaking cost ties by start node
+    Result res = result_failed();
+    long long totalCost = 0;
+    int best_start = -1;
+    int worst_start = -1;
+    StartWorker *best_worker = NULL;
+    StartWorker *worst_worker = NULL;
+    for (int t = 0; t < num_threads; t++)
+    {
+        StartWorker *worker = &workers[t];
+        alloc_failed |= worker->failed;
+        totalCost += worker->totalCost;
+        if (worker->best_start >= 0 &&
+            (worker->res.bestCost < res.bestCost || (worker->res.bestCost == res.bestCost && worker->best_start < best_start)))
+        {
+            res.bestCost = worker->res.bestCost;
+            best_start = worker->best_start;
+            best_worker = worker;
+        }
+        if (worker->worst_start >= 0 &&
+            (worker->res.worstCost > res.worstCost || (worker->res.worstCost == res.worstCost && worker->worst_start < worst_start)))
+        {
+            res.worstCost = worker->res.worstCost;
+            worst_start = worker->worst_start;
+            worst_worker = worker;
+        }
+    }
 
-    // Free allocated memory
-    free(all_nodes);
-    free(current_solution);
+    // Hand the winning buffers over to the Result instead of copying them
+    if (!alloc_failed && best_worker && worst_worker)
+    {
+        res.bestSolution = best_worker->res.bestSolution;
+        res.bestSolutionSize = best_worker->res.bestSolutionSize;
+        best_worker->res.bestSolution = NULL;
+        res.worstSolution = worst_worker->res.worstSolution;
+        res.worstSolutionSize = worst_worker->res.worstSolutionSize;
+        worst_worker->res.worstSolution = NULL;
+    }
 
-    // Prepare Result
-    Result res;
-    res.bestCost = bestCost;
-    res.worstCost = worstCost;
-    res.averageCost = averageCost;
-    res.bestSolution = bestSolution;
-    res.bestSolutionSize = bestSolutionSize;
-    res.worstSolution = worstSolution;
-    res.worstSolutionSize = worstSolutionSize;
+    for (int t = 0; t < num_threads; t++)
+    {
+        arena_destroy(&workers[t].scratch);
+        free_Result(workers[t].res);
+    }
+    free(workers);
+    free(threads);
+    free(started);
 
+    if (alloc_failed)
+    {
+        fprintf(stderr, "Error: Memory allocation failed in %s\n", caller);
+        return result_failed();
+    }
+    result_finish(&res, totalCost, total_iterations);
     return res;
 }
 
 // ------------------ NearestNeighboursEndInsert Algorithm ------------------
 
-NearestNeighboursEndInsert *create_NearestNeighboursEndInsert()
+NearestNeighboursEndInsert *create_NearestNeighboursEndInsert(const SpatialGrid *grid)
 {
     NearestNeighboursEndInsert *nn = (NearestNeighboursEndInsert *)malloc(sizeof(NearestNeighboursEndInsert));
     if (!nn)
@@ -141,150 +331,104 @@ NearestNeighboursEndInsert *create_NearestNeighboursEndInsert()
     }
     nn->base.name = "NearestNeighboursEndInsert";
     nn->base.solve = NearestNeighboursEndInsert_solve;
+    nn->grid = grid;
+    nn->solution_size = 0;
     return nn;
 }
 
-static Result NearestNeighboursEndInsert_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions)
+static int NearestNeighboursEndInsert_construct(const Algo *algo, int start_node, const int **distances, int num_nodes, const int *costs,
+                                                int solution_size, int *current_solution, Rng *rng, Arena *scratch)
 {
-    int solution_size = (num_nodes + 1) / 2;
-
-    int total_iterations = num_nodes * num_solutions;
-
-    int bestCost = INT_MAX;
-    int worstCost = INT_MIN;
-    long long totalCost = 0;
-
-    int *bestSolution = NULL;
-    int bestSolutionSize = 0;
-    int *worstSolution = NULL;
-    int worstSolutionSize = 0;
-
-    // For each node as starting point
-    for (int start_node = 0; start_node < num_nodes; start_node++)
+    (void)costs;
+    const SpatialGrid *grid = ((const NearestNeighboursEndInsert *)algo)->grid;
+    SpatialView view;
+    char *visited = (char *)arena_calloc(scratch, num_nodes, sizeof(char));
+    int *nearest_nodes = (int *)arena_alloc(scratch, num_nodes * sizeof(int));
+    if (!visited || !nearest_nodes || (grid && !spatial_view_init(&view, grid, scratch)))
     {
-        // Generate num_solutions starting from this node
-        for (int s = 0; s < num_solutions; s++)
-        {
-            // Initialize current solution
-            int *current_solution = (int *)malloc(solution_size * sizeof(int));
-            if (!current_solution)
-            {
-                fprintf(stderr, "Error: Memory allocation failed in NearestNeighboursEndInsert_solve\n");
-                Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-                return res;
-            }
+        return -1;
+    }
 
-            char *visited = (char *)calloc(num_nodes, sizeof(char));
-            if (!visited)
-            {
-                fprintf(stderr, "Error: Memory allocation failed in NearestNeighboursEndInsert_solve\n");
-                free(current_solution);
-                Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-                return res;
-            }
+    int count = 0;
+    current_solution[count++] = start_node;
+    visited[start_node] = 1;
+    if (grid)
+    {
+        spatial_view_remove(&view, start_node);
+    }
 
-            int count = 0;
-            current_solution[count++] = start_node;
-            visited[start_node] = 1;
+    while (count < solution_size)
+    {
+        int last_node = current_solution[count - 1];
+        int num_nearest = 0;
+        int min_distance = INT_MAX;
 
-            while (count < solution_size)
+        // The grid finds the same nearest nodes, in the same order, as the linear scan
+        if (grid)
+        {
+            num_nearest = spatial_view_nearest(&view, distances, NULL, last_node, nearest_nodes);
+        }
+        else
+        {
+            for (int j = 0; j < num_nodes; j++)
             {
-                int last_node = current_solution[count - 1];
-                int nearest_nodes[num_nodes];
-                int num_nearest = 0;
-                int min_distance = INT_MAX;
-
-                for (int j = 0; j < num_nodes; j++)
+                if (!visited[j])
                 {
-                    if (!visited[j])
+                    int distance = distances[last_node][j];
+                    if (distance < min_distance)
                     {
-                        int distance = distances[last_node][j];
-                        if (distance < min_distance)
-                        {
-                            min_distance = distance;
-                            num_nearest = 0;
-                            nearest_nodes[num_nearest++] = j;
-                        }
-                        else if (distance == min_distance)
-                        {
-                            nearest_nodes[num_nearest++] = j;
-                        }
+                        min_distance = distance;
+                        num_nearest = 0;
+                        nearest_nodes[num_nearest++] = j;
+                    }
+                    else if (distance == min_distance)
+                    {
+                        nearest_nodes[num_nearest++] = j;
                     }
                 }
-
-                if (num_nearest == 0)
-                {
-                    break;
-                }
-
-                // Randomly select one of the nearest nodes
-                int rand_index = rand() % num_nearest;
-                int nearest_node = nearest_nodes[rand_index];
-
-                current_solution[count++] = nearest_node;
-                visited[nearest_node] = 1;
-            }
-
-            // Check if valid solution
-            if (!is_valid_solution(current_solution, count, num_nodes))
-            {
-                fprintf(stderr, "Error: The generated solution is not valid\n");
             }
+        }
 
-            // Calculate cost
-            int current_cost = calculate_cost(current_solution, count, distances, costs);
-            totalCost += current_cost;
-
-            // Update best
-            if (current_cost < bestCost)
-            {
-                bestCost = current_cost;
-                if (bestSolution)
-                    free(bestSolution);
-                bestSolution = (int *)malloc(count * sizeof(int));
-                if (bestSolution)
-                {
-                    memcpy(bestSolution, current_solution, count * sizeof(int));
-                    bestSolutionSize = count;
-                }
-            }
+        if (num_nearest == 0)
+        {
+            break;
+        }
 
-            // Update worst
-            if (current_cost > worstCost)
-            {
-                worstCost = current_cost;
-                if (worstSolution)
-                    free(worstSolution);
-                worstSolution = (int *)malloc(count * sizeof(int));
-                if (worstSolution)
-                {
-                    memcpy(worstSolution, current_solution, count * sizeof(int));
-                    worstSolutionSize = count;
-                }
-            }
+        // Randomly select one of the nearest nodes
+        int rand_index = (int)rng_bounded(rng, (uint32_t)num_nearest);
+        int nearest_node = nearest_nodes[rand_index];
 
-            free(visited);
-            free(current_solution);
+        current_solution[count++] = nearest_node;
+        visited[nearest_node] = 1;
+        if (grid)
+        {
+            spatial_view_remove(&view, nearest_node);
         }
     }
 
-    double averageCost = (total_iterations > 0) ? ((double)totalCost / total_iterations) : 0.0;
-
-    Result res;
-    res.bestCost = bestCost;
-    res.worstCost = worstCost;
-    res.averageCost = averageCost;
-    res.bestSolution = bestSolution;
-    res.bestSolutionSize = bestSolutionSize;
-    res.worstSolution = worstSolution;
-    res.worstSolutionSize = worstSolutionSize;
+    return count;
+}
 
-    return res;
+static Result NearestNeighboursEndInsert_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng)
+{
+    const SpatialGrid *grid = ((NearestNeighboursEndInsert *)algo)->grid;
+    if (grid && grid->num_nodes != num_nodes)
+    {
+        fprintf(stderr, "Error: The spatial grid of NearestNeighboursEndInsert has %d nodes, the instance %d\n", grid->num_nodes, num_nodes);
+        return result_failed();
+    }
+    size_t scratch_size = num_nodes * (sizeof(char) + sizeof(int)) + 2 * ARENA_ALIGNMENT;
+    if (grid)
+    {
+        scratch_size += spatial_view_scratch_size(grid);
+    }
+    return solve_all_starts(algo, NearestNeighboursEndInsert_construct, "NearestNeighboursEndInsert_solve", distances, num_nodes, costs,
+                            num_solutions, ((NearestNeighboursEndInsert *)algo)->solution_size, rng, scratch_size);
 }
 
 // ------------------ NearestNeighboursAnywhereInsert Algorithm ------------------
 
-NearestNeighboursAnywhereInsert *create_NearestNeighboursAnywhereInsert()
+NearestNeighboursAnywhereInsert *create_NearestNeighboursAnywhereInsert(const SpatialGrid *grid)
 {
     NearestNeighboursAnywhereInsert *nn = (NearestNeighboursAnywhereInsert *)malloc(sizeof(NearestNeighboursAnywhereInsert));
     if (!nn)
@@ -294,159 +438,213 @@ NearestNeighboursAnywhereInsert *create_NearestNeighboursAnywhereInsert()
     }
     nn->base.name = "NearestNeighboursAnywhereInsert";
     nn->base.solve = NearestNeighboursAnywhereInsert_solve;
+    nn->grid = grid;
+    nn->solution_size = 0;
     return nn;
 }
 
-static Result NearestNeighboursAnywhereInsert_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions)
+// Tied (node, position) pairs kept per step; further ties are ignored
+#define ANYWHERE_MAX_TIES(num_nodes) (2 * (num_nodes))
+
+// Cheapest insertion of node into the cycle; *position receives the first position attaining it
+static int cheapest_insertion(const int **distances, const int *costs, const int *current_solution, int count, int node, int *position)
 {
-    int solution_size = (num_nodes + 1) / 2;
+    int best = INT_MAX;
+    for (int pos = 0; pos <= count; pos++)
+    {
+        int prev_node = (pos == 0) ? current_solution[count - 1] : current_solution[pos - 1];
+        int next_node = (pos == count) ? current_solution[0] : current_solution[pos];
+        int increase = distances[prev_node][node] + distances[node][next_node] - distances[prev_node][next_node] + costs[node];
+        if (increase < best)
+        {
+            best = increase;
+            *position = pos;
+        }
+    }
+    return best;
+}
 
-    int total_iterations = num_nodes * num_solutions;
+static int NearestNeighboursAnywhereInsert_construct(const Algo *algo, int start_node, const int **distances, int num_nodes, const int *costs,
+                                                     int solution_size, int *current_solution, Rng *rng, Arena *scratch)
+{
+    const SpatialGrid *grid = ((const NearestNeighboursAnywhereInsert *)algo)->grid;
+    int max_ties = ANYWHERE_MAX_TIES(num_nodes);
+    char *visited = (char *)arena_calloc(scratch, num_nodes, sizeof(char));
+    int *best_nodes = (int *)arena_alloc(scratch, max_ties * sizeof(int));
+    int *best_positions = (int *)arena_alloc(scratch, max_ties * sizeof(int));
+    if (!visited || !best_nodes || !best_positions)
+    {
+        return -1;
+    }
 
-    int bestCost = INT_MAX;
-    int worstCost = INT_MIN;
-    long long totalCost = 0;
+    // With the grid: distance of every node to its nearest node in the cycle, and the nodes
+    // the grid returns as nearest to the last inserted one
+    SpatialView view;
+    int *gap = NULL;
+    int *nearest_nodes = NULL;
+    if (grid)
+    {
+        gap = (int *)arena_alloc(scratch, num_nodes * sizeof(int));
+        nearest_nodes = (int *)arena_alloc(scratch, num_nodes * sizeof(int));
+        if (!gap || !nearest_nodes || !spatial_view_init(&view, grid, scratch))
+        {
+            return -1;
+        }
+        spatial_view_remove(&view, start_node);
+        for (int j = 0; j < num_nodes; j++)
+        {
+            int to = distances[start_node][j];
+            int from = distances[j][start_node];
+            gap[j] = to < from ? to : from;
+        }
+    }
 
-    int *bestSolution = NULL;
-    int bestSolutionSize = 0;
-    int *worstSolution = NULL;
-    int worstSolutionSize = 0;
+    int count = 0;
+    current_solution[count++] = start_node;
+    visited[start_node] = 1;
+    int last_node = start_node;
 
-    // For each node as starting point
-    for (int start_node = 0; start_node < num_nodes; start_node++)
+    while (count < solution_size)
     {
-        // Generate num_solutions starting from this node
-        for (int s = 0; s < num_solutions; s++)
+        int num_best = 0;
+        int min_increase = INT_MAX;
+
+        // Inserting j between prev and next adds at least 2 * gap[j] - distances[prev][next] + costs[j],
+        // as both of its edges reach the cycle, so nodes whose bound exceeds an insertion already
+        // known can neither beat nor tie the best one. The grid's nearest node to the last inserted
+        // one by distance plus cost gives that insertion.
+        int longest_edge = 0;
+        int limit = INT_MAX;
+        if (grid)
         {
-            // Initialize current solution
-            int *current_solution = (int *)malloc(solution_size * sizeof(int));
-            if (!current_solution)
+            for (int pos = 0; pos < count; pos++)
             {
-                fprintf(stderr, "Error: Memory allocation failed in NearestNeighboursAnywhereInsert_solve\n");
-                Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-                return res;
+                int next_node = current_solution[pos + 1 == count ? 0 : pos + 1];
+                if (distances[current_solution[pos]][next_node] > longest_edge)
+                    longest_edge = distances[current_solution[pos]][next_node];
             }
-
-            char *visited = (char *)calloc(num_nodes, sizeof(char));
-            if (!visited)
+            if (spatial_view_nearest(&view, distances, costs, last_node, nearest_nodes) > 0)
             {
-                fprintf(stderr, "Error: Memory allocation failed in NearestNeighboursAnywhereInsert_solve\n");
-                free(current_solution);
-                Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-                return res;
+                int position;
+                limit = cheapest_insertion(distances, costs, current_solution, count, nearest_nodes[0], &position);
             }
+        }
 
-            int count = 0;
-            current_solution[count++] = start_node;
-            visited[start_node] = 1;
-
-            while (count < solution_size)
+        for (int j = 0; j < num_nodes; j++)
+        {
+            if (!visited[j])
             {
-                int best_nodes[num_nodes];
-                int best_positions[num_nodes];
-                int num_best = 0;
-                int min_increase = INT_MAX;
-
-                for (int j = 0; j < num_nodes; j++)
+                if (grid && costs[j] + 2 * gap[j] - longest_edge > limit)
                 {
-                    if (!visited[j])
-                    {
-                        for (int pos = 0; pos <= count; pos++)
-                        {
-                            int prev_node = (pos == 0) ? current_solution[count - 1] : current_solution[pos - 1];
-                            int next_node = (pos == count) ? current_solution[0] : current_solution[pos];
-                            int increase = distances[prev_node][j] + distances[j][next_node] - distances[prev_node][next_node] + costs[j];
-
-                            if (increase < min_increase)
-                            {
-                                min_increase = increase;
-                                num_best = 0;
-                                best_nodes[num_best] = j;
-                                best_positions[num_best++] = pos;
-                            }
-                            else if (increase == min_increase)
-                            {
-                                best_nodes[num_best] = j;
-                                best_positions[num_best++] = pos;
-                            }
-                        }
-                    }
+                    continue;
                 }
-
-                if (num_best == 0)
+                for (int pos = 0; pos <= count; pos++)
                 {
-                    break;
-                }
-
-                // Randomly select one of the best nodes and positions
-                int rand_index = rand() % num_best;
-                int best_node = best_nodes[rand_index];
-                int best_position = best_positions[rand_index];
+                    int prev_node = (pos == 0) ? current_solution[count - 1] : current_solution[pos - 1];
+                    int next_node = (pos == count) ? current_solution[0] : current_solution[pos];
+                    int increase = distances[prev_node][j] + distances[j][next_node] - distances[prev_node][next_node] + costs[j];
 
-                // Insert best_node at best_position
-                for (int m = count; m > best_position; m--)
-                {
-                    current_solution[m] = current_solution[m - 1];
+                    if (increase < min_increase)
+                    {
+                        min_increase = increase;
+                        num_best = 0;
+                        best_nodes[num_best] = j;
+                        best_positions[num_best++] = pos;
+                    }
+                    else if (increase == min_increase && num_best < max_ties)
+                    {
+                        best_nodes[num_best] = j;
+                        best_positions[num_best++] = pos;
+                    }
                 }
-                current_solution[best_position] = best_node;
-                count++;
-                visited[best_node] = 1;
             }
+        }
 
-            // Check if valid solution
-            if (!is_valid_solution(current_solution, count, num_nodes))
+        if (num_best == 0)
+        {
+            break;
+        }
+
+        // Randomly select one of the best nodes and positions
+        int rand_index = (int)rng_bounded(rng, (uint32_t)num_best);
+        int best_node = best_nodes[rand_index];
+        int best_position = best_positions[rand_index];
+
+        // Insert best_node at best_position
+        for (int m = count; m > best_position; m--)
+        {
+            current_solution[m] = current_solution[m - 1];
+        }
+        current_solution[best_position] = best_node;
+        count++;
+        visited[best_node] = 1;
+        last_node = best_node;
+        if (grid)
+        {
+            spatial_view_remove(&view, best_node);
+            for (int j = 0; j < num_nodes; j++)
             {
-                fprintf(stderr, "Error: The generated solution is not valid\n");
+                int to = distances[best_node][j];
+                int from = distances[j][best_node];
+                int distance = to < from ? to : from;
+                if (distance < gap[j])
+                    gap[j] = distance;
             }
+        }
+    }
 
-            int current_cost = calculate_cost(current_solution, count, distances, costs);
-            totalCost += current_cost;
+    return count;
+}
 
-            // Update best
-            if (current_cost < bestCost)
+static Result NearestNeighboursAnywhereInsert_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng)
+{
+    const SpatialGrid *grid = ((NearestNeighboursAnywhereInsert *)algo)->grid;
+    if (grid && grid->num_nodes != num_nodes)
+    {
+        fprintf(stderr, "Error: The spatial grid of NearestNeighboursAnywhereInsert has %d nodes, the instance %d\n", grid->num_nodes, num_nodes);
+        return result_failed();
+    }
+    size_t scratch_size = num_nodes * sizeof(char) + 2 * ANYWHERE_MAX_TIES(num_nodes) * sizeof(int) + 3 * ARENA_ALIGNMENT;
+    if (grid)
+    {
+        scratch_size += 2 * num_nodes * sizeof(int) + 2 * ARENA_ALIGNMENT + spatial_view_scratch_size(grid);
+    }
+    return solve_all_starts(algo, NearestNeighboursAnywhereInsert_construct, "NearestNeighboursAnywhereInsert_solve", distances, num_nodes, costs,
+                            num_solutions, ((NearestNeighboursAnywhereInsert *)algo)->solution_size, rng, scratch_size);
+}
+
+// Picks the node farthest from start_node (ties broken randomly) to close the first cycle;
+// returns -1 if there is no other node
+static int random_farthest_node(int start_node, const int **distances, int num_nodes, int *farthest_nodes, Rng *rng)
+{
+    int max_distance = -1;
+    int num_farthest = 0;
+    for (int j = 0; j < num_nodes; j++)
+    {
+        if (j != start_node)
+        {
+            int distance = distances[start_node][j];
+            if (distance > max_distance)
             {
-                bestCost = current_cost;
-                if (bestSolution)
-                    free(bestSolution);
-                bestSolution = (int *)malloc(count * sizeof(int));
-                if (bestSolution)
-                {
-                    memcpy(bestSolution, current_solution, count * sizeof(int));
-                    bestSolutionSize = count;
-                }
+                max_distance = distance;
+                num_farthest = 0;
+                farthest_nodes[num_farthest++] = j;
             }
-
-            // Update worst
-            if (current_cost > worstCost)
+            else if (distance == max_distance)
             {
-                worstCost = current_cost;
-                if (worstSolution)
-                    free(worstSolution);
-                worstSolution = (int *)malloc(count * sizeof(int));
-                if (worstSolution)
-                {
-                    memcpy(worstSolution, current_solution, count * sizeof(int));
-                    worstSolutionSize = count;
-                }
+                farthest_nodes[num_farthest++] = j;
             }
-
-            free(visited);
-            free(current_solution);
         }
     }
 
-    double averageCost = (total_iterations > 0) ? ((double)totalCost / total_iterations) : 0.0;
-
-    Result res;
-    res.bestCost = bestCost;
-    res.worstCost = worstCost;
-    res.averageCost = averageCost;
-    res.bestSolution = bestSolution;
-    res.bestSolutionSize = bestSolutionSize;
-    res.worstSolution = worstSolution;
-    res.worstSolutionSize = worstSolutionSize;
+    if (num_farthest == 0)
+    {
+        return -1;
+    }
 
-    return res;
+    // Randomly select one of the farthest nodes
+    int rand_index = (int)rng_bounded(rng, (uint32_t)num_farthest);
+    return farthest_nodes[rand_index];
 }
 
 // ------------------ GreedyCycle Algorithm ------------------
@@ -464,193 +662,139 @@ GreedyCycle *create_GreedyCycle()
     return gc;
 }
 
-static Result GreedyCycle_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions)
+static int GreedyCycle_construct(const Algo *algo, int start_node, const int **distances, int num_nodes, const int *costs,
+                                 int solution_size, int *current_solution, Rng *rng, Arena *scratch)
 {
-    int solution_size = (num_nodes + 1) / 2;
-
-    int total_iterations = num_nodes * num_solutions;
-
-    int bestCost = INT_MAX;
-    int worstCost = INT_MIN;
-    long long totalCost = 0;
-
-    int *bestSolution = NULL;
-    int bestSolutionSize = 0;
-    int *worstSolution = NULL;
-    int worstSolutionSize = 0;
+    (void)algo;
+    // Candidate list of every step, also used for the farthest nodes
+    int *best_nodes = (int *)arena_alloc(scratch, num_nodes * sizeof(int));
+    if (!best_nodes)
+    {
+        return -1;
+    }
 
-    // For each node as starting point
-    for (int start_node = 0; start_node < num_nodes; start_node++)
+    // Find the farthest node to start forming a cycle
+    int farthest_node = random_farthest_node(start_node, distances, num_nodes, best_nodes, rng);
+    if (farthest_node < 0)
     {
-        // Generate num_solutions starting from this node
-        for (int s = 0; s < num_solutions; s++)
-        {
-            // Initialize current solution
-            int *current_solution = (int *)malloc(solution_size * sizeof(int));
-            if (!current_solution)
-            {
-                fprintf(stderr, "Error: Memory allocation failed in GreedyCycle_solve\n");
-                Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-                return res;
-            }
+        return 0;
+    }
 
-            char *visited = (char *)calloc(num_nodes, sizeof(char));
-            if (!visited)
-            {
-                fprintf(stderr, "Error: Memory allocation failed in GreedyCycle_solve\n");
-                free(current_solution);
-                Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-                return res;
-            }
+    InsertionCache cycle;
+    if (!insertion_init(&cycle, distances, costs, num_nodes, start_node, farthest_node, scratch))
+    {
+        return -1;
+    }
 
-            int count = 0;
-            current_solution[count++] = start_node;
-            visited[start_node] = 1;
+    while (cycle.size < solution_size)
+    {
+        int num_best = 0;
+        int min_increase = INT_MAX;
 
-            // Find the farthest node to start forming a cycle
-            int farthest_nodes[num_nodes];
-            int num_farthest = 0;
-            int max_distance = -1;
-            for (int j = 0; j < num_nodes; j++)
+        for (int j = 0; j < num_nodes; j++)
+        {
+            if (!cycle.in_cycle[j])
             {
-                if (!visited[j])
+                int increase = cycle.best_cost[j];
+                if (increase < min_increase)
                 {
-                    int distance = distances[start_node][j];
-                    if (distance > max_distance)
-                    {
-                        max_distance = distance;
-                        num_farthest = 0;
-                        farthest_nodes[num_farthest++] = j;
-                    }
-                    else if (distance == max_distance)
-                    {
-                        farthest_nodes[num_farthest++] = j;
-                    }
+                    min_increase = increase;
+                    num_best = 0;
+                    best_nodes[num_best++] = j;
+                }
+                else if (increase == min_increase)
+                {
+                    best_nodes[num_best++] = j;
                 }
             }
+        }
 
-            if (num_farthest == 0)
-            {
-                free(visited);
-                free(current_solution);
-                continue;
-            }
+        if (num_best == 0)
+        {
+            break;
+        }
 
-            // Randomly select one of the farthest nodes
-            int rand_index = rand() % num_farthest;
-            int farthest_node = farthest_nodes[rand_index];
+        // Randomly select one of the best nodes and insert it into its cheapest edge
+        int rand_index = (int)rng_bounded(rng, (uint32_t)num_best);
+        insertion_insert(&cycle, best_nodes[rand_index]);
+    }
 
-            current_solution[count++] = farthest_node;
-            visited[farthest_node] = 1;
+    insertion_write_cycle(&cycle, start_node, current_solution);
+    return cycle.size;
+}
 
-            while (count < solution_size)
-            {
-                int best_nodes[num_nodes];
-                int best_positions[num_nodes];
-                int num_best = 0;
-                int min_increase = INT_MAX;
+static Result GreedyCycle_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng)
+{
+    return solve_all_starts(algo, GreedyCycle_construct, "GreedyCycle_solve", distances, num_nodes, costs,
+                            num_solutions, 0, rng, num_nodes * sizeof(int) + insertion_scratch_size(num_nodes) + ARENA_ALIGNMENT);
+}
 
-                for (int j = 0; j < num_nodes; j++)
-                {
-                    if (!visited[j])
-                    {
-                        for (int pos = 0; pos < count; pos++)
-                        {
-                            int next_pos = (pos + 1) % count;
-                            int prev_node = current_solution[pos];
-                            int next_node = current_solution[next_pos];
-                            int increase = distances[prev_node][j] + distances[j][next_node] - distances[prev_node][next_node] + costs[j];
-
-                            if (increase < min_increase)
-                            {
-                                min_increase = increase;
-                                num_best = 0;
-                                best_nodes[num_best] = j;
-                                best_positions[num_best++] = next_pos;
-                            }
-                            else if (increase == min_increase)
-                            {
-                                best_nodes[num_best] = j;
-                                best_positions[num_best++] = next_pos;
-                            }
-                        }
-                    }
-                }
+// Shared by the two regret constructors: score of inserting a node whose two cheapest insertions
+// cost smallest_cost and second_smallest_cost
+typedef double (*RegretScore)(int smallest_cost, int second_smallest_cost);
 
-                if (num_best == 0)
-                {
-                    break;
-                }
+static int regret_construct(RegretScore score_of, int start_node, const int **distances, int num_nodes, const int *costs,
+                            int solution_size, int *current_solution, Rng *rng, Arena *scratch)
+{
+    // Candidate list of every step, also used for the farthest nodes
+    int *candidate_nodes = (int *)arena_alloc(scratch, num_nodes * sizeof(int));
+    if (!candidate_nodes)
+    {
+        return -1;
+    }
 
-                // Randomly select one of the best nodes and positions
-                int rand_index = rand() % num_best;
-                int best_node = best_nodes[rand_index];
-                int best_position = best_positions[rand_index];
+    // Find the farthest node to start forming a cycle
+    int farthest_node = random_farthest_node(start_node, distances, num_nodes, candidate_nodes, rng);
+    if (farthest_node < 0)
+    {
+        return 0;
+    }
 
-                // Insert best_node at best_position
-                for (int m = count; m > best_position; m--)
-                {
-                    current_solution[m] = current_solution[m - 1];
-                }
-                current_solution[best_position] = best_node;
-                count++;
-                visited[best_node] = 1;
-            }
+    InsertionCache cycle;
+    if (!insertion_init(&cycle, distances, costs, num_nodes, start_node, farthest_node, scratch))
+    {
+        return -1;
+    }
 
-            // Check if valid solution
-            if (!is_valid_solution(current_solution, count, num_nodes))
-            {
-                fprintf(stderr, "Error: The generated solution is not valid\n");
-            }
+    // Build the solution
+    while (cycle.size < solution_size)
+    {
+        double max_score = -1e18;
+        int num_candidates = 0;
 
-            int current_cost = calculate_cost(current_solution, count, distances, costs);
-            totalCost += current_cost;
+        // Iterate over all unvisited nodes
+        for (int k = 0; k < num_nodes; k++)
+        {
+            if (cycle.in_cycle[k])
+                continue;
+
+            // Cheapest and second-cheapest insertion of node k, kept up to date by the cycle
+            double score = score_of(cycle.best_cost[k], cycle.second_cost[k]);
 
-            // Update best
-            if (current_cost < bestCost)
+            if (score > max_score)
             {
-                bestCost = current_cost;
-                if (bestSolution)
-                    free(bestSolution);
-                bestSolution = (int *)malloc(count * sizeof(int));
-                if (bestSolution)
-                {
-                    memcpy(bestSolution, current_solution, count * sizeof(int));
-                    bestSolutionSize = count;
-                }
+                max_score = score;
+                num_candidates = 0;
+                candidate_nodes[num_candidates++] = k;
             }
-
-            // Update worst
-            if (current_cost > worstCost)
+            else if (score == max_score)
             {
-                worstCost = current_cost;
-                if (worstSolution)
-                    free(worstSolution);
-                worstSolution = (int *)malloc(count * sizeof(int));
-                if (worstSolution)
-                {
-                    memcpy(worstSolution, current_solution, count * sizeof(int));
-                    worstSolutionSize = count;
-                }
+                candidate_nodes[num_candidates++] = k;
             }
-
-            free(visited);
-            free(current_solution);
         }
-    }
 
-    double averageCost = (total_iterations > 0) ? ((double)totalCost / total_iterations) : 0.0;
+        if (num_candidates == 0)
+        {
+            break;
+        }
 
-    Result res;
-    res.bestCost = bestCost;
-    res.worstCost = worstCost;
-    res.averageCost = averageCost;
-    res.bestSolution = bestSolution;
-    res.bestSolutionSize = bestSolutionSize;
-    res.worstSolution = worstSolution;
-    res.worstSolutionSize = worstSolutionSize;
+        // Randomly select one of the candidates
+        int rand_index = (int)rng_bounded(rng, (uint32_t)num_candidates);
+        insertion_insert(&cycle, candidate_nodes[rand_index]);
+    }
 
-    return res;
+    insertion_write_cycle(&cycle, start_node, current_solution);
+    return cycle.size;
 }
 
 // ------------------ Greedy2Regret Algorithm ------------------
@@ -668,223 +812,24 @@ Greedy2Regret *create_Greedy2Regret()
     return gr;
 }
 
-static Result Greedy2Regret_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions)
+// Pure 2-regret
+static double regret_score(int smallest_cost, int second_smallest_cost)
 {
-    int solution_size = (num_nodes + 1) / 2;
-
-    int total_iterations = num_nodes * num_solutions;
-
-    int bestCost = INT_MAX;
-    int worstCost = INT_MIN;
-    long long totalCost = 0;
-
-    int *bestSolution = NULL;
-    int bestSolutionSize = 0;
-    int *worstSolution = NULL;
-    int worstSolutionSize = 0;
-
-    // For each node as starting point
-    for (int start_node = 0; start_node < num_nodes; start_node++)
-    {
-        // Generate num_solutions starting from this node
-        for (int s = 0; s < num_solutions; s++)
-        {
-            int *current_solution = (int *)malloc((solution_size + 1) * sizeof(int)); // +1 for safe insertion
-            if (!current_solution)
-            {
-                fprintf(stderr, "Error: Memory allocation failed in Greedy2Regret_solve\n");
-                Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-                return res;
-            }
-
-            int current_size = 0;
-            char *visited = (char *)calloc(num_nodes, sizeof(char));
-            if (!visited)
-            {
-                fprintf(stderr, "Error: Memory allocation failed in Greedy2Regret_solve (visited)\n");
-                free(current_solution);
-                Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-                return res;
-            }
-
-            // Start with start_node
-            current_solution[current_size++] = start_node;
-            visited[start_node] = 1;
-
-            // Find the farthest node to start forming a cycle
-            int max_distance = -1;
-            int farthest_nodes[num_nodes];
-            int num_farthest = 0;
-            for (int j = 0; j < num_nodes; j++)
-            {
-                if (!visited[j])
-                {
-                    int distance = distances[start_node][j];
-                    if (distance > max_distance)
-                    {
-                        max_distance = distance;
-                        num_farthest = 0;
-                        farthest_nodes[num_farthest++] = j;
-                    }
-                    else if (distance == max_distance)
-                    {
-                        farthest_nodes[num_farthest++] = j;
-                    }
-                }
-            }
-
-            if (num_farthest == 0)
-            {
-                free(visited);
-                free(current_solution);
-                continue;
-            }
-
-            // Randomly select one of the farthest nodes
-            int rand_index = rand() % num_farthest;
-            int farthest_node = farthest_nodes[rand_index];
-
-            current_solution[current_size++] = farthest_node;
-            visited[farthest_node] = 1;
-
-            // Build the solution
-            while (current_size < solution_size)
-            {
-                int max_regret = INT_MIN;
-                int candidate_nodes[num_nodes];
-                int candidate_positions[num_nodes];
-                int num_candidates = 0;
-
-                // Iterate over all unvisited nodes
-                for (int k = 0; k < num_nodes; k++)
-                {
-                    if (visited[k])
-                        continue;
-
-                    // For node k, compute insertion costs at all possible positions
-                    int smallest_cost = INT_MAX;
-                    int second_smallest_cost = INT_MAX;
-                    int best_pos = -1;
-
-                    for (int j = 0; j < current_size; j++)
-                    {
-                        int prev = current_solution[j];
-                        int next = current_solution[(j + 1) % current_size];
-                        int insertion_cost = distances[prev][k] + distances[k][next] - distances[prev][next] + costs[k];
-
-                        if (insertion_cost < smallest_cost)
-                        {
-                            second_smallest_cost = smallest_cost;
-                            smallest_cost = insertion_cost;
-                            best_pos = (j + 1) % (current_size + 1);
-                        }
-                        else if (insertion_cost < second_smallest_cost)
-                        {
-                            second_smallest_cost = insertion_cost;
-                        }
-                    }
-
-                    // Handle case where only one insertion position is possible
-                    if (second_smallest_cost == INT_MAX)
-                    {
-                        second_smallest_cost = smallest_cost;
-                    }
-
-                    // Compute regret
-                    int regret = second_smallest_cost - smallest_cost;
-
-                    if (regret > max_regret)
-                    {
-                        max_regret = regret;
-                        num_candidates = 0;
-                        candidate_nodes[num_candidates] = k;
-                        candidate_positions[num_candidates++] = best_pos;
-                    }
-                    else if (regret == max_regret)
-                    {
-                        candidate_nodes[num_candidates] = k;
-                        candidate_positions[num_candidates++] = best_pos;
-                    }
-                }
-
-                if (num_candidates == 0)
-                {
-                    break;
-                }
-
-                // Randomly select one of the candidates
-                int rand_index = rand() % num_candidates;
-                int insert_node = candidate_nodes[rand_index];
-                int insert_index = candidate_positions[rand_index];
-
-                // Insert insert_node at insert_index in current_solution
-                for (int m = current_size; m > insert_index; m--)
-                {
-                    current_solution[m] = current_solution[m - 1];
-                }
-                current_solution[insert_index] = insert_node;
-                current_size++;
-                visited[insert_node] = 1;
-            }
-
-            // Check if valid solution
-            if (!is_valid_solution(current_solution, current_size, num_nodes))
-            {
-                fprintf(stderr, "Error: The generated solution is not valid\n");
-            }
-
-            // Calculate cost
-            int current_cost = calculate_cost(current_solution, current_size, distances, costs);
-            totalCost += current_cost;
-
-            // Update best
-            if (current_cost < bestCost)
-            {
-                bestCost = current_cost;
-                if (bestSolution)
-                    free(bestSolution);
-                bestSolution = (int *)malloc(current_size * sizeof(int));
-                if (bestSolution)
-                {
-                    memcpy(bestSolution, current_solution, current_size * sizeof(int));
-                    bestSolutionSize = current_size;
-                }
-            }
-
-            // Update worst
-            if (current_cost > worstCost)
-            {
-                worstCost = current_cost;
-                if (worstSolution)
-                    free(worstSolution);
-                worstSolution = (int *)malloc(current_size * sizeof(int));
-                if (worstSolution)
-                {
-                    memcpy(worstSolution, current_solution, current_size * sizeof(int));
-                    worstSolutionSize = current_size;
-                }
-            }
-
-            free(visited);
-            free(current_solution);
-        }
-    }
-
-    // Calculate average cost
-    double averageCost = (total_iterations > 0) ? ((double)totalCost / total_iterations) : 0.0;
-
-    Result res;
-    res.bestCost = bestCost;
-    res.worstCost = worstCost;
-    res.averageCost = averageCost;
-    res.bestSolution = bestSolution;
-    res.bestSolutionSize = bestSolutionSize;
-    res.worstSolution = worstSolution;
-    res.worstSolutionSize = worstSolutionSize;
+    return second_smallest_cost - smallest_cost;
+}
 
-    return res;
+static int Greedy2Regret_construct(const Algo *algo, int start_node, const int **distances, int num_nodes, const int *costs,
+                                   int solution_size, int *current_solution, Rng *rng, Arena *scratch)
+{
+    (void)algo;
+    return regret_construct(regret_score, start_node, distances, num_nodes, costs, solution_size, current_solution, rng, scratch);
 }
 
+static Result Greedy2Regret_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng)
+{
+    return solve_all_starts(algo, Greedy2Regret_construct, "Greedy2Regret_solve", distances, num_nodes, costs,
+                            num_solutions, 0, rng, num_nodes * sizeof(int) + insertion_scratch_size(num_nodes) + ARENA_ALIGNMENT);
+}
 
 // ------------------ Greedy2RegretWeighted Algorithm ------------------
 
@@ -901,227 +846,25 @@ Greedy2RegretWeighted *create_Greedy2RegretWeighted()
     return grw;
 }
 
-static Result Greedy2RegretWeighted_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions)
+// Regret minus the cost increase
+static double weighted_regret_score(int smallest_cost, int second_smallest_cost)
 {
-    int solution_size = (num_nodes + 1) / 2;
-
-    int total_iterations = num_nodes * num_solutions;
-
-    int bestCost = INT_MAX;
-    int worstCost = INT_MIN;
-    long long totalCost = 0;
-
-    int *bestSolution = NULL;
-    int bestSolutionSize = 0;
-    int *worstSolution = NULL;
-    int worstSolutionSize = 0;
-
     double weight1 = 1.0; // weight for regret
     double weight2 = 1.0; // weight for cost increase
+    return weight1 * (second_smallest_cost - smallest_cost) - weight2 * smallest_cost;
+}
 
-    // For each node as starting point
-    for (int start_node = 0; start_node < num_nodes; start_node++)
-    {
-        // Generate num_solutions starting from this node
-        for (int s = 0; s < num_solutions; s++)
-        {
-            int *current_solution = (int *)malloc((solution_size + 1) * sizeof(int)); // +1 for safe insertion
-            if (!current_solution)
-            {
-                fprintf(stderr, "Error: Memory allocation failed in Greedy2RegretWeighted_solve\n");
-                Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-                return res;
-            }
-
-            int current_size = 0;
-            char *visited = (char *)calloc(num_nodes, sizeof(char));
-            if (!visited)
-            {
-                fprintf(stderr, "Error: Memory allocation failed in Greedy2RegretWeighted_solve (visited)\n");
-                free(current_solution);
-                Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-                return res;
-            }
-
-            // Start with start_node
-            current_solution[current_size++] = start_node;
-            visited[start_node] = 1;
-
-            // Find the farthest node to start forming a cycle
-            int max_distance = -1;
-            int farthest_nodes[num_nodes];
-            int num_farthest = 0;
-            for (int j = 0; j < num_nodes; j++)
-            {
-                if (!visited[j])
-                {
-                    int distance = distances[start_node][j];
-                    if (distance > max_distance)
-                    {
-                        max_distance = distance;
-                        num_farthest = 0;
-                        farthest_nodes[num_farthest++] = j;
-                    }
-                    else if (distance == max_distance)
-                    {
-                        farthest_nodes[num_farthest++] = j;
-                    }
-                }
-            }
-
-            if (num_farthest == 0)
-            {
-                free(visited);
-                free(current_solution);
-                continue;
-            }
-
-            // Randomly select one of the farthest nodes
-            int rand_index = rand() % num_farthest;
-            int farthest_node = farthest_nodes[rand_index];
-
-            current_solution[current_size++] = farthest_node;
-            visited[farthest_node] = 1;
-
-            // Build the solution
-            while (current_size < solution_size)
-            {
-                double max_score = -1e9;
-                int candidate_nodes[num_nodes];
-                int candidate_positions[num_nodes];
-                int num_candidates = 0;
-
-                // Iterate over all unvisited nodes
-                for (int k = 0; k < num_nodes; k++)
-                {
-                    if (visited[k])
-                        continue;
-
-                    // For node k, compute insertion costs at all possible positions
-                    int smallest_cost = INT_MAX;
-                    int second_smallest_cost = INT_MAX;
-                    int best_pos = -1;
-
-                    for (int j = 0; j < current_size; j++)
-                    {
-                        int prev = current_solution[j];
-                        int next = current_solution[(j + 1) % current_size];
-                        int insertion_cost = distances[prev][k] + distances[k][next] - distances[prev][next] + costs[k];
-
-                        if (insertion_cost < smallest_cost)
-                        {
-                            second_smallest_cost = smallest_cost;
-                            smallest_cost = insertion_cost;
-                            best_pos = (j + 1) % (current_size + 1);
-                        }
-                        else if (insertion_cost < second_smallest_cost)
-                        {
-                            second_smallest_cost = insertion_cost;
-                        }
-                    }
-
-                    // Handle case where only one insertion position is possible
-                    if (second_smallest_cost == INT_MAX)
-                    {
-                        second_smallest_cost = smallest_cost;
-                    }
-
-                    // Compute regret
-                    int regret = second_smallest_cost - smallest_cost;
-
-                    // Compute score
-                    double score = weight1 * regret - weight2 * smallest_cost;
-
-                    if (score > max_score)
-                    {
-                        max_score = score;
-                        num_candidates = 0;
-                        candidate_nodes[num_candidates] = k;
-                        candidate_positions[num_candidates++] = best_pos;
-                    }
-                    else if (score == max_score)
-                    {
-                        candidate_nodes[num_candidates] = k;
-                        candidate_positions[num_candidates++] = best_pos;
-                    }
-                }
-
-                if (num_candidates == 0)
-                {
-                    break;
-                }
-
-                // Randomly select one of the candidates
-                int rand_index = rand() % num_candidates;
-                int insert_node = candidate_nodes[rand_index];
-                int insert_index = candidate_positions[rand_index];
-
-                // Insert insert_node at insert_index in current_solution
-                for (int m = current_size; m > insert_index; m--)
-                {
-                    current_solution[m] = current_solution[m - 1];
-                }
-                current_solution[insert_index] = insert_node;
-                current_size++;
-                visited[insert_node] = 1;
-            }
-
-            // Check if valid solution
-            if (!is_valid_solution(current_solution, current_size, num_nodes))
-            {
-                fprintf(stderr, "Error: The generated solution is not valid\n");
-            }
-
-            // Calculate cost
-            int current_cost = calculate_cost(current_solution, current_size, distances, costs);
-            totalCost += current_cost;
-
-            // Update best
-            if (current_cost < bestCost)
-            {
-                bestCost = current_cost;
-                if (bestSolution)
-                    free(bestSolution);
-                bestSolution = (int *)malloc(current_size * sizeof(int));
-                if (bestSolution)
-                {
-                    memcpy(bestSolution, current_solution, current_size * sizeof(int));
-                    bestSolutionSize = current_size;
-                }
-            }
-
-            // Update worst
-            if (current_cost > worstCost)
-            {
-                worstCost = current_cost;
-                if (worstSolution)
-                    free(worstSolution);
-                worstSolution = (int *)malloc(current_size * sizeof(int));
-                if (worstSolution)
-                {
-                    memcpy(worstSolution, current_solution, current_size * sizeof(int));
-                    worstSolutionSize = current_size;
-                }
-            }
-
-            free(visited);
-            free(current_solution);
-        }
-    }
-
-    // Calculate average cost
-    double averageCost = (total_iterations > 0) ? ((double)totalCost / total_iterations) : 0.0;
-
-    Result res;
-    res.bestCost = bestCost;
-    res.worstCost = worstCost;
-    res.averageCost = averageCost;
-    res.bestSolution = bestSolution;
-    res.bestSolutionSize = bestSolutionSize;
-    res.worstSolution = worstSolution;
-    res.worstSolutionSize = worstSolutionSize;
+static int Greedy2RegretWeighted_construct(const Algo *algo, int start_node, const int **distances, int num_nodes, const int *costs,
+                                           int solution_size, int *current_solution, Rng *rng, Arena *scratch)
+{
+    (void)algo;
+    return regret_construct(weighted_regret_score, start_node, distances, num_nodes, costs, solution_size, current_solution, rng, scratch);
+}
 
-    return res;
+static Result Greedy2RegretWeighted_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng)
+{
+    return solve_all_starts(algo, Greedy2RegretWeighted_construct, "Greedy2RegretWeighted_solve", distances, num_nodes, costs,
+                            num_solutions, 0, rng, num_nodes * sizeof(int) + insertion_scratch_size(num_nodes) + ARENA_ALIGNMENT);
 }
 
 // ------------------ Utility Functions ------------------
@@ -1135,6 +878,53 @@ void free_Result(Result res)
         free(res.worstSolution);
 }
 
+Result result_failed(void)
+{
+    Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
+    return res;
+}
+
+int result_init(Result *res, int solution_size)
+{
+    *res = result_failed();
+    res->bestSolution = (int *)malloc(solution_size * sizeof(int));
+    res->worstSolution = (int *)malloc(solution_size * sizeof(int));
+    if (!res->bestSolution || !res->worstSolution)
+    {
+        free_Result(*res);
+        *res = result_failed();
+        return 0;
+    }
+    return 1;
+}
+
+void result_record(Result *res, const int *solution, int solution_size, int cost)
+{
+    if (cost < res->bestCost)
+    {
+        res->bestCost = cost;
+        memcpy(res->bestSolution, solution, solution_size * sizeof(int));
+        res->bestSolutionSize = solution_size;
+    }
+    if (cost > res->worstCost)
+    {
+        res->worstCost = cost;
+        memcpy(res->worstSolution, solution, solution_size * sizeof(int));
+        res->worstSolutionSize = solution_size;
+    }
+}
+
+void result_finish(Result *res, long long total_cost, int num_solutions)
+{
+    res->averageCost = (num_solutions > 0) ? ((double)total_cost / num_solutions) : 0.0;
+    if (res->bestSolutionSize == 0)
+    {
+        free_Result(*res);
+        res->bestSolution = NULL;
+        res->worstSolution = NULL;
+    }
+}
+
 // Function to print the Result with cost breakdown
 void print_Result(const Result res, const int **distances, const int *costs)
 {
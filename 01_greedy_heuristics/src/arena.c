@@ -0,0 +1,106 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct ArenaBlock {
+    ArenaBlock* previous; // Block filled before this one, NULL for the first
+    size_t capacity;
+    size_t used;
+};
+
+// The header is padded so that the data following it keeps malloc's alignment
+#define ARENA_HEADER_SIZE ((sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+static size_t align_up(size_t size)
+{
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+static ArenaBlock* create_block(size_t capacity, ArenaBlock* previous)
+{
+    ArenaBlock* block = (ArenaBlock*)malloc(ARENA_HEADER_SIZE + capacity);
+    if (!block)
+    {
+        return NULL;
+    }
+    block->previous = previous;
+    block->capacity = capacity;
+    block->used = 0;
+    return block;
+}
+
+int arena_init(Arena* arena, size_t capacity)
+{
+    arena->current = create_block(align_up(capacity > 0 ? capacity : ARENA_ALIGNMENT), NULL);
+    return arena->current != NULL;
+}
+
+void arena_destroy(Arena* arena)
+{
+    ArenaBlock* block = arena->current;
+    while (block)
+    {
+        ArenaBlock* previous = block->previous;
+        free(block);
+        block = previous;
+    }
+    arena->current = NULL;
+}
+
+void* arena_alloc(Arena* arena, size_t size)
+{
+    ArenaBlock* block = arena->current;
+    size = align_up(size > 0 ? size : 1);
+    if (!block || block->capacity - block->used < size)
+    {
+        // Chain a larger block; the exhausted one stays valid until the next reset
+        size_t capacity = block ? 2 * block->capacity : 0;
+        if (capacity < size)
+        {
+            capacity = size;
+        }
+        block = create_block(capacity, block);
+        if (!block)
+        {
+            return NULL;
+        }
+        arena->current = block;
+    }
+
+    void* memory = (unsigned char*)block + ARENA_HEADER_SIZE + block->used;
+    block->used += size;
+    return memory;
+}
+
+void* arena_calloc(Arena* arena, size_t count, size_t size)
+{
+    void* memory = arena_alloc(arena, count * size);
+    if (memory)
+    {
+        memset(memory, 0, count * size);
+    }
+    return memory;
+}
+
+void arena_reset(Arena* arena)
+{
+    ArenaBlock* block = arena->current;
+    if (!block)
+    {
+        return;
+    }
+    if (!block->previous)
+    {
+        block->used = 0;
+        return;
+    }
+
+    // The arena grew during the last iteration: replace the chain by one block that fits it all
+    size_t total = 0;
+    for (ArenaBlock* b = block; b; b = b->previous)
+    {
+        total += b->capacity;
+    }
+    arena_destroy(arena);
+    arena->current = create_block(total, NULL);
+}
@@ -1,11 +1,14 @@
 #include "cm_local_search.h"
+#include "moves.h"
+#include "instr.h"
+#include "arena.h"
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <stdio.h>
 
 // Function prototypes
-static Result CM_LocalSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions);
+static Result CM_LocalSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng);
 
 static void compute_candidate_edges(const int **distances, const int *costs, int num_nodes, int candidate_list_size, int **candidate_edges);
 
@@ -15,10 +18,6 @@ static int delta_two_edges_exchange_candidate(const int* solution, int solution_
 
 static int delta_inter_route_exchange_candidate(const int* solution, int solution_size, const int** distances, const int* costs, int i, int node_j, int **candidate_edges, int candidate_list_size);
 
-static void reverse_segment(int* solution, int start, int end, int solution_size);
-
-// Remove the declaration of shuffle_array since it's declared in utils.h
-// static void shuffle_array(int* array, int n);
 
 // Comparison function for qsort
 static int compare_node_values(const void* a, const void* b);
@@ -48,21 +47,14 @@ CM_LocalSearch* create_CM_LocalSearch(int candidate_list_size)
 }
 
 // Implement CM_LocalSearch_solve
-static Result CM_LocalSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions)
+static Result CM_LocalSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng)
 {
     CM_LocalSearch* cm_ls = (CM_LocalSearch*)algo;
     int solution_size = (num_nodes + 1) / 2; // Round up to select 50% of the nodes
 
     int total_iterations = num_solutions;
-    int bestCost = INT_MAX;
-    int worstCost = INT_MIN;
     long long totalCost = 0;
 
-    int* bestSolution = NULL;
-    int bestSolutionSize = 0;
-    int* worstSolution = NULL;
-    int worstSolutionSize = 0;
-
     // Precompute candidate edges
     int candidate_list_size = cm_ls->candidate_list_size;
     int **candidate_edges = (int**)malloc(num_nodes * sizeof(int*));
@@ -89,53 +81,47 @@ static Result CM_LocalSearch_solve(Algo *algo, const int **distances, int num_no
     // Compute candidate edges
     compute_candidate_edges(distances, costs, num_nodes, candidate_list_size, candidate_edges);
 
+    // Scratch of one run (solution, shuffled nodes, membership flags), reset before each run
+    Arena scratch;
+    Result res;
+    if (!arena_init(&scratch, solution_size * sizeof(int) + num_nodes * (sizeof(int) + sizeof(char)) + 3 * ARENA_ALIGNMENT) ||
+        !result_init(&res, solution_size))
+    {
+        fprintf(stderr, "Error: Memory allocation failed in CM_LocalSearch_solve\n");
+        arena_destroy(&scratch);
+        for (int i = 0; i < num_nodes; i++)
+            free(candidate_edges[i]);
+        free(candidate_edges);
+        return result_failed();
+    }
+
     // For num_solutions iterations
     for (int iter = 0; iter < num_solutions; iter++)
     {
         // Generate random starting solution
-        int* current_solution = (int*)malloc(solution_size * sizeof(int));
-        if (!current_solution)
+        arena_reset(&scratch);
+        int* current_solution = (int*)arena_alloc(&scratch, solution_size * sizeof(int));
+        int* all_nodes = (int*)arena_alloc(&scratch, num_nodes * sizeof(int));
+        // Prepare a boolean array for fast checking if a node is in the solution
+        char* in_solution = (char*)arena_calloc(&scratch, num_nodes, sizeof(char));
+        if (!current_solution || !all_nodes || !in_solution)
         {
             fprintf(stderr, "Error: Memory allocation failed in CM_LocalSearch_solve\n");
+            arena_destroy(&scratch);
+            free_Result(res);
             for (int i = 0; i < num_nodes; i++)
                 free(candidate_edges[i]);
             free(candidate_edges);
-            Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-            return res;
+            return result_failed();
         }
         // Random starting solution
-        int* all_nodes = (int*)malloc(num_nodes * sizeof(int));
-        if (!all_nodes)
-        {
-            fprintf(stderr, "Error: Memory allocation failed in CM_LocalSearch_solve\n");
-            free(current_solution);
-            for (int i = 0; i < num_nodes; i++)
-                free(candidate_edges[i]);
-            free(candidate_edges);
-            Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-            return res;
-        }
         for (int i = 0; i < num_nodes; i++)
         {
             all_nodes[i] = i;
         }
-        // Use shuffle_array from utils.h
-        shuffle_array(all_nodes, num_nodes);
+        rng_shuffle(rng, all_nodes, num_nodes);
         memcpy(current_solution, all_nodes, solution_size * sizeof(int));
-        free(all_nodes);
 
-        // Prepare a boolean array for fast checking if a node is in the solution
-        char* in_solution = (char*)calloc(num_nodes, sizeof(char));
-        if (!in_solution)
-        {
-            fprintf(stderr, "Error: Memory allocation failed in CM_LocalSearch_solve (in_solution)\n");
-            free(current_solution);
-            for (int i = 0; i < num_nodes; i++)
-                free(candidate_edges[i]);
-            free(candidate_edges);
-            Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-            return res;
-        }
         for (int i = 0; i < solution_size; i++)
         {
             in_solution[current_solution[i]] = 1;
@@ -143,6 +129,7 @@ static Result CM_LocalSearch_solve(Algo *algo, const int **distances, int num_no
 
         // Perform steepest local search with candidate moves
         int current_cost = calculate_cost(current_solution, solution_size, distances, costs);
+        INSTR_PHASE_BEGIN(descent);
         int improvement = 1;
         while (improvement)
         {
@@ -209,56 +196,26 @@ static Result CM_LocalSearch_solve(Algo *algo, const int **distances, int num_no
                     in_solution[move_j] = 1;
                 }
                 current_cost += best_delta;
+                INSTR_COUNT(applied_moves, 1);
                 improvement = 1;
             }
         }
 
+        INSTR_PHASE_END(descent, local_search_ns);
+
         // Update best, worst, total cost
         totalCost += current_cost;
-        if (current_cost < bestCost)
-        {
-            bestCost = current_cost;
-            if (bestSolution)
-                free(bestSolution);
-            bestSolution = (int*)malloc(solution_size * sizeof(int));
-            if (bestSolution)
-            {
-                memcpy(bestSolution, current_solution, solution_size * sizeof(int));
-                bestSolutionSize = solution_size;
-            }
-        }
-        if (current_cost > worstCost)
-        {
-            worstCost = current_cost;
-            if (worstSolution)
-                free(worstSolution);
-            worstSolution = (int*)malloc(solution_size * sizeof(int));
-            if (worstSolution)
-            {
-                memcpy(worstSolution, current_solution, solution_size * sizeof(int));
-                worstSolutionSize = solution_size;
-            }
-        }
-        free(current_solution);
-        free(in_solution);
+        result_record(&res, current_solution, solution_size, current_cost);
     }
 
-    double averageCost = (total_iterations > 0) ? ((double)totalCost / total_iterations) : 0.0;
+    arena_destroy(&scratch);
+    result_finish(&res, totalCost, total_iterations);
 
     // Free candidate_edges
     for (int i = 0; i < num_nodes; i++)
         free(candidate_edges[i]);
     free(candidate_edges);
 
-    Result res;
-    res.bestCost = bestCost;
-    res.worstCost = worstCost;
-    res.averageCost = averageCost;
-    res.bestSolution = bestSolution;
-    res.bestSolutionSize = bestSolutionSize;
-    res.worstSolution = worstSolution;
-    res.worstSolutionSize = worstSolutionSize;
-
     return res;
 }
 
@@ -336,6 +293,7 @@ static int is_candidate_edge(int node_u, int node_v, int **candidate_edges, int
 
 static int delta_two_edges_exchange_candidate(const int* solution, int solution_size, const int** distances, int i, int j, int **candidate_edges, int candidate_list_size)
 {
+    INSTR_COUNT(intra_edges_evals, 1);
     int size = solution_size;
 
     int node_i = solution[i];
@@ -379,6 +337,7 @@ static int delta_two_edges_exchange_candidate(const int* solution, int solution_
 
 static int delta_inter_route_exchange_candidate(const int* solution, int solution_size, const int** distances, const int* costs, int i, int node_j, int **candidate_edges, int candidate_list_size)
 {
+    INSTR_COUNT(inter_route_evals, 1);
     int size = solution_size;
     int node_i = solution[i];
     int prev_i = (i == 0) ? size - 1 : i - 1;
@@ -414,22 +373,3 @@ static int delta_inter_route_exchange_candidate(const int* solution, int solutio
     return delta;
 }
 
-static void reverse_segment(int* solution, int start, int end, int solution_size)
-{
-    int size = solution_size;
-    int i = start;
-    int j = end;
-
-    while (i != j && (i + size - 1) % size != j)
-    {
-        int temp = solution[i];
-        solution[i] = solution[j];
-        solution[j] = temp;
-
-        i = (i + 1) % size;
-        if (j == 0)
-            j = size - 1;
-        else
-            j = j - 1;
-    }
-}
@@ -0,0 +1,76 @@
+#include "deadline.h"
+#include <pthread.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define DEADLINE_TSC 1
+#endif
+
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+#ifdef DEADLINE_TSC
+static double ticks_per_us = 0.0;
+static pthread_once_t calibration_once = PTHREAD_ONCE_INIT;
+
+// Counts ticks over a millisecond of CLOCK_MONOTONIC; assumes an invariant TSC
+static void calibrate(void)
+{
+    uint64_t start_ns = monotonic_ns();
+    uint64_t start_ticks = __rdtsc();
+    uint64_t end_ns;
+    do
+    {
+        end_ns = monotonic_ns();
+    } while (end_ns - start_ns < 1000000ULL);
+    uint64_t end_ticks = __rdtsc();
+    ticks_per_us = (double)(end_ticks - start_ticks) * 1000.0 / (double)(end_ns - start_ns);
+}
+#endif
+
+static uint64_t now_ticks(void)
+{
+#ifdef DEADLINE_TSC
+    return __rdtsc();
+#else
+    return monotonic_ns();
+#endif
+}
+
+void deadline_init(Deadline* deadline, long long budget_us)
+{
+    deadline_init_cancellable(deadline, budget_us, NULL);
+}
+
+void deadline_init_cancellable(Deadline* deadline, long long budget_us, const int* cancel_flag)
+{
+#ifdef DEADLINE_TSC
+    pthread_once(&calibration_once, calibrate);
+    double scale = ticks_per_us;
+#else
+    double scale = 1000.0;
+#endif
+    double budget_ticks = budget_us > 0 ? (double)budget_us * scale : 0.0;
+    uint64_t now = now_ticks();
+    deadline->end_ticks = budget_ticks < (double)(UINT64_MAX - now) ? now + (uint64_t)budget_ticks : UINT64_MAX;
+    deadline->cancel_flag = cancel_flag;
+    deadline->countdown = DEADLINE_CHECK_INTERVAL;
+    deadline->expired = 0;
+}
+
+int deadline_check(Deadline* deadline)
+{
+    deadline->countdown = DEADLINE_CHECK_INTERVAL;
+    if (!deadline->expired &&
+        (now_ticks() >= deadline->end_ticks ||
+         (deadline->cancel_flag && __atomic_load_n(deadline->cancel_flag, __ATOMIC_RELAXED))))
+    {
+        deadline->expired = 1;
+    }
+    return deadline->expired;
+}
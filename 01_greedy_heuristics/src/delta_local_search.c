@@ -1,4 +1,7 @@
 #include "delta_local_search.h"
+#include "moves.h"
+#include "instr.h"
+#include "tour_hash.h"
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
@@ -22,22 +25,27 @@ typedef struct
     Move* moves; // Array of moves
     int size;    // Current number of moves
     int capacity; // Capacity of the moves array
+    Arena* arena; // Arena the array grows into
 } PriorityQueue;
 
+// Initial capacity of the move list
+#define INITIAL_LM_CAPACITY 1000
+
+#ifdef TOUR_HASH_CHECK
+long long tour_hash_checked_moves = 0;
+long long tour_hash_check_failures = 0;
+#endif
+
 // Function prototypes
-static Result DeltaLocalSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions);
-static int delta_two_edges_exchange(const int* solution, int solution_size, const int** distances, int i, int j);
-static int delta_inter_route_exchange(const int* solution, int solution_size, const int** distances, const int* costs, int i, int node_j);
-static void reverse_segment(int* solution, int start, int end, int solution_size);
+static Result DeltaLocalSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng);
 
-static void apply_move(int* solution, int solution_size, Move* move, int* predecessor, int* successor);
+static void apply_move(int* solution, int solution_size, Move* move, int* predecessor, int* successor, uint64_t* hash);
 static int update_move(Move* move, const int* predecessor, const int* successor);
-static void evaluate_all_moves_and_add_to_LM(int* current_solution, int solution_size, const int** distances, const int* costs, const char* in_solution, int* predecessor, int* successor, int num_nodes, PriorityQueue* pq);
+static void evaluate_all_moves_and_add_to_LM(int* current_solution, int solution_size, const int** distances, const int* costs, const char* in_solution, int* predecessor, int* successor, int num_nodes, PriorityQueue* pq, Deadline* deadline);
 
-static void init_pq(PriorityQueue* pq, int capacity);
-static void free_pq(PriorityQueue* pq);
+static void init_pq(PriorityQueue* pq, int capacity, Arena* arena);
 static void insert_move_pq(PriorityQueue* pq, Move* move);
-static Move* extract_min_move_pq(PriorityQueue* pq);
+static int extract_min_move_pq(PriorityQueue* pq, Move* min_move);
 
 // delta_local_search.c
 DeltaLocalSearch* create_DeltaLocalSearch(int method_index, int* initial_solution, int initial_solution_size)
@@ -70,222 +78,195 @@ DeltaLocalSearch* create_DeltaLocalSearch(int method_index, int* initial_solutio
 }
 
 // delta_local_search.c
-static Result DeltaLocalSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions)
+static Result DeltaLocalSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng)
 {
+    (void)rng; // Deterministic: the starting solution is given
     DeltaLocalSearch* dls = (DeltaLocalSearch*)algo;
     int solution_size = dls->initial_solution_size; // Use the provided solution size
 
     int total_iterations = num_solutions;
-    int bestCost = INT_MAX;
-    int worstCost = INT_MIN;
     long long totalCost = 0;
 
-    int* bestSolution = NULL;
-    int bestSolutionSize = 0;
-    int* worstSolution = NULL;
-    int worstSolutionSize = 0;
+    // Scratch of one descent, reset before each one; the Result buffers are allocated once
+    Arena scratch;
+    Result res;
+    if (!arena_init(&scratch, solution_size * sizeof(int) + delta_local_search_scratch_size(num_nodes)) ||
+        !result_init(&res, solution_size))
+    {
+        fprintf(stderr, "Error: Memory allocation failed in DeltaLocalSearch_solve\n");
+        arena_destroy(&scratch);
+        return result_failed();
+    }
 
     // Iterate over the number of solutions (typically 1 in this context)
     for (int iter = 0; iter < num_solutions; iter++)
     {
         // Use the provided initial solution
-        int* current_solution = (int*)malloc(solution_size * sizeof(int));
+        arena_reset(&scratch);
+        int* current_solution = (int*)arena_alloc(&scratch, solution_size * sizeof(int));
         if (!current_solution)
         {
             fprintf(stderr, "Error: Memory allocation failed in DeltaLocalSearch_solve\n");
-            Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-            return res;
+            arena_destroy(&scratch);
+            free_Result(res);
+            return result_failed();
         }
         memcpy(current_solution, dls->initial_solution, solution_size * sizeof(int));
 
-        // Prepare a boolean array for fast checking if a node is in the solution
-        char* in_solution = (char*)calloc(num_nodes, sizeof(char));
-        if (!in_solution)
-        {
-            fprintf(stderr, "Error: Memory allocation failed in DeltaLocalSearch_solve (in_solution)\n");
-            free(current_solution);
-            Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-            return res;
-        }
-        for (int i = 0; i < solution_size; i++)
+        int current_cost = delta_local_search_run(current_solution, solution_size, distances, costs, num_nodes, &scratch, NULL, NULL);
+        if (current_cost == INT_MAX)
         {
-            in_solution[current_solution[i]] = 1;
+            arena_destroy(&scratch);
+            free_Result(res);
+            return result_failed();
         }
 
-        // Initialize predecessor and successor arrays
-        int* successor = (int*)malloc(num_nodes * sizeof(int));
-        int* predecessor = (int*)malloc(num_nodes * sizeof(int));
-        if (!successor || !predecessor)
-        {
-            fprintf(stderr, "Error: Memory allocation failed in DeltaLocalSearch_solve (successor/predecessor)\n");
-            free(current_solution);
-            free(in_solution);
-            free(successor);
-            free(predecessor);
-            Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-            return res;
-        }
-        // Initialize successor and predecessor arrays
-        for (int i = 0; i < solution_size; i++)
-        {
-            int node = current_solution[i];
-            int next_node = current_solution[(i + 1) % solution_size];
-            int prev_node = current_solution[(i - 1 + solution_size) % solution_size];
-            successor[node] = next_node;
-            predecessor[node] = prev_node;
-        }
+        // Update best, worst, total cost
+        totalCost += current_cost;
+        result_record(&res, current_solution, solution_size, current_cost);
+    }
 
-        // Initialize priority queue LM
-        PriorityQueue LM;
-        init_pq(&LM, 1000); // Initial capacity
+    arena_destroy(&scratch);
+    result_finish(&res, totalCost, total_iterations);
 
-        // Calculate the initial cost of the current solution
-        int current_cost = calculate_cost(current_solution, solution_size, distances, costs);
+    return res;
+}
+
+size_t delta_local_search_scratch_size(int num_nodes)
+{
+    return num_nodes * (sizeof(char) + 2 * sizeof(int)) + INITIAL_LM_CAPACITY * sizeof(Move) + 4 * ARENA_ALIGNMENT;
+}
+
+int delta_local_search_run(int* current_solution, int solution_size, const int** distances, const int* costs, int num_nodes, Arena* scratch, Deadline* deadline, SeenSet* seen)
+{
+    // Prepare a boolean array for fast checking if a node is in the solution
+    char* in_solution = (char*)arena_calloc(scratch, num_nodes, sizeof(char));
+    // Predecessor and successor of every node of the cycle
+    int* successor = (int*)arena_alloc(scratch, num_nodes * sizeof(int));
+    int* predecessor = (int*)arena_alloc(scratch, num_nodes * sizeof(int));
+    // Priority queue LM
+    PriorityQueue LM;
+    init_pq(&LM, INITIAL_LM_CAPACITY, scratch);
+    if (!in_solution || !successor || !predecessor || !LM.moves)
+    {
+        fprintf(stderr, "Error: Memory allocation failed in delta_local_search_run\n");
+        return INT_MAX;
+    }
+
+    for (int i = 0; i < solution_size; i++)
+    {
+        in_solution[current_solution[i]] = 1;
+    }
+    for (int i = 0; i < solution_size; i++)
+    {
+        int node = current_solution[i];
+        int next_node = current_solution[(i + 1) % solution_size];
+        int prev_node = current_solution[(i - 1 + solution_size) % solution_size];
+        successor[node] = next_node;
+        predecessor[node] = prev_node;
+    }
 
-        int found_improving_move = 0;
+    // Calculate the initial cost of the current solution
+    int current_cost = calculate_cost(current_solution, solution_size, distances, costs);
 
-        do
+    // Every tour on the path is recorded; reaching one recorded before means the rest of
+    // this descent was already explored
+    uint64_t hash = 0;
+    if (seen)
+    {
+        hash = tour_hash(current_solution, solution_size);
+        if (!seen_set_insert(seen, hash))
         {
-            found_improving_move = 0;
+            INSTR_COUNT(descents_seen, 1);
+            return DESCENT_SEEN;
+        }
+    }
 
-            // Evaluate all possible moves and add improving moves to LM
-            evaluate_all_moves_and_add_to_LM(current_solution, solution_size, distances, costs, in_solution, predecessor, successor, num_nodes, &LM);
+    int found_improving_move = 0;
 
-            // Process LM
-            while (LM.size > 0)
-            {
-                Move* move_ptr = extract_min_move_pq(&LM);
-                if (!move_ptr)
-                {
-                    // Priority queue is empty
-                    break;
-                }
+    INSTR_PHASE_BEGIN(descent);
+    do
+    {
+        found_improving_move = 0;
 
-                Move* move = move_ptr;
+        // Evaluate all possible moves and add improving moves to LM
+        evaluate_all_moves_and_add_to_LM(current_solution, solution_size, distances, costs, in_solution, predecessor, successor, num_nodes, &LM, deadline);
+        if (deadline_expired(deadline))
+        {
+            // The sweep was cut short; the solution stays as improved so far
+            break;
+        }
 
-                int update_status = update_move(move, predecessor, successor);
+        // Process LM
+        Move move;
+        while (extract_min_move_pq(&LM, &move))
+        {
+            int update_status = update_move(&move, predecessor, successor);
 
-                if (update_status == -1)
-                {
-                    // Move is invalid, skip
-                    free(move_ptr);
-                    continue;
-                }
-                else if (update_status == 0)
+            if (update_status == -1)
+            {
+                // Move is invalid, skip
+                INSTR_COUNT(move_list_stale, 1);
+                continue;
+            }
+            else if (update_status == 0)
+            {
+                // Edges reversed or mixed orientation, skip
+                INSTR_COUNT(move_list_stale, 1);
+                continue;
+            }
+            else if (update_status == 1)
+            {
+                // Apply the move
+                INSTR_COUNT(move_list_hits, 1);
+                INSTR_COUNT(applied_moves, 1);
+                apply_move(current_solution, solution_size, &move, predecessor, successor, seen ? &hash : NULL);
+#ifdef TOUR_HASH_CHECK
+                if (seen)
                 {
-                    // Edges reversed or mixed orientation, skip
-                    free(move_ptr);
-                    continue;
+                    tour_hash_checked_moves++;
+                    if (hash != tour_hash(current_solution, solution_size)) tour_hash_check_failures++;
                 }
-                else if (update_status == 1)
+#endif
+                current_cost += move.delta;
+
+                // Update in_solution array if necessary
+                if (move.type == 1)
                 {
-                    // Apply the move
-                    apply_move(current_solution, solution_size, move, predecessor, successor);
-                    current_cost += move->delta;
-
-                    // Update in_solution array if necessary
-                    if (move->type == 1)
-                    {
-                        int old_node = move->edge_u2; // node_i
-                        int new_node = move->j;
-                        in_solution[old_node] = 0;
-                        in_solution[new_node] = 1;
-                    }
-
-                    free(move_ptr);
-
-                    found_improving_move = 1;
-                    break;
+                    int old_node = move.edge_u2; // node_i
+                    int new_node = move.j;
+                    in_solution[old_node] = 0;
+                    in_solution[new_node] = 1;
                 }
-            }
 
-            // If no improving move was found after checking the whole LM, exit loop
-            if (!found_improving_move)
-            {
+                found_improving_move = 1;
                 break;
             }
+        }
 
-            // Clear LM before next iteration
-            free_pq(&LM);
-            init_pq(&LM, 1000);
-
-        } while (found_improving_move);
-
-        // Free LM
-        free_pq(&LM);
+        // Clear LM before next iteration, keeping its array
+        LM.size = 0;
 
-        // Update best, worst, total cost
-        totalCost += current_cost;
-        if (current_cost < bestCost)
-        {
-            bestCost = current_cost;
-            if (bestSolution)
-                free(bestSolution);
-            bestSolution = (int*)malloc(solution_size * sizeof(int));
-            if (bestSolution)
-            {
-                memcpy(bestSolution, current_solution, solution_size * sizeof(int));
-                bestSolutionSize = solution_size;
-            }
-        }
-        if (current_cost > worstCost)
+        if (found_improving_move && seen && !seen_set_insert(seen, hash))
         {
-            worstCost = current_cost;
-            if (worstSolution)
-                free(worstSolution);
-            worstSolution = (int*)malloc(solution_size * sizeof(int));
-            if (worstSolution)
-            {
-                memcpy(worstSolution, current_solution, solution_size * sizeof(int));
-                worstSolutionSize = solution_size;
-            }
+            INSTR_COUNT(descents_seen, 1);
+            current_cost = DESCENT_SEEN;
+            break;
         }
 
-        // Free resources
-        free(current_solution);
-        free(in_solution);
-        free(successor);
-        free(predecessor);
-    }
-
-    double averageCost = (total_iterations > 0) ? ((double)totalCost / total_iterations) : 0.0;
-
-    Result res;
-    res.bestCost = bestCost;
-    res.worstCost = worstCost;
-    res.averageCost = averageCost;
-    res.bestSolution = bestSolution;
-    res.bestSolutionSize = bestSolutionSize;
-    res.worstSolution = worstSolution;
-    res.worstSolutionSize = worstSolutionSize;
+    } while (found_improving_move);
+    INSTR_PHASE_END(descent, local_search_ns);
 
-    return res;
+    return current_cost;
 }
 
 
-static void init_pq(PriorityQueue* pq, int capacity)
+static void init_pq(PriorityQueue* pq, int capacity, Arena* arena)
 {
-    pq->moves = (Move*)malloc(capacity * sizeof(Move));
-    if (!pq->moves)
-    {
-        fprintf(stderr, "Error: Memory allocation failed for PriorityQueue\n");
-        pq->size = 0;
-        pq->capacity = 0;
-        return;
-    }
+    pq->arena = arena;
+    pq->moves = (Move*)arena_alloc(arena, capacity * sizeof(Move));
     pq->size = 0;
-    pq->capacity = capacity;
-}
-
-static void free_pq(PriorityQueue* pq)
-{
-    if (pq->moves)
-    {
-        free(pq->moves);
-        pq->moves = NULL;
-    }
-    pq->size = 0;
-    pq->capacity = 0;
+    pq->capacity = pq->moves ? capacity : 0;
 }
 
 static void insert_move_pq(PriorityQueue* pq, Move* move)
@@ -293,14 +274,16 @@ static void insert_move_pq(PriorityQueue* pq, Move* move)
     // Ensure capacity
     if (pq->size >= pq->capacity)
     {
-        // Resize the array
-        pq->capacity *= 2;
-        pq->moves = (Move*)realloc(pq->moves, pq->capacity * sizeof(Move));
-        if (!pq->moves)
+        // Move to an array twice the size; the old one is released with the arena
+        Move* moves = (Move*)arena_alloc(pq->arena, 2 * pq->capacity * sizeof(Move));
+        if (!moves)
         {
             fprintf(stderr, "Error: Memory allocation failed in insert_move_pq\n");
             return;
         }
+        memcpy(moves, pq->moves, pq->size * sizeof(Move));
+        pq->moves = moves;
+        pq->capacity *= 2;
     }
 
     // Insert the move at the end
@@ -327,18 +310,11 @@ static void insert_move_pq(PriorityQueue* pq, Move* move)
     }
 }
 
-static Move* extract_min_move_pq(PriorityQueue* pq)
+static int extract_min_move_pq(PriorityQueue* pq, Move* min_move)
 {
     if (pq->size == 0)
     {
-        return NULL;
-    }
-
-    Move* min_move = (Move*)malloc(sizeof(Move));
-    if (!min_move)
-    {
-        fprintf(stderr, "Error: Memory allocation failed in extract_min_move_pq\n");
-        return NULL;
+        return 0;
     }
 
     *min_move = pq->moves[0];
@@ -376,10 +352,10 @@ static Move* extract_min_move_pq(PriorityQueue* pq)
         }
     }
 
-    return min_move;
+    return 1;
 }
 
-static void evaluate_all_moves_and_add_to_LM(int* current_solution, int solution_size, const int** distances, const int* costs, const char* in_solution, int* predecessor, int* successor, int num_nodes, PriorityQueue* pq)
+static void evaluate_all_moves_and_add_to_LM(int* current_solution, int solution_size, const int** distances, const int* costs, const char* in_solution, int* predecessor, int* successor, int num_nodes, PriorityQueue* pq, Deadline* deadline)
 {
     int delta;
     Move move;
@@ -392,6 +368,8 @@ static void evaluate_all_moves_and_add_to_LM(int* current_solution, int solution
             int jj = j % solution_size;
             if (i == jj)
                 continue;
+            if (deadline_poll(deadline))
+                return;
 
             delta = delta_two_edges_exchange(current_solution, solution_size, distances, i, jj);
 
@@ -422,6 +400,8 @@ static void evaluate_all_moves_and_add_to_LM(int* current_solution, int solution
         {
             if (!in_solution[node_j])
             {
+                if (deadline_poll(deadline))
+                    return;
                 delta = delta_inter_route_exchange(current_solution, solution_size, distances, costs, i, node_j);
 
                 if (delta < 0)
@@ -450,77 +430,7 @@ static void evaluate_all_moves_and_add_to_LM(int* current_solution, int solution
     }
 }
 
-static int delta_two_edges_exchange(const int* solution, int solution_size, const int** distances, int i, int j)
-{
-    int size = solution_size;
-
-    int node_i = solution[i];
-    int node_ip1 = solution[(i + 1) % size];
-    int node_j = solution[j];
-    int node_jp1 = solution[(j + 1) % size];
-
-    if (i == j)
-    {
-        return 0;
-    }
-
-    // Avoid swapping the same edge or adjacent edges that would create loops
-    if ((i + 1) % size == j || (j + 1) % size == i)
-    {
-        return 0;
-    }
-
-    int delta = 0;
-
-    delta -= distances[node_i][node_ip1];
-    delta -= distances[node_j][node_jp1];
-    delta += distances[node_i][node_j];
-    delta += distances[node_ip1][node_jp1];
-
-    return delta;
-}
-
-static int delta_inter_route_exchange(const int* solution, int solution_size, const int** distances, const int* costs, int i, int node_j)
-{
-    int size = solution_size;
-    int node_i = solution[i];
-    int prev_i = solution[(i - 1 + size) % size];
-    int next_i = solution[(i + 1) % size];
-
-    int delta = 0;
-
-    delta -= distances[prev_i][node_i];
-    delta -= distances[node_i][next_i];
-    delta += distances[prev_i][node_j];
-    delta += distances[node_j][next_i];
-
-    delta -= costs[node_i];
-    delta += costs[node_j];
-
-    return delta;
-}
-
-static void reverse_segment(int* solution, int start, int end, int solution_size)
-{
-    int size = solution_size;
-    int i = start;
-    int j = end;
-
-    while (i != j && (i + size - 1) % size != j)
-    {
-        int temp = solution[i];
-        solution[i] = solution[j];
-        solution[j] = temp;
-
-        i = (i + 1) % size;
-        if (j == 0)
-            j = size - 1;
-        else
-            j = j - 1;
-    }
-}
-
-static void apply_move(int* solution, int solution_size, Move* move, int* predecessor, int* successor)
+static void apply_move(int* solution, int solution_size, Move* move, int* predecessor, int* successor, uint64_t* hash)
 {
     if (move->type == 0)
     {
@@ -529,6 +439,16 @@ static void apply_move(int* solution, int solution_size, Move* move, int* predec
         int i = move->i;
         int j = move->j;
 
+        if (hash)
+        {
+            // Edges (a, b) and (c, d) become (a, c) and (b, d); the reversed segment keeps its edges
+            int a = solution[i];
+            int b = solution[(i + 1) % size];
+            int c = solution[j];
+            int d = solution[(j + 1) % size];
+            *hash ^= tour_hash_edge(a, b) ^ tour_hash_edge(c, d) ^ tour_hash_edge(a, c) ^ tour_hash_edge(b, d);
+        }
+
         // Reverse the segment between (i+1) and j
         reverse_segment(solution, (i + 1) % size, j, solution_size);
 
@@ -551,6 +471,13 @@ static void apply_move(int* solution, int solution_size, Move* move, int* predec
         int prev_node = predecessor[old_node];
         int next_node = successor[old_node];
 
+        if (hash)
+        {
+            *hash ^= tour_hash_node(old_node) ^ tour_hash_node(new_node) ^
+                     tour_hash_edge(prev_node, old_node) ^ tour_hash_edge(old_node, next_node) ^
+                     tour_hash_edge(prev_node, new_node) ^ tour_hash_edge(new_node, next_node);
+        }
+
         // Update solution
         solution[move->i] = new_node;
 
@@ -4,27 +4,85 @@
 #include <limits.h>
 #include <stdio.h>
 #include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 // Include necessary headers for local search
 #include "local_search.h"
+#include "delta_local_search.h"
 #include "utils.h"
-#include <time.h>
+#include "rng.h"
+#include "instr.h"
+
+// States of an island mailbox
+enum
+{
+    MAILBOX_EMPTY = 0,
+    MAILBOX_WRITING = 1,
+    MAILBOX_FULL = 2,
+    MAILBOX_READING = 3
+};
 
+/**
+ * @brief Single-slot mailbox holding the last elite solution sent to an island.
+ * Ownership of the buffer is handed over with compare-and-swap on the state, so neither
+ * side ever blocks: a sender that finds the slot being read simply skips that migration.
+ */
+typedef struct {
+    atomic_int state;
+    int cost;
+    int* solution;
+} Mailbox;
+
+/**
+ * @brief Per-island state. Everything except the mailboxes is private to the island's thread.
+ */
+typedef struct {
+    const ILS* ils;
+    const int** distances;
+    const int* costs;
+    int num_nodes;
+    int solution_size;
+    long long deadline_us;  // Shared end of the run on the CLOCK_MONOTONIC microsecond scale
+    Mailbox* inbox;
+    Mailbox* outbox;       // Inbox of the next island in the ring
+    SeenSet* seen;         // Tours passed through by the descents of all islands, NULL to disable
+    Rng rng;
+
+    int* all_nodes;
+    int* current_solution;
+    int current_cost;
+    int* candidate;        // Perturbed solution, improved in place by the local search
+    Arena scratch;         // Scratch of the local search, reset by every descent
+
+    int bestCost;
+    int worstCost;
+    long long totalCost;
+    int iterations;         // Descents started after a perturbation, plus the initial one
+    int abandoned;          // Of those, descents that reached a seen tour; not in the costs
+    int* bestSolution;
+    int* worstSolution;
+    int failed;
+    InstrCounters counters; // Instrumentation gathered by this island's thread
+    long long start_us;
+    Trace trace;            // Improvements of this island's best, merged after the join
+} Island;
 
 /**
  * @brief Performs a perturbation on the given solution by performing k random 2-opt moves.
  *
+ * @param rng Random stream of the calling island.
  * @param solution Current solution array.
  * @param solution_size Size of the solution.
  * @param k Number of perturbation moves.
  */
-static void perturb_solution(int* solution, int solution_size, int k)
+static void perturb_solution(Rng* rng, int* solution, int solution_size, int k)
 {
     for (int i = 0; i < k; i++)
     {
         // Select two distinct random indices for 2-opt
-        int idx1 = rand() % solution_size;
-        int idx2 = rand() % solution_size;
+        int idx1 = (int)rng_bounded(rng, (uint32_t)solution_size);
+        int idx2 = (int)rng_bounded(rng, (uint32_t)solution_size);
         if (idx1 == idx2)
             continue;
         if (idx1 > idx2)
@@ -58,8 +116,255 @@ static long long current_time_ms()
     return (long long)(ts.tv_sec) * 1000 + (ts.tv_nsec) / 1000000;
 }
 
+/**
+ * @brief Gets the current time in microseconds.
+ */
+static long long current_time_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)(ts.tv_sec) * 1000000 + (ts.tv_nsec) / 1000;
+}
+
+/**
+ * @brief Posts a solution to a mailbox, replacing a message that was not read yet.
+ *
+ * @return 1 if the solution was posted, 0 if the receiver was reading the slot.
+ */
+static int mailbox_send(Mailbox* mailbox, const int* solution, int solution_size, int cost)
+{
+    int expected = MAILBOX_EMPTY;
+    if (!atomic_compare_exchange_strong(&mailbox->state, &expected, MAILBOX_WRITING))
+    {
+        expected = MAILBOX_FULL;
+        if (!atomic_compare_exchange_strong(&mailbox->state, &expected, MAILBOX_WRITING))
+        {
+            return 0;
+        }
+    }
+
+    memcpy(mailbox->solution, solution, solution_size * sizeof(int));
+    mailbox->cost = cost;
+    atomic_store_explicit(&mailbox->state, MAILBOX_FULL, memory_order_release);
+    return 1;
+}
+
+/**
+ * @brief Takes the pending solution out of a mailbox, if there is one.
+ *
+ * @return 1 if a solution was copied to out_solution, 0 otherwise.
+ */
+static int mailbox_receive(Mailbox* mailbox, int* out_solution, int solution_size, int* out_cost)
+{
+    if (atomic_load_explicit(&mailbox->state, memory_order_relaxed) != MAILBOX_FULL)
+    {
+        return 0;
+    }
+
+    int expected = MAILBOX_FULL;
+    if (!atomic_compare_exchange_strong_explicit(&mailbox->state, &expected, MAILBOX_READING,
+                                                 memory_order_acquire, memory_order_relaxed))
+    {
+        return 0;
+    }
+
+    memcpy(out_solution, mailbox->solution, solution_size * sizeof(int));
+    *out_cost = mailbox->cost;
+    atomic_store_explicit(&mailbox->state, MAILBOX_EMPTY, memory_order_release);
+    return 1;
+}
+
+/**
+ * @brief Records the outcome of one local search in the island statistics.
+ */
+static void record_local_search(Island* island, const int* solution, int cost)
+{
+    int solution_size = island->solution_size;
+
+    island->iterations++;
+    island->totalCost += cost;
+    if (cost < island->bestCost)
+    {
+        island->bestCost = cost;
+        memcpy(island->bestSolution, solution, solution_size * sizeof(int));
+        if (island->trace.points)
+            trace_record(&island->trace, current_time_us() - island->start_us, island->iterations, island->bestCost);
+    }
+    if (cost > island->worstCost)
+    {
+        island->worstCost = cost;
+        memcpy(island->worstSolution, solution, solution_size * sizeof(int));
+    }
+}
+
+/**
+ * @brief Thread entry point of an island: one ILS chain running until the shared deadline.
+ * The chain accepts a locally optimized candidate when it improves the current solution,
+ * and adopts a migrant when it is better than the current solution.
+ *
+ * @param arg Pointer to the Island of this thread.
+ * @return NULL.
+ */
+static void* island_run(void* arg)
+{
+    Island* island = (Island*)arg;
+    const ILS* ils = island->ils;
+    int solution_size = island->solution_size;
+
+    // Polled inside the local searches too, so a long descent cannot overrun the budget
+    Deadline deadline;
+    deadline_init_cancellable(&deadline, island->deadline_us - current_time_us(), ils->cancel_flag);
+
+    // Generate initial random solution
+    for (int i = 0; i < island->num_nodes; i++)
+    {
+        island->all_nodes[i] = i;
+    }
+    rng_shuffle(&island->rng, island->all_nodes, island->num_nodes);
+    memcpy(island->candidate, island->all_nodes, solution_size * sizeof(int));
+
+    // Perform initial local search; it is kept even if the deadline cut it short, and it
+    // ignores the seen set, as the island has no solution to fall back on yet
+    int cost = perform_local_search(island->candidate, solution_size, island->distances, island->costs, island->num_nodes, &island->scratch, &deadline, NULL);
+    if (cost == INT_MAX)
+    {
+        island->failed = 1;
+        island->counters = instr_take();
+        return NULL;
+    }
+    record_local_search(island, island->candidate, cost);
+    memcpy(island->current_solution, island->candidate, solution_size * sizeof(int));
+    island->current_cost = cost;
+
+    int migration_interval = ils->migration_interval_ms > 0 ? ils->migration_interval_ms : 1;
+    long long next_migration = current_time_ms() + migration_interval;
+
+    // Iteratively perform perturbation and local search
+    while (!deadline_check(&deadline))
+    {
+        long long now = current_time_ms();
+        if (now >= next_migration)
+        {
+            mailbox_send(island->outbox, island->bestSolution, solution_size, island->bestCost);
+            next_migration = now + migration_interval;
+        }
+
+        int migrant_cost;
+        if (mailbox_receive(island->inbox, island->candidate, solution_size, &migrant_cost) &&
+            migrant_cost < island->current_cost)
+        {
+            memcpy(island->current_solution, island->candidate, solution_size * sizeof(int));
+            island->current_cost = migrant_cost;
+        }
+
+        // Perturb a copy of the current solution
+        memcpy(island->candidate, island->current_solution, solution_size * sizeof(int));
+        INSTR_PHASE_BEGIN(perturbation);
+        perturb_solution(&island->rng, island->candidate, solution_size, ils->perturbation_strength);
+        INSTR_PHASE_END(perturbation, perturbation_ns);
+
+        // Perform local search on the perturbed solution
+        cost = perform_local_search(island->candidate, solution_size, island->distances, island->costs, island->num_nodes, &island->scratch, &deadline, island->seen);
+        if (cost == INT_MAX)
+        {
+            island->failed = 1;
+            break;
+        }
+        if (cost == DESCENT_SEEN)
+        {
+            // The rest of the path was walked before. On this island's own paths nothing is
+            // lost: that optimum did not improve the current solution then and cannot now.
+            // Sharing the set trades the rare optimum of another island's path for descents.
+            island->iterations++;
+            island->abandoned++;
+            continue;
+        }
+        if (deadline_expired(&deadline))
+        {
+            // A descent cut short is not a local optimum, so it does not count as an iteration
+            break;
+        }
+        record_local_search(island, island->candidate, cost);
+
+        if (cost < island->current_cost)
+        {
+            memcpy(island->current_solution, island->candidate, solution_size * sizeof(int));
+            island->current_cost = cost;
+        }
+    }
+
+    island->counters = instr_take();
+    return NULL;
+}
+
+/**
+ * @brief Releases the buffers owned by an island.
+ */
+static void free_island(Island* island)
+{
+    free(island->all_nodes);
+    free(island->current_solution);
+    free(island->candidate);
+    free(island->bestSolution);
+    free(island->worstSolution);
+    arena_destroy(&island->scratch);
+    trace_free(&island->trace);
+}
+
+/**
+ * @brief Orders trace points by time, ties by iteration.
+ */
+static int compare_trace_points(const void* a, const void* b)
+{
+    const TracePoint* pa = (const TracePoint*)a;
+    const TracePoint* pb = (const TracePoint*)b;
+    if (pa->elapsed_us != pb->elapsed_us)
+        return pa->elapsed_us < pb->elapsed_us ? -1 : 1;
+    return pa->iteration - pb->iteration;
+}
+
+/**
+ * @brief Merges the island traces into the trace of the whole run.
+ * Only points improving the best over all islands are kept.
+ */
+static void merge_island_traces(Trace* trace, const Island* islands, int num_islands)
+{
+    trace_clear(trace);
+
+    int total = 0;
+    for (int k = 0; k < num_islands; k++)
+        total += trace_size(&islands[k].trace);
+    if (total == 0)
+        return;
+
+    TracePoint* points = (TracePoint*)malloc(total * sizeof(TracePoint));
+    if (!points)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for trace merge\n");
+        return;
+    }
+    int count = 0;
+    for (int k = 0; k < num_islands; k++)
+    {
+        for (int i = 0; i < trace_size(&islands[k].trace); i++)
+            points[count++] = *trace_at(&islands[k].trace, i);
+    }
+    qsort(points, count, sizeof(TracePoint), compare_trace_points);
+
+    int best = INT_MAX;
+    for (int i = 0; i < count; i++)
+    {
+        if (points[i].best_eval < best)
+        {
+            best = points[i].best_eval;
+            trace_record(trace, points[i].elapsed_us, points[i].iteration, best);
+        }
+    }
+    free(points);
+}
+
 // Forward declaration of the solve function
-static Result ILS_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions);
+static Result ILS_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng);
 
 /**
  * @brief Creates an instance of the ILS algorithm.
@@ -90,153 +395,215 @@ ILS* create_ILS(int max_time_ms, int perturbation_strength)
     ils->base.solve = ILS_solve;
     ils->max_time_ms = max_time_ms;
     ils->perturbation_strength = perturbation_strength;
+    ils->num_islands = 20;
+    ils->migration_interval_ms = max_time_ms / 10 > 0 ? max_time_ms / 10 : 1;
+    ils->solution_size = 0;
+    ils->seen_capacity = 1 << 20;
+    ils->trace = NULL;
+    ils->quiet = 0;
+    ils->last_iterations = 0;
+    ils->last_abandoned = 0;
+    ils->cancel_flag = NULL;
 
     return ils;
 }
 
 /**
  * @brief Performs the Iterated Local Search.
- * Alternates between local search and perturbation until the time limit is reached.
+ * Runs ils->num_islands chains in parallel until a shared deadline of max_time_ms and
+ * aggregates every local search of every island into the result.
  *
  * @param algo Pointer to the ILS algorithm instance.
  * @param distances 2D array of distances between nodes.
  * @param num_nodes Total number of nodes.
  * @param costs Array of node costs.
  * @param num_solutions Number of ILS iterations (not used, controlled by time).
+ * @param rng Random generator the per-island streams are derived from.
  * @return Result structure containing the best, worst, and average costs.
  */
-static Result ILS_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions)
+static Result ILS_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng)
 {
+    (void)num_solutions;
     ILS* ils = (ILS*)algo;
-    int solution_size = (num_nodes + 1) / 2; // Selecting approximately 50% of the nodes
-
-    int bestCost = INT_MAX;
-    int worstCost = INT_MIN;
-    long long totalCost = 0;
-    int iterations = 0;
+    int solution_size = ils->solution_size > 0 ? ils->solution_size : (num_nodes + 1) / 2; // By default approximately 50% of the nodes
+    if (solution_size > num_nodes)
+    {
+        fprintf(stderr, "Error: ILS cannot select %d of %d nodes\n", solution_size, num_nodes);
+        return result_failed();
+    }
+    int num_islands = ils->num_islands > 0 ? ils->num_islands : 1;
+
+    Island* islands = (Island*)calloc(num_islands, sizeof(Island));
+    Mailbox* mailboxes = (Mailbox*)calloc(num_islands, sizeof(Mailbox));
+    pthread_t* threads = (pthread_t*)malloc(num_islands * sizeof(pthread_t));
+    char* started = (char*)calloc(num_islands, sizeof(char));
+    Rng* streams = (Rng*)malloc(num_islands * sizeof(Rng));
+    if (!islands || !mailboxes || !threads || !started || !streams)
+    {
+        fprintf(stderr, "Error: Memory allocation failed in ILS_solve\n");
+        free(islands);
+        free(mailboxes);
+        free(threads);
+        free(started);
+        free(streams);
+        Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
+        return res;
+    }
+    // Per-island streams are split off the caller's generator
+    rng_split(streams, num_islands, rng_next(rng));
 
-    int* bestSolution = NULL;
-    int bestSolutionSize = 0;
-    int* worstSolution = NULL;
-    int worstSolutionSize = 0;
+    int alloc_failed = 0;
+    SeenSet* seen = NULL;
+    if (ils->seen_capacity > 0)
+    {
+        seen = seen_set_create((size_t)ils->seen_capacity);
+        if (!seen)
+            alloc_failed = 1;
+    }
+    for (int k = 0; k < num_islands; k++)
+    {
+        atomic_init(&mailboxes[k].state, MAILBOX_EMPTY);
+        mailboxes[k].solution = (int*)malloc(solution_size * sizeof(int));
+        if (!mailboxes[k].solution)
+            alloc_failed = 1;
+    }
 
-    // Initialize timer
+    // Initialize timer: all islands stop at the same wall-clock deadline
+    long long start_us = current_time_us();
+    long long deadline_us = start_us + (long long)ils->max_time_ms * 1000;
 
+    for (int k = 0; k < num_islands; k++)
+    {
+        Island* island = &islands[k];
+        island->ils = ils;
+        island->distances = distances;
+        island->costs = costs;
+        island->num_nodes = num_nodes;
+        island->solution_size = solution_size;
+        island->deadline_us = deadline_us;
+        island->inbox = &mailboxes[k];
+        island->outbox = &mailboxes[(k + 1) % num_islands];
+        island->seen = seen;
+        island->rng = streams[k];
+        island->bestCost = INT_MAX;
+        island->worstCost = INT_MIN;
+        island->start_us = start_us;
+        if (ils->trace && !trace_init(&island->trace, ils->trace->capacity))
+            alloc_failed = 1;
+
+        island->all_nodes = (int*)malloc(num_nodes * sizeof(int));
+        island->current_solution = (int*)malloc(solution_size * sizeof(int));
+        island->candidate = (int*)malloc(solution_size * sizeof(int));
+        island->bestSolution = (int*)malloc(solution_size * sizeof(int));
+        island->worstSolution = (int*)malloc(solution_size * sizeof(int));
+        if (!arena_init(&island->scratch, delta_local_search_scratch_size(num_nodes)))
+            alloc_failed = 1;
+        if (!island->all_nodes || !island->current_solution || !island->candidate ||
+            !island->bestSolution || !island->worstSolution)
+            alloc_failed = 1;
+    }
+    free(streams);
 
-    for (int iter = 0; iter < 20; iter++) {
-        // Generate initial random solution
-        int* current_solution = (int*)malloc(solution_size * sizeof(int));
-        if (!current_solution)
+    if (!alloc_failed)
+    {
+        for (int k = 0; k < num_islands; k++)
         {
-            fprintf(stderr, "Error: Memory allocation failed in ILS_solve\n");
-            Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-            return res;
+            if (pthread_create(&threads[k], NULL, island_run, &islands[k]) == 0)
+            {
+                started[k] = 1;
+            }
+            else
+            {
+                // Could not spawn a thread: run the chain on the calling thread
+                island_run(&islands[k]);
+            }
         }
-
-        int* all_nodes = (int*)malloc(num_nodes * sizeof(int));
-        if (!all_nodes)
+        for (int k = 0; k < num_islands; k++)
         {
-            fprintf(stderr, "Error: Memory allocation failed in ILS_solve\n");
-            free(current_solution);
-            Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-            return res;
+            if (started[k])
+                pthread_join(threads[k], NULL);
         }
+    }
+    else
+    {
+        fprintf(stderr, "Error: Memory allocation failed in ILS_solve\n");
+    }
+
+    // Reduce island statistics in island order
+    int bestCost = INT_MAX;
+    int worstCost = INT_MIN;
+    long long totalCost = 0;
+    int iterations = 0;
+    int abandoned = 0;
+    int bestIsland = -1;
+    int worstIsland = -1;
 
-        for (int i = 0; i < num_nodes; i++)
+    for (int k = 0; k < num_islands && !alloc_failed; k++)
+    {
+        if (islands[k].failed)
         {
-            all_nodes[i] = i;
+            fprintf(stderr, "Error: Local search failed in ILS_solve\n");
         }
-
-        shuffle_array(all_nodes, num_nodes);
-        memcpy(current_solution, all_nodes, solution_size * sizeof(int));
-        free(all_nodes);
-
-        
-        // Perform initial local search
-        Result local_res = perform_local_search(current_solution, solution_size, distances, costs, num_nodes);
-        iterations++;
-
-        // Update best and worst
-        totalCost += local_res.bestCost;
-        if (local_res.bestCost < bestCost)
+        totalCost += islands[k].totalCost;
+        iterations += islands[k].iterations;
+        abandoned += islands[k].abandoned;
+        instr_merge(&islands[k].counters);
+        if (islands[k].iterations > 0 && islands[k].bestCost < bestCost)
         {
-            bestCost = local_res.bestCost;
-            if (bestSolution)
-                free(bestSolution);
-            bestSolution = (int*)malloc(solution_size * sizeof(int));
-            if (bestSolution)
-            {
-                memcpy(bestSolution, local_res.bestSolution, solution_size * sizeof(int));
-                bestSolutionSize = solution_size;
-            }
+            bestCost = islands[k].bestCost;
+            bestIsland = k;
         }
-        if (local_res.bestCost > worstCost)
+        if (islands[k].iterations > 0 && islands[k].worstCost > worstCost)
         {
-            worstCost = local_res.bestCost;
-            if (worstSolution)
-                free(worstSolution);
-            worstSolution = (int*)malloc(solution_size * sizeof(int));
-            if (worstSolution)
-            {
-                memcpy(worstSolution, local_res.worstSolution, solution_size * sizeof(int));
-                worstSolutionSize = solution_size;
-            }
+            worstCost = islands[k].worstCost;
+            worstIsland = k;
         }
+    }
 
-        free(local_res.bestSolution);
-        free(local_res.worstSolution);
+    if (ils->trace && !alloc_failed)
+        merge_island_traces(ils->trace, islands, num_islands);
 
-        long long start_time = current_time_ms();
-        long long end_time = start_time + ils->max_time_ms;
+    int* bestSolution = NULL;
+    int bestSolutionSize = 0;
+    int* worstSolution = NULL;
+    int worstSolutionSize = 0;
+    if (bestIsland >= 0)
+    {
+        bestSolution = islands[bestIsland].bestSolution;
+        bestSolutionSize = solution_size;
+        islands[bestIsland].bestSolution = NULL;
+    }
+    if (worstIsland >= 0)
+    {
+        worstSolution = islands[worstIsland].worstSolution;
+        worstSolutionSize = solution_size;
+        islands[worstIsland].worstSolution = NULL;
+    }
 
-        // Iteratively perform perturbation and local search
-        while (current_time_ms() < end_time)
+    for (int k = 0; k < num_islands; k++)
+    {
+        free_island(&islands[k]);
+        free(mailboxes[k].solution);
+    }
+    free(islands);
+    free(mailboxes);
+    free(threads);
+    free(started);
+    seen_set_destroy(seen);
+
+    // Abandoned descents have no cost of their own
+    int completed = iterations - abandoned;
+    double averageCost = (completed > 0) ? ((double)totalCost / completed) : 0.0;
+    ils->last_iterations = iterations;
+    ils->last_abandoned = abandoned;
+    if (!ils->quiet)
+    {
+        printf("iterations: %d\n", iterations);
+        if (ils->seen_capacity > 0)
         {
-            // Perturb the current solution
-            perturb_solution(current_solution, solution_size, ils->perturbation_strength);
-            
-
-            // Perform local search on the perturbed solution
-            Result perturbed_res = perform_local_search(current_solution, solution_size, distances, costs, num_nodes);
-            iterations++;
-
-
-
-            // Update best and worst
-            totalCost += perturbed_res.bestCost;
-            if (perturbed_res.bestCost < bestCost)
-            {
-                bestCost = perturbed_res.bestCost;
-                if (bestSolution)
-                    free(bestSolution);
-                bestSolution = (int*)malloc(solution_size * sizeof(int));
-                if (bestSolution)
-                {
-                    memcpy(bestSolution, perturbed_res.bestSolution, solution_size * sizeof(int));
-                    bestSolutionSize = solution_size;
-                }
-            }
-            if (perturbed_res.bestCost > worstCost)
-            {
-                worstCost = perturbed_res.bestCost;
-                if (worstSolution)
-                    free(worstSolution);
-                worstSolution = (int*)malloc(solution_size * sizeof(int));
-                if (worstSolution)
-                {
-                    memcpy(worstSolution, perturbed_res.worstSolution, solution_size * sizeof(int));
-                    worstSolutionSize = solution_size;
-                }
-            }
-
-            free(perturbed_res.bestSolution);
-            free(perturbed_res.worstSolution);
+            printf("abandoned at seen tours: %d\n", abandoned);
         }
-        free(current_solution);
     }
-
-    double averageCost = (iterations > 0) ? ((double)totalCost / iterations) : 0.0;
-    printf("iterations: %d\n", iterations);
     Result res;
     res.bestCost = bestCost;
     res.worstCost = worstCost;
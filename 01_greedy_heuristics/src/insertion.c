@@ -0,0 +1,118 @@
+#include "insertion.h"
+#include <limits.h>
+
+// Cost of inserting node k between tail and its successor
+static int insertion_cost(const InsertionCache* cache, int tail, int k)
+{
+    int head = cache->next[tail];
+    return cache->distances[tail][k] + cache->distances[k][head] - cache->distances[tail][head] + cache->costs[k];
+}
+
+// Merges one edge into the two cheapest of node k; on a tie the entry found first is kept
+static void offer_edge(InsertionCache* cache, int k, int tail, int cost)
+{
+    if (cost < cache->best_cost[k])
+    {
+        cache->second_cost[k] = cache->best_cost[k];
+        cache->second_edge[k] = cache->best_edge[k];
+        cache->best_cost[k] = cost;
+        cache->best_edge[k] = tail;
+    }
+    else if (cost < cache->second_cost[k])
+    {
+        cache->second_cost[k] = cost;
+        cache->second_edge[k] = tail;
+    }
+}
+
+static void rescan(InsertionCache* cache, int k)
+{
+    cache->best_cost[k] = INT_MAX;
+    cache->second_cost[k] = INT_MAX;
+    cache->best_edge[k] = -1;
+    cache->second_edge[k] = -1;
+    int tail = cache->head;
+    do
+    {
+        offer_edge(cache, k, tail, insertion_cost(cache, tail, k));
+        tail = cache->next[tail];
+    } while (tail != cache->head);
+}
+
+size_t insertion_scratch_size(int num_nodes)
+{
+    return num_nodes * (5 * sizeof(int) + sizeof(char)) + 6 * ARENA_ALIGNMENT;
+}
+
+int insertion_init(InsertionCache* cache, const int** distances, const int* costs, int num_nodes, int first, int second, Arena* scratch)
+{
+    cache->distances = distances;
+    cache->costs = costs;
+    cache->num_nodes = num_nodes;
+    cache->next = (int*)arena_alloc(scratch, num_nodes * sizeof(int));
+    cache->in_cycle = (char*)arena_calloc(scratch, num_nodes, sizeof(char));
+    cache->best_cost = (int*)arena_alloc(scratch, num_nodes * sizeof(int));
+    cache->best_edge = (int*)arena_alloc(scratch, num_nodes * sizeof(int));
+    cache->second_cost = (int*)arena_alloc(scratch, num_nodes * sizeof(int));
+    cache->second_edge = (int*)arena_alloc(scratch, num_nodes * sizeof(int));
+    if (!cache->next || !cache->in_cycle || !cache->best_cost || !cache->best_edge ||
+        !cache->second_cost || !cache->second_edge)
+    {
+        return 0;
+    }
+
+    cache->size = 2;
+    cache->head = first;
+    cache->next[first] = second;
+    cache->next[second] = first;
+    cache->in_cycle[first] = 1;
+    cache->in_cycle[second] = 1;
+
+    for (int k = 0; k < num_nodes; k++)
+    {
+        if (!cache->in_cycle[k])
+        {
+            rescan(cache, k);
+        }
+    }
+    return 1;
+}
+
+void insertion_insert(InsertionCache* cache, int node)
+{
+    int tail = cache->best_edge[node];
+    int head = cache->next[tail];
+    cache->next[tail] = node;
+    cache->next[node] = head;
+    cache->in_cycle[node] = 1;
+    cache->size++;
+
+    // Edge (tail, head) is replaced by (tail, node) and (node, head)
+    for (int k = 0; k < cache->num_nodes; k++)
+    {
+        if (cache->in_cycle[k])
+        {
+            continue;
+        }
+        if (cache->best_edge[k] == tail || cache->second_edge[k] == tail)
+        {
+            // The third cheapest edge is unknown, so the node is scanned again
+            rescan(cache, k);
+        }
+        else
+        {
+            offer_edge(cache, k, tail, insertion_cost(cache, tail, k));
+            offer_edge(cache, k, node, insertion_cost(cache, node, k));
+        }
+    }
+}
+
+void insertion_write_cycle(const InsertionCache* cache, int start, int* solution)
+{
+    int node = start;
+    for (int i = 0; i < cache->size; i++)
+    {
+        solution[i] = node;
+        node = cache->next[node];
+    }
+}
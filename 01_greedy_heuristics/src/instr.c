@@ -0,0 +1,47 @@
+#include "instr.h"
+#include <time.h>
+
+_Thread_local InstrCounters instr_counters;
+
+InstrCounters instr_take(void)
+{
+    InstrCounters counters = instr_counters;
+    InstrCounters empty = {0};
+    instr_counters = empty;
+    return counters;
+}
+
+void instr_merge(const InstrCounters* other)
+{
+    instr_counters.inter_route_evals += other->inter_route_evals;
+    instr_counters.intra_nodes_evals += other->intra_nodes_evals;
+    instr_counters.intra_edges_evals += other->intra_edges_evals;
+    instr_counters.applied_moves += other->applied_moves;
+    instr_counters.perturbation_ns += other->perturbation_ns;
+    instr_counters.local_search_ns += other->local_search_ns;
+    instr_counters.move_list_hits += other->move_list_hits;
+    instr_counters.move_list_stale += other->move_list_stale;
+    instr_counters.local_searches += other->local_searches;
+    instr_counters.descents_seen += other->descents_seen;
+}
+
+int64_t instr_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+void instr_print_json(FILE* out, const char* algorithm, const char* instance, const InstrCounters* counters)
+{
+    fprintf(out,
+            "{\"algorithm\": \"%s\", \"instance\": \"%s\", \"inter_route_evals\": %lld, \"intra_nodes_evals\": %lld, "
+            "\"intra_edges_evals\": %lld, \"applied_moves\": %lld, \"perturbation_ns\": %lld, \"local_search_ns\": %lld, "
+            "\"move_list_hits\": %lld, \"move_list_stale\": %lld, \"local_searches\": %lld, \"descents_seen\": %lld}\n",
+            algorithm, instance,
+            (long long)counters->inter_route_evals, (long long)counters->intra_nodes_evals,
+            (long long)counters->intra_edges_evals, (long long)counters->applied_moves,
+            (long long)counters->perturbation_ns, (long long)counters->local_search_ns,
+            (long long)counters->move_list_hits, (long long)counters->move_list_stale,
+            (long long)counters->local_searches, (long long)counters->descents_seen);
+}
@@ -1,5 +1,9 @@
 #include "local_search.h"
 #include "delta_local_search.h"
+#include "moves.h"
+#include "instr.h"
+#include "arena.h"
+#include "insertion.h"
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
@@ -14,15 +18,11 @@ typedef struct
 } Move;
 
 // Function prototypes
-static Result LocalSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions);
-static int delta_two_nodes_exchange(const int* solution, int solution_size, const int** distances, int i, int j);
-static int delta_two_edges_exchange(const int* solution, int solution_size, const int** distances, int i, int j);
-static int delta_inter_route_exchange(const int* solution, int solution_size, const int** distances, const int* costs, int i, int node_j);
+static Result LocalSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng);
 static void swap_nodes(int* solution, int i, int j);
-static void reverse_segment(int* solution, int start, int end, int solution_size);
 static int is_in_solution(int node, const int* solution, int solution_size);
-static void shuffle_moves(Move* moves, int n);
-static void generate_Greedy2Regret_solution(int start_node, const int **distances, int num_nodes, const int *costs, int solution_size, int *solution);
+static void shuffle_moves(Rng* rng, Move* moves, int n);
+static int generate_Greedy2Regret_solution(int start_node, const int **distances, int num_nodes, const int *costs, int solution_size, int *solution, Arena *scratch);
 
 // Function to create a LocalSearch algorithm
 LocalSearch* create_LocalSearch(int local_search_type, int intra_route_move_type, int starting_solution_type, int method_index)
@@ -57,20 +57,33 @@ LocalSearch* create_LocalSearch(int local_search_type, int intra_route_move_type
 }
 
 // LocalSearch solve function
-static Result LocalSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions)
+static Result LocalSearch_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng)
 {
     LocalSearch* ls = (LocalSearch*)algo;
     int solution_size = (num_nodes + 1) / 2; // Round up to select 50% of the nodes
 
     int total_iterations = num_nodes * num_solutions;
-    int bestCost = INT_MAX;
-    int worstCost = INT_MIN;
     long long totalCost = 0;
+    int max_moves = (solution_size * (solution_size - 1)) / 2 + solution_size * (num_nodes - solution_size);
 
-    int* bestSolution = NULL;
-    int bestSolutionSize = 0;
-    int* worstSolution = NULL;
-    int worstSolutionSize = 0;
+    // Scratch of one run (solution, shuffled nodes, greedy move list), reset before each run
+    Arena scratch;
+    Result res;
+    size_t scratch_size = solution_size * sizeof(int) + num_nodes * sizeof(int) + 3 * ARENA_ALIGNMENT;
+    if (ls->starting_solution_type == 1)
+    {
+        scratch_size += insertion_scratch_size(num_nodes);
+    }
+    if (ls->local_search_type == 1)
+    {
+        scratch_size += max_moves * sizeof(Move);
+    }
+    if (!arena_init(&scratch, scratch_size) || !result_init(&res, solution_size))
+    {
+        fprintf(stderr, "Error: Memory allocation failed in LocalSearch_solve\n");
+        arena_destroy(&scratch);
+        return result_failed();
+    }
 
     // Loop over all starting nodes
     for (int start_node = 0; start_node < num_nodes; start_node++)
@@ -79,43 +92,53 @@ static Result LocalSearch_solve(Algo *algo, const int **distances, int num_nodes
         for (int iter = 0; iter < num_solutions; iter++)
         {
             // Generate initial solution
-            int* current_solution = (int*)malloc(solution_size * sizeof(int));
-            if (!current_solution)
+            arena_reset(&scratch);
+            int* current_solution = (int*)arena_alloc(&scratch, solution_size * sizeof(int));
+            // The greedy move list has the same size in every step, so it is allocated once per run
+            Move* moves = ls->local_search_type == 1 ? (Move*)arena_alloc(&scratch, max_moves * sizeof(Move)) : NULL;
+            if (!current_solution || (ls->local_search_type == 1 && !moves))
             {
                 fprintf(stderr, "Error: Memory allocation failed in LocalSearch_solve\n");
-                Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-                return res;
+                arena_destroy(&scratch);
+                free_Result(res);
+                return result_failed();
             }
 
             if (ls->starting_solution_type == 0)
             {
                 // Random starting solution
-                int* all_nodes = (int*)malloc(num_nodes * sizeof(int));
+                int* all_nodes = (int*)arena_alloc(&scratch, num_nodes * sizeof(int));
                 if (!all_nodes)
                 {
                     fprintf(stderr, "Error: Memory allocation failed in LocalSearch_solve\n");
-                    free(current_solution);
-                    Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-                    return res;
+                    arena_destroy(&scratch);
+                    free_Result(res);
+                    return result_failed();
                 }
                 for (int i = 0; i < num_nodes; i++)
                 {
                     all_nodes[i] = i;
                 }
                 // Shuffle and select first solution_size nodes
-                shuffle_array(all_nodes, num_nodes);
+                rng_shuffle(rng, all_nodes, num_nodes);
                 memcpy(current_solution, all_nodes, solution_size * sizeof(int));
-                free(all_nodes);
             }
             else if (ls->starting_solution_type == 1)
             {
                 // Greedy heuristic starting solution (Weighted Greedy 2-Regret)
-                generate_Greedy2Regret_solution(start_node, distances, num_nodes, costs, solution_size, current_solution);
+                if (!generate_Greedy2Regret_solution(start_node, distances, num_nodes, costs, solution_size, current_solution, &scratch))
+                {
+                    fprintf(stderr, "Error: Memory allocation failed in LocalSearch_solve\n");
+                    arena_destroy(&scratch);
+                    free_Result(res);
+                    return result_failed();
+                }
             }
 
             // Perform local search on current_solution
             int current_cost = calculate_cost(current_solution, solution_size, distances, costs);
 
+            INSTR_PHASE_BEGIN(descent);
             int improvement = 1;
             while (improvement)
             {
@@ -208,6 +231,7 @@ static Result LocalSearch_solve(Algo *algo, const int **distances, int num_nodes
                             current_solution[move_i] = move_j;
                         }
                         current_cost += best_delta;
+                        INSTR_COUNT(applied_moves, 1);
                         improvement = 1;
                     }
                 }
@@ -215,18 +239,6 @@ static Result LocalSearch_solve(Algo *algo, const int **distances, int num_nodes
                 {
                     // Generate list of moves and shuffle
                     int num_moves = 0;
-                    Move* moves = NULL;
-                    int max_moves = (solution_size * (solution_size - 1)) / 2 + solution_size * (num_nodes - solution_size);
-
-                    moves = (Move*)malloc(max_moves * sizeof(Move));
-                    if (!moves)
-                    {
-                        fprintf(stderr, "Error: Memory allocation failed in LocalSearch_solve\n");
-                        free(current_solution);
-                        Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-                        return res;
-                    }
-
                     int k = 0;
                     if (ls->intra_route_move_type == 0)
                     {
@@ -274,7 +286,7 @@ static Result LocalSearch_solve(Algo *algo, const int **distances, int num_nodes
                         }
                     }
                     num_moves = k;
-                    shuffle_moves(moves, num_moves);
+                    shuffle_moves(rng, moves, num_moves);
 
                     for (int m = 0; m < num_moves; m++)
                     {
@@ -318,54 +330,24 @@ static Result LocalSearch_solve(Algo *algo, const int **distances, int num_nodes
                                 current_solution[moves[m].i] = moves[m].j;
                             }
                             current_cost += delta;
+                            INSTR_COUNT(applied_moves, 1);
                             improvement = 1;
                             break;
                         }
                     }
-                    free(moves);
                 }
             }
 
+            INSTR_PHASE_END(descent, local_search_ns);
+
             // Update best, worst, total cost
             totalCost += current_cost;
-            if (current_cost < bestCost)
-            {
-                bestCost = current_cost;
-                if (bestSolution)
-                    free(bestSolution);
-                bestSolution = (int*)malloc(solution_size * sizeof(int));
-                if (bestSolution)
-                {
-                    memcpy(bestSolution, current_solution, solution_size * sizeof(int));
-                    bestSolutionSize = solution_size;
-                }
-            }
-            if (current_cost > worstCost)
-            {
-                worstCost = current_cost;
-                if (worstSolution)
-                    free(worstSolution);
-                worstSolution = (int*)malloc(solution_size * sizeof(int));
-                if (worstSolution)
-                {
-                    memcpy(worstSolution, current_solution, solution_size * sizeof(int));
-                    worstSolutionSize = solution_size;
-                }
-            }
-            free(current_solution);
+            result_record(&res, current_solution, solution_size, current_cost);
         }
     }
 
-    double averageCost = (total_iterations > 0) ? ((double)totalCost / total_iterations) : 0.0;
-
-    Result res;
-    res.bestCost = bestCost;
-    res.worstCost = worstCost;
-    res.averageCost = averageCost;
-    res.bestSolution = bestSolution;
-    res.bestSolutionSize = bestSolutionSize;
-    res.worstSolution = worstSolution;
-    res.worstSolutionSize = worstSolutionSize;
+    arena_destroy(&scratch);
+    result_finish(&res, totalCost, total_iterations);
 
     return res;
 }
@@ -373,125 +355,6 @@ static Result LocalSearch_solve(Algo *algo, const int **distances, int num_nodes
 
 // Helper functions implementation
 
-static int delta_two_nodes_exchange(const int* solution, int solution_size, const int** distances, int i, int j)
-{
-    int delta = 0;
-    int size = solution_size;
-
-    int prev_i = (i == 0) ? size - 1 : i - 1;
-    int next_i = (i + 1) % size;
-    int prev_j = (j == 0) ? size - 1 : j - 1;
-    int next_j = (j + 1) % size;
-
-    int node_i = solution[i];
-    int node_j = solution[j];
-
-    if (j == next_i)
-    {
-        // Nodes are adjacent (i before j)
-        delta -= distances[solution[prev_i]][node_i];
-        delta -= distances[node_i][node_j];
-        delta -= distances[node_j][solution[next_j]];
-        delta += distances[solution[prev_i]][node_j];
-        delta += distances[node_j][node_i];
-        delta += distances[node_i][solution[next_j]];
-    }
-    else if (i == next_j)
-    {
-        // Nodes are adjacent (j before i)
-        delta -= distances[solution[prev_j]][node_j];
-        delta -= distances[node_j][node_i];
-        delta -= distances[node_i][solution[next_i]];
-        delta += distances[solution[prev_j]][node_i];
-        delta += distances[node_i][node_j];
-        delta += distances[node_j][solution[next_i]];
-    }
-    else
-    {
-        // Nodes are not adjacent
-        delta -= distances[solution[prev_i]][node_i];
-        delta -= distances[node_i][solution[next_i]];
-        delta -= distances[solution[prev_j]][node_j];
-        delta -= distances[node_j][solution[next_j]];
-        delta += distances[solution[prev_i]][node_j];
-        delta += distances[node_j][solution[next_i]];
-        delta += distances[solution[prev_j]][node_i];
-        delta += distances[node_i][solution[next_j]];
-    }
-
-    return delta;
-}
-
-static int delta_two_edges_exchange(const int* solution, int solution_size, const int** distances, int i, int j)
-{
-    int size = solution_size;
-
-    int node_i = solution[i];
-    int node_ip1 = solution[(i + 1) % size];
-    int node_j = solution[j];
-    int node_jp1 = solution[(j + 1) % size];
-
-    if (i == j)
-    {
-        return 0;
-    }
-
-    // Avoid swapping the same edge or adjacent edges that would create loops
-    if ((i + 1) % size == j || (j + 1) % size == i)
-    {
-        return 0;
-    }
-
-    int delta = 0;
-
-    delta -= distances[node_i][node_ip1];
-    delta -= distances[node_j][node_jp1];
-    delta += distances[node_i][node_j];
-    delta += distances[node_ip1][node_jp1];
-
-    return delta;
-}
-
-static void reverse_segment(int* solution, int start, int end, int solution_size)
-{
-    int size = solution_size;
-    int i = start;
-    int j = end;
-
-    while (i != j && (i + size - 1) % size != j)
-    {
-        int temp = solution[i];
-        solution[i] = solution[j];
-        solution[j] = temp;
-
-        i = (i + 1) % size;
-        if (j == 0)
-            j = size - 1;
-        else
-            j = j - 1;
-    }
-}
-
-static int delta_inter_route_exchange(const int* solution, int solution_size, const int** distances, const int* costs, int i, int node_j)
-{
-    int size = solution_size;
-    int node_i = solution[i];
-    int prev_i = (i == 0) ? size - 1 : i - 1;
-    int next_i = (i + 1) % size;
-
-    int delta = 0;
-
-    delta -= distances[solution[prev_i]][node_i];
-    delta -= distances[node_i][solution[next_i]];
-    delta += distances[solution[prev_i]][node_j];
-    delta += distances[node_j][solution[next_i]];
-
-    delta -= costs[node_i];
-    delta += costs[node_j];
-
-    return delta;
-}
-
 static void swap_nodes(int* solution, int i, int j)
 {
     int temp = solution[i];
@@ -509,11 +372,11 @@ static int is_in_solution(int node, const int* solution, int solution_size)
     return 0;
 }
 
-static void shuffle_moves(Move* moves, int n)
+static void shuffle_moves(Rng* rng, Move* moves, int n)
 {
     for (int i = n - 1; i > 0; i--)
     {
-        int j = rand() % (i + 1);
+        int j = (int)rng_bounded(rng, (uint32_t)(i + 1));
         Move temp = moves[i];
         moves[i] = moves[j];
         moves[j] = temp;
@@ -521,33 +384,20 @@ static void shuffle_moves(Move* moves, int n)
 }
 
 // Function to generate a single Greedy 2-Regret solution starting from a given node
-// This version uses weights for regret and cost increase
-static void generate_Greedy2Regret_solution(int start_node, const int **distances, int num_nodes, const int *costs, int solution_size, int *solution)
+// This version uses weights for regret and cost increase; the insertion cache comes from scratch
+// Returns 0 if scratch could not provide it
+static int generate_Greedy2Regret_solution(int start_node, const int **distances, int num_nodes, const int *costs, int solution_size, int *solution, Arena *scratch)
 {
     // Set default weights
     double weight1 = 0.6; // Weight for regret
     double weight2 = 0.4; // Weight for cost increase
 
-    int current_size = 0;
-    char *visited = (char *)calloc(num_nodes, sizeof(char));
-    if (!visited)
-    {
-        fprintf(stderr, "Error: Memory allocation failed in generate_Greedy2Regret_solution (visited)\n");
-        exit(EXIT_FAILURE);
-    }
-
-    int *current_solution = solution;
-
-    // Start with start_node
-    current_solution[current_size++] = start_node;
-    visited[start_node] = 1;
-
     // Find the farthest node to start forming a cycle
     int max_distance = -1;
     int farthest_node = -1;
     for (int j = 0; j < num_nodes; j++)
     {
-        if (!visited[j])
+        if (j != start_node)
         {
             int distance = distances[start_node][j];
             if (distance > max_distance)
@@ -560,54 +410,31 @@ static void generate_Greedy2Regret_solution(int start_node, const int **distance
 
     if (farthest_node == -1)
     {
-        free(visited);
-        return;
+        solution[0] = start_node;
+        return 1;
     }
 
-    current_solution[current_size++] = farthest_node;
-    visited[farthest_node] = 1;
+    InsertionCache cycle;
+    if (!insertion_init(&cycle, distances, costs, num_nodes, start_node, farthest_node, scratch))
+    {
+        return 0;
+    }
 
     // Build the solution
-    while (current_size < solution_size)
+    while (cycle.size < solution_size)
     {
         double max_score = -1e9;
         int candidate_node = -1;
-        int candidate_position = -1;
 
         // Iterate over all unvisited nodes
         for (int k = 0; k < num_nodes; k++)
         {
-            if (visited[k])
+            if (cycle.in_cycle[k])
                 continue;
 
-            // For node k, compute insertion costs at all possible positions
-            int smallest_cost = INT_MAX;
-            int second_smallest_cost = INT_MAX;
-            int best_pos = -1;
-
-            for (int j = 0; j < current_size; j++)
-            {
-                int prev = current_solution[j];
-                int next = current_solution[(j + 1) % current_size];
-                int insertion_cost = distances[prev][k] + distances[k][next] - distances[prev][next] + costs[k];
-
-                if (insertion_cost < smallest_cost)
-                {
-                    second_smallest_cost = smallest_cost;
-                    smallest_cost = insertion_cost;
-                    best_pos = (j + 1) % (current_size + 1);
-                }
-                else if (insertion_cost < second_smallest_cost)
-                {
-                    second_smallest_cost = insertion_cost;
-                }
-            }
-
-            // Handle case where only one insertion position is possible
-            if (second_smallest_cost == INT_MAX)
-            {
-                second_smallest_cost = smallest_cost;
-            }
+            // Cheapest and second-cheapest insertion of node k, kept up to date by the cycle
+            int smallest_cost = cycle.best_cost[k];
+            int second_smallest_cost = cycle.second_cost[k];
 
             // Compute regret
             int regret = second_smallest_cost - smallest_cost;
@@ -619,7 +446,6 @@ static void generate_Greedy2Regret_solution(int start_node, const int **distance
             {
                 max_score = score;
                 candidate_node = k;
-                candidate_position = best_pos;
             }
         }
 
@@ -628,17 +454,12 @@ static void generate_Greedy2Regret_solution(int start_node, const int **distance
             break;
         }
 
-        // Insert candidate_node at candidate_position
-        for (int m = current_size; m > candidate_position; m--)
-        {
-            current_solution[m] = current_solution[m - 1];
-        }
-        current_solution[candidate_position] = candidate_node;
-        current_size++;
-        visited[candidate_node] = 1;
+        // Insert candidate_node into its cheapest edge
+        insertion_insert(&cycle, candidate_node);
     }
 
-    free(visited);
+    insertion_write_cycle(&cycle, start_node, solution);
+    return 1;
 }
 
 // Result perform_local_search(int* current_solution, int solution_size, const int** distances, const int* costs, int num_nodes)
@@ -662,24 +483,11 @@ static void generate_Greedy2Regret_solution(int start_node, const int **distance
 //     return res;
 // }
 
-// main.c or relevant file
-Result perform_local_search(int* current_solution, int solution_size, const int** distances, const int* costs, int num_nodes)
+// Improves solution in place with the delta local search and returns its cost
+int perform_local_search(int* solution, int solution_size, const int** distances, const int* costs, int num_nodes, Arena* scratch, Deadline* deadline, SeenSet* seen)
 {
-    // Create a temporary DeltaLocalSearch instance with the current solution
-    DeltaLocalSearch* dls = create_DeltaLocalSearch(0, current_solution, solution_size);
-    if (!dls)
-    {
-        fprintf(stderr, "Error: Failed to create DeltaLocalSearch for local search\n");
-        Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-        return res;
-    }
-
-    // Perform local search with 1 solution (the provided current_solution)
-    Result res = dls->base.solve((Algo*)dls, distances, num_nodes, costs, 1);
+    INSTR_COUNT(local_searches, 1);
 
-    // Free the DeltaLocalSearch instance
-    free(dls->base.name);
-    free(dls);
-
-    return res;
+    arena_reset(scratch);
+    return delta_local_search_run(solution, solution_size, distances, costs, num_nodes, scratch, deadline, seen);
 }
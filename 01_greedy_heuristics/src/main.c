@@ -8,7 +8,38 @@
 #include "delta_local_search.h"
 #include "msls.h"        // Include MSLS header
 #include "ils.h"         // Include ILS header
+#include "rng.h"
+#include "instr.h"
+#include "trace.h"
+#include "spatial_grid.h"
 #include <time.h>
+#include <getopt.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#define MAX_INSTANCES 64
+
+#define ALGO_DELTA 1
+#define ALGO_MSLS  2
+#define ALGO_ILS   4
+#define ALGO_NN_END      8
+#define ALGO_NN_ANYWHERE 16
+#define ALGO_ALL (ALGO_DELTA | ALGO_MSLS | ALGO_ILS | ALGO_NN_END | ALGO_NN_ANYWHERE)
+
+// Experiment configuration, filled from a config file and/or command-line flags
+typedef struct {
+    const char* instances[MAX_INSTANCES];
+    int num_instances;
+    int algorithms;         // Bitmask of ALGO_* flags
+    int iterations;         // DeltaLocalSearch starts and MSLS iterations
+    int time_ms;            // ILS time budget
+    int perturbation;       // ILS perturbation strength
+    int threads;            // MSLS worker threads, 0 for all processors
+    int islands;            // ILS islands, 0 for the default
+    int seen_tours;         // Tours ILS remembers to skip repeated descents, 0 disables
+    uint64_t seed;
+    const char* output_dir;
+} Options;
 
 // Function to calculate elapsed time in milliseconds
 double get_elapsed_time_ms(struct timespec start, struct timespec end) {
@@ -26,7 +57,7 @@ double get_elapsed_time_sec(struct timespec start, struct timespec end) {
 
 // Function to generate an initial solution
 // This example generates a random solution by selecting 'solution_size' unique nodes
-int* generate_initial_solution(int num_nodes, int solution_size) {
+int* generate_initial_solution(Rng* rng, int num_nodes, int solution_size) {
     if (solution_size > num_nodes) {
         fprintf(stderr, "Error: Solution size cannot exceed the number of nodes.\n");
         return NULL;
@@ -43,7 +74,7 @@ int* generate_initial_solution(int num_nodes, int solution_size) {
     }
 
     // Shuffle the array
-    shuffle_array(all_nodes, num_nodes);
+    rng_shuffle(rng, all_nodes, num_nodes);
 
     // Select the first 'solution_size' nodes as the initial solution
     int* initial_solution = (int*)malloc(solution_size * sizeof(int));
@@ -59,30 +90,270 @@ int* generate_initial_solution(int num_nodes, int solution_size) {
     return initial_solution;
 }
 
+static void print_usage(const char* program) {
+    printf("Usage: %s [options] [instance.csv ...]\n"
+           "  -i, --instances LIST    comma-separated instance files (default data/TSPA.csv,data/TSPB.csv)\n"
+           "  -a, --algorithm LIST    comma-separated subset of delta,msls,ils,nn-end,nn-anywhere or all\n"
+           "                          (default delta,msls,ils)\n"
+           "  -n, --iterations N      local search starts of delta and MSLS (default 200)\n"
+           "  -t, --time-ms N         ILS time budget in milliseconds (default 10000)\n"
+           "  -p, --perturbation N    ILS perturbation strength (default 5)\n"
+           "  -j, --threads N         MSLS threads, 0 for all processors (default 0)\n"
+           "      --islands N         ILS islands, 0 for the default (default 0)\n"
+           "      --seen-tours N      tours ILS remembers to skip repeated descents, 0 disables\n"
+           "                          (default 1048576)\n"
+           "  -s, --seed N            random seed (default current time)\n"
+           "  -o, --output-dir DIR    directory of result and trace files (default .)\n"
+           "  -c, --config FILE       read key=value lines using the long option names\n"
+           "  -h, --help              show this help\n", program);
+}
+
+// Copies of option strings live until the end of the program
+static char* keep_string(const char* value) {
+    char* copy = (char*)malloc(strlen(value) + 1);
+    if (!copy) {
+        fprintf(stderr, "Error: Memory allocation failed for option value\n");
+        exit(EXIT_FAILURE);
+    }
+    strcpy(copy, value);
+    return copy;
+}
+
+static int parse_int(const char* key, const char* value, int min_value, int* out) {
+    char* end;
+    errno = 0;
+    long parsed = strtol(value, &end, 10);
+    if (errno != 0 || *end != '\0' || end == value || parsed < min_value || parsed > INT_MAX) {
+        fprintf(stderr, "Error: Invalid value '%s' for %s\n", value, key);
+        return 0;
+    }
+    *out = (int)parsed;
+    return 1;
+}
+
+static int add_instances(Options* options, const char* list) {
+    char* copy = keep_string(list);
+    char* saveptr = NULL;
+    for (char* item = strtok_r(copy, ", \t", &saveptr); item; item = strtok_r(NULL, ", \t", &saveptr)) {
+        if (options->num_instances == MAX_INSTANCES) {
+            fprintf(stderr, "Error: At most %d instances are supported\n", MAX_INSTANCES);
+            return 0;
+        }
+        options->instances[options->num_instances++] = item;
+    }
+    return 1;
+}
+
+static int parse_algorithms(const char* list, int* out) {
+    char buffer[256];
+    strncpy(buffer, list, sizeof(buffer));
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    int algorithms = 0;
+    char* saveptr = NULL;
+    for (char* item = strtok_r(buffer, ", \t", &saveptr); item; item = strtok_r(NULL, ", \t", &saveptr)) {
+        if (strcmp(item, "delta") == 0) algorithms |= ALGO_DELTA;
+        else if (strcmp(item, "msls") == 0) algorithms |= ALGO_MSLS;
+        else if (strcmp(item, "ils") == 0) algorithms |= ALGO_ILS;
+        else if (strcmp(item, "nn-end") == 0) algorithms |= ALGO_NN_END;
+        else if (strcmp(item, "nn-anywhere") == 0) algorithms |= ALGO_NN_ANYWHERE;
+        else if (strcmp(item, "all") == 0) algorithms |= ALGO_ALL;
+        else {
+            fprintf(stderr, "Error: Unknown algorithm '%s'\n", item);
+            return 0;
+        }
+    }
+    *out = algorithms;
+    return algorithms != 0;
+}
+
+static int parse_config_file(Options* options, const char* filename);
+
+// Applies one option given by its long name; shared by the flags and the config file
+static int apply_option(Options* options, const char* key, const char* value) {
+    if (strcmp(key, "instances") == 0) return add_instances(options, value);
+    if (strcmp(key, "algorithm") == 0) return parse_algorithms(value, &options->algorithms);
+    if (strcmp(key, "iterations") == 0) return parse_int(key, value, 1, &options->iterations);
+    if (strcmp(key, "time-ms") == 0) return parse_int(key, value, 1, &options->time_ms);
+    if (strcmp(key, "perturbation") == 0) return parse_int(key, value, 0, &options->perturbation);
+    if (strcmp(key, "threads") == 0) return parse_int(key, value, 0, &options->threads);
+    if (strcmp(key, "islands") == 0) return parse_int(key, value, 0, &options->islands);
+    if (strcmp(key, "seen-tours") == 0) return parse_int(key, value, 0, &options->seen_tours);
+    if (strcmp(key, "seed") == 0) {
+        char* end;
+        errno = 0;
+        unsigned long long parsed = strtoull(value, &end, 10);
+        if (errno != 0 || *end != '\0' || end == value) {
+            fprintf(stderr, "Error: Invalid value '%s' for seed\n", value);
+            return 0;
+        }
+        options->seed = (uint64_t)parsed;
+        return 1;
+    }
+    if (strcmp(key, "output-dir") == 0) {
+        options->output_dir = keep_string(value);
+        return 1;
+    }
+    if (strcmp(key, "config") == 0) return parse_config_file(options, value);
+
+    fprintf(stderr, "Error: Unknown option '%s'\n", key);
+    return 0;
+}
+
+static int parse_config_file(Options* options, const char* filename) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file %s\n", filename);
+        return 0;
+    }
+
+    char line[1024];
+    int line_number = 0;
+    int ok = 1;
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        char* key = line + strspn(line, " \t");
+        if (*key == '\0' || *key == '#') {
+            continue;
+        }
+        char* separator = strchr(key, '=');
+        if (!separator) {
+            fprintf(stderr, "Error: Expected key=value in %s:%d\n", filename, line_number);
+            ok = 0;
+            break;
+        }
+        *separator = '\0';
+        char* value = separator + 1;
+        value += strspn(value, " \t");
+        for (char* end = separator - 1; end >= key && (*end == ' ' || *end == '\t'); end--) {
+            *end = '\0';
+        }
+        ok = apply_option(options, key, value);
+    }
+
+    fclose(file);
+    return ok;
+}
+
+// Returns 1 to run, 0 to exit successfully (help) and -1 on invalid arguments
+static int parse_options(Options* options, int argc, char* argv[]) {
+    static const struct option long_options[] = {
+        {"instances", required_argument, NULL, 'i'},
+        {"algorithm", required_argument, NULL, 'a'},
+        {"iterations", required_argument, NULL, 'n'},
+        {"time-ms", required_argument, NULL, 't'},
+        {"perturbation", required_argument, NULL, 'p'},
+        {"threads", required_argument, NULL, 'j'},
+        {"islands", required_argument, NULL, 'I'},
+        {"seen-tours", required_argument, NULL, 'S'},
+        {"seed", required_argument, NULL, 's'},
+        {"output-dir", required_argument, NULL, 'o'},
+        {"config", required_argument, NULL, 'c'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    int index = 0;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "i:a:n:t:p:j:s:o:c:h", long_options, &index)) != -1) {
+        if (opt == 'h') {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (opt == '?') {
+            print_usage(argv[0]);
+            return -1;
+        }
+        // Map the short option back to its long name
+        const char* key = NULL;
+        for (int k = 0; long_options[k].name; k++) {
+            if (long_options[k].val == opt) {
+                key = long_options[k].name;
+                break;
+            }
+        }
+        if (!key || !apply_option(options, key, optarg)) {
+            return -1;
+        }
+    }
+    for (int k = optind; k < argc; k++) {
+        if (!add_instances(options, argv[k])) {
+            return -1;
+        }
+    }
+
+    if (options->num_instances == 0) {
+        options->instances[options->num_instances++] = "data/TSPA.csv";
+        options->instances[options->num_instances++] = "data/TSPB.csv";
+    }
+    return 1;
+}
+
 int main(int argc, char* argv[]) {
-    // Initialize random seed
-    srand((unsigned int)time(NULL));
+    Options options = {
+        .num_instances = 0,
+        .algorithms = ALGO_DELTA | ALGO_MSLS | ALGO_ILS,
+        .iterations = 200,
+        .time_ms = 10000,
+        .perturbation = 5,
+        .threads = 0,
+        .islands = 0,
+        .seen_tours = 1 << 20,
+        .seed = (uint64_t)time(NULL),
+        .output_dir = "."
+    };
+    int status = parse_options(&options, argc, argv);
+    if (status <= 0) {
+        return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (mkdir(options.output_dir, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Error: Cannot create output directory %s\n", options.output_dir);
+        return EXIT_FAILURE;
+    }
+
+    // Initialize random generator; the seed is printed so that a run can be reproduced
+    Rng rng;
+    rng_seed(&rng, options.seed);
+    printf("Seed: %llu\n", (unsigned long long)options.seed);
 
     // Define the number of algorithms excluding DeltaLocalSearch
     int num_other_algorithms = 2; // MSLS and ILS
     Algo* algorithms[num_other_algorithms];
 
     // Initialize Multiple Start Local Search
-    algorithms[0] = (Algo*)create_MSLS(200); // 200 iterations as per requirement
+    MSLS* msls = create_MSLS(options.iterations);
+    if (msls && options.threads > 0) {
+        msls->num_threads = options.threads;
+    }
+    algorithms[0] = (Algo*)msls;
 
     // Initialize Iterated Local Search
-    // Assuming average running time of MSLS is approximated as 200 iterations
-    // Set max_time_ms accordingly, e.g., 200 * average time per iteration
-    // For simplicity, set a fixed time or adjust as needed
-    algorithms[1] = (Algo*)create_ILS(10000, 5); // 10 seconds and perturbation strength of 5
+    ILS* ils = create_ILS(options.time_ms, options.perturbation);
+    if (ils && options.islands > 0) {
+        ils->num_islands = options.islands;
+    }
+    if (ils) {
+        ils->seen_capacity = options.seen_tours;
+    }
+    algorithms[1] = (Algo*)ils;
+    if (!msls || !ils) {
+        return EXIT_FAILURE;
+    }
+
+    // Record the convergence of ILS to choose the smallest time budget reaching the plateau
+    Trace ils_trace;
+    if (trace_init(&ils_trace, 4096)) {
+        ils->trace = &ils_trace;
+    }
 
     // List of files to process
-    const char* files[] = {"data/TSPA.csv", "data/TSPB.csv"};
-    int num_files = sizeof(files) / sizeof(files[0]);
+    const char** files = options.instances;
+    int num_files = options.num_instances;
 
     // Number of solutions to generate per method
-    int num_solutions_delta = 200;    // For DeltaLocalSearch
-    int num_solutions_msls = 200;     // For MSLS
+    int num_solutions_delta = options.iterations;    // For DeltaLocalSearch
+    int num_solutions_msls = options.iterations;     // For MSLS
     // ILS uses time-based stopping condition
 
     // Loop over files
@@ -115,11 +386,23 @@ int main(int argc, char* argv[]) {
             costs[i] = data[i][2];
         }
 
+        // Spatial index of the instance, shared by both nearest-neighbour constructions
+        SpatialGrid grid;
+        if (!spatial_grid_build(&grid, data, num_nodes)) {
+            fprintf(stderr, "Error: Failed to build the spatial grid for file %s\n", files[f]);
+            spatial_grid_free(&grid);
+            free(costs);
+            free_data(data, num_nodes);
+            free_distances(distances, num_nodes);
+            continue;
+        }
+
         // Generate initial solution
         int solution_size = (num_nodes + 1) / 2; // Example: selecting 50% of the nodes
-        int* initial_solution = generate_initial_solution(num_nodes, solution_size);
+        int* initial_solution = generate_initial_solution(&rng, num_nodes, solution_size);
         if (!initial_solution) {
             fprintf(stderr, "Error: Failed to generate initial solution for file %s\n", files[f]);
+            spatial_grid_free(&grid);
             free(costs);
             free_data(data, num_nodes);
             free_distances(distances, num_nodes);
@@ -131,23 +414,38 @@ int main(int argc, char* argv[]) {
         if (!dls) {
             fprintf(stderr, "Error: Failed to create DeltaLocalSearch for file %s\n", files[f]);
             free(initial_solution);
+            spatial_grid_free(&grid);
             free(costs);
             free_data(data, num_nodes);
             free_distances(distances, num_nodes);
             continue;
         }
 
-        // Add DeltaLocalSearch to the list of algorithms for this iteration
+        // The nearest-neighbour constructions take the grid of this instance
+        NearestNeighboursEndInsert* nn_end = create_NearestNeighboursEndInsert(&grid);
+        NearestNeighboursAnywhereInsert* nn_anywhere = create_NearestNeighboursAnywhereInsert(&grid);
+
+        // Add DeltaLocalSearch and the constructions to the list of algorithms for this iteration
         // Since algorithms array was initially defined for other algorithms,
-        // we'll temporarily expand it to include DeltaLocalSearch
-        int current_num_algorithms = num_other_algorithms + 1;
+        // we'll temporarily expand it to include them
+        int current_num_algorithms = num_other_algorithms + 3;
         Algo* current_algorithms[current_num_algorithms];
         current_algorithms[0] = (Algo*)dls; // DeltaLocalSearch
         current_algorithms[1] = algorithms[0]; // MSLS
         current_algorithms[2] = algorithms[1]; // ILS
+        current_algorithms[3] = (Algo*)nn_end;
+        current_algorithms[4] = (Algo*)nn_anywhere;
 
         // Print algorithm and file information
+        const int algorithm_flags[] = {ALGO_DELTA, ALGO_MSLS, ALGO_ILS, ALGO_NN_END, ALGO_NN_ANYWHERE};
         for(int a = 0; a < current_num_algorithms; a++) {
+            if (!(options.algorithms & algorithm_flags[a])) {
+                continue;
+            }
+            if (!current_algorithms[a]) {
+                continue; // Its create function reported the failure
+            }
+
             // Print algorithm and file information
             printf("# Algorithm: %s\n", current_algorithms[a]->name);
             printf("## File: %s\n", files[f]);
@@ -161,6 +459,10 @@ int main(int argc, char* argv[]) {
                 // ILS uses time-based stopping condition, num_solutions can be set to 0 or ignored
                 num_solutions = 0;
             }
+            else if(algorithm_flags[a] == ALGO_NN_END || algorithm_flags[a] == ALGO_NN_ANYWHERE) {
+                // One construction from every start node
+                num_solutions = 1;
+            }
             else { // Assuming it's DeltaLocalSearch
                 num_solutions = num_solutions_delta;
             }
@@ -172,8 +474,9 @@ int main(int argc, char* argv[]) {
                 // Handle error, possibly continue without timing
             }
 
-            // Solve using the current algorithm
-            Result res = current_algorithms[a]->solve(current_algorithms[a], (const int**)distances, num_nodes, costs, num_solutions);
+            // Solve using the current algorithm, with clean instrumentation counters
+            instr_take();
+            Result res = current_algorithms[a]->solve(current_algorithms[a], (const int**)distances, num_nodes, costs, num_solutions, &rng);
 
             // End timing after the solve function
             if(clock_gettime(CLOCK_MONOTONIC, &end_time) != 0) {
@@ -187,7 +490,7 @@ int main(int argc, char* argv[]) {
 
             // Print and write results
             print_Result(res, (const int**)distances, costs);
-            char result_filename[256];
+            char result_filename[512];
 
             char base_name[256];
             const char* temp_base_filename = strrchr(files[f], '/');
@@ -207,19 +510,31 @@ int main(int argc, char* argv[]) {
                 *dot = '\0';
             }
 
-            snprintf(result_filename, sizeof(result_filename), "%s_%s_result.txt", current_algorithms[a]->name, base_name);
+            snprintf(result_filename, sizeof(result_filename), "%s/%s_%s_result.txt", options.output_dir, current_algorithms[a]->name, base_name);
             write_Result_to_file(res, result_filename, (const int**)distances, costs);
+            if(current_algorithms[a] == algorithms[1] && ils->trace) {
+                char trace_filename[512];
+                snprintf(trace_filename, sizeof(trace_filename), "%s/%s_%s_trace.csv", options.output_dir, current_algorithms[a]->name, base_name);
+                trace_write_csv(&ils_trace, trace_filename);
+            }
             printf("Time taken by %s on %s: %.3f ms (%.3f seconds)\n",
                    current_algorithms[a]->name, files[f], elapsed_ms, elapsed_sec);
+#ifdef INSTRUMENTATION
+            InstrCounters counters = instr_take();
+            instr_print_json(stdout, current_algorithms[a]->name, base_name, &counters);
+#endif
             printf("----------------------------------------\n");
 
             // Free allocated memory for the result
             free_Result(res);
         }
 
-        // Free the temporary DeltaLocalSearch instance
+        // Free the temporary DeltaLocalSearch instance and constructions
         free(dls->base.name);
         free(dls);
+        free(nn_end);
+        free(nn_anywhere);
+        spatial_grid_free(&grid);
 
         // Free initial_solution as it's copied inside DeltaLocalSearch
         free(initial_solution);
@@ -235,6 +550,7 @@ int main(int argc, char* argv[]) {
         free((void*)algorithms[i]->name);
         free(algorithms[i]);
     }
+    trace_free(&ils_trace);
 
     return 0;
 }
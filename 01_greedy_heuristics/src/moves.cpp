@@ -0,0 +1,36 @@
+// C entry points of the moves, compiled as C++ over the shared kernels of src/TourCore.h
+#include "moves.h"
+#include "utils.h"
+#include "instr.h"
+#include "TourCore.h"
+
+using LS::TourCore::ArrayTour;
+using LS::TourCore::RowDistances;
+
+int delta_two_nodes_exchange(const int* solution, int solution_size, const int** distances, int i, int j)
+{
+    INSTR_COUNT(intra_nodes_evals, 1);
+    return LS::TourCore::TwoNodes::delta(ArrayTour{solution, solution_size}, RowDistances{distances}, nullptr, i, j);
+}
+
+int delta_two_edges_exchange(const int* solution, int solution_size, const int** distances, int i, int j)
+{
+    INSTR_COUNT(intra_edges_evals, 1);
+    return LS::TourCore::TwoEdges::delta(ArrayTour{solution, solution_size}, RowDistances{distances}, nullptr, i, j);
+}
+
+int delta_inter_route_exchange(const int* solution, int solution_size, const int** distances, const int* costs, int i, int node_j)
+{
+    INSTR_COUNT(inter_route_evals, 1);
+    return LS::TourCore::InterRoute::delta(ArrayTour{solution, solution_size}, RowDistances{distances}, costs, i, node_j);
+}
+
+void reverse_segment(int* solution, int start, int end, int solution_size)
+{
+    LS::TourCore::reverseSegment(solution, solution_size, start, end);
+}
+
+int calculate_cost(const int* solution, int solution_size, const int** distances, const int* costs)
+{
+    return LS::TourCore::evaluate(ArrayTour{solution, solution_size}, RowDistances{distances}, costs);
+}
@@ -3,13 +3,44 @@
 #include <string.h>
 #include <limits.h>
 #include <stdio.h>
+#include <pthread.h>
 
 // Include necessary headers for local search
 #include "local_search.h"
+#include "delta_local_search.h"
 #include "utils.h"
+#include "rng.h"
+#include "instr.h"
+
+/**
+ * @brief Per-thread state of a parallel MSLS run.
+ * Scratch and result buffers are allocated once per thread, before the workers start.
+ */
+typedef struct {
+    const int** distances;
+    const int* costs;
+    int num_nodes;
+    int solution_size;
+    int first_iteration;   // Iterations first_iteration, first_iteration + stride, ...
+    int stride;
+    int total_iterations;
+    Rng rng;               // Private random stream of this thread
+
+    int* all_nodes;        // Scratch permutation of all nodes
+    int* current_solution; // Scratch starting solution, improved in place
+    Arena scratch;         // Scratch of the local search, reset by every descent
+
+    int bestCost;
+    int worstCost;
+    long long totalCost;
+    int* bestSolution;
+    int* worstSolution;
+    int failed;
+    InstrCounters counters; // Instrumentation gathered by this thread
+} MSLSWorker;
 
 // Forward declaration of the solve function
-static Result MSLS_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions);
+static Result MSLS_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng);
 
 /**
  * @brief Creates an instance of the MSLS algorithm.
@@ -38,102 +69,225 @@ MSLS* create_MSLS(int num_iterations)
     msls->base.name = name;
     msls->base.solve = MSLS_solve;
     msls->num_iterations = num_iterations;
+    msls->num_threads = available_threads();
 
     return msls;
 }
 
+/**
+ * @brief Releases the buffers owned by a worker.
+ */
+static void free_worker(MSLSWorker* worker)
+{
+    free(worker->all_nodes);
+    free(worker->current_solution);
+    free(worker->bestSolution);
+    free(worker->worstSolution);
+    arena_destroy(&worker->scratch);
+}
+
+/**
+ * @brief Thread entry point: runs this worker's share of the local searches.
+ * Only thread-private state is written, so no synchronization is needed until the join.
+ *
+ * @param arg Pointer to the MSLSWorker of this thread.
+ * @return NULL.
+ */
+static void* MSLS_worker_run(void* arg)
+{
+    MSLSWorker* worker = (MSLSWorker*)arg;
+    int solution_size = worker->solution_size;
+
+    for (int i = 0; i < worker->num_nodes; i++)
+    {
+        worker->all_nodes[i] = i;
+    }
+
+    for (int iter = worker->first_iteration; iter < worker->total_iterations; iter += worker->stride)
+    {
+        // Generate a random starting solution; reshuffling the previous permutation keeps it uniform
+        rng_shuffle(&worker->rng, worker->all_nodes, worker->num_nodes);
+        memcpy(worker->current_solution, worker->all_nodes, solution_size * sizeof(int));
+
+        // Perform local search on the current solution
+        int cost = perform_local_search(worker->current_solution, solution_size, worker->distances, worker->costs, worker->num_nodes, &worker->scratch, NULL, NULL);
+        if (cost == INT_MAX)
+        {
+            worker->failed = 1;
+            break;
+        }
+
+        // Update best, worst, and total costs
+        worker->totalCost += cost;
+        if (cost < worker->bestCost)
+        {
+            worker->bestCost = cost;
+            memcpy(worker->bestSolution, worker->current_solution, solution_size * sizeof(int));
+        }
+        if (cost > worker->worstCost)
+        {
+            worker->worstCost = cost;
+            memcpy(worker->worstSolution, worker->current_solution, solution_size * sizeof(int));
+        }
+    }
+
+    worker->counters = instr_take();
+    return NULL;
+}
+
 /**
  * @brief Performs the Multiple Start Local Search.
  * Executes multiple local search iterations starting from random solutions.
+ * Iterations are spread over msls->num_threads threads, each with its own random stream;
+ * per-thread results are reduced in thread order after the join, so a run is reproducible
+ * for a fixed rng state and thread count.
  *
  * @param algo Pointer to the MSLS algorithm instance.
  * @param distances 2D array of distances between nodes.
  * @param num_nodes Total number of nodes.
  * @param costs Array of node costs.
  * @param num_solutions Number of local search iterations to perform.
+ * @param rng Random generator the per-thread streams are derived from.
  * @return Result structure containing best, worst, and average costs.
  */
-static Result MSLS_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions)
+static Result MSLS_solve(Algo *algo, const int **distances, int num_nodes, const int *costs, int num_solutions, Rng *rng)
 {
     MSLS* msls = (MSLS*)algo;
     int solution_size = (num_nodes + 1) / 2; // Selecting approximately 50% of the nodes
 
     int total_iterations = num_solutions;
-    int bestCost = INT_MAX;
-    int worstCost = INT_MIN;
-    long long totalCost = 0;
+    int run_iterations = num_solutions * 20;
+    int num_threads = msls->num_threads > 0 ? msls->num_threads : 1;
+    if (num_threads > run_iterations)
+        num_threads = run_iterations > 0 ? run_iterations : 1;
 
-    int* bestSolution = NULL;
-    int bestSolutionSize = 0;
-    int* worstSolution = NULL;
-    int worstSolutionSize = 0;
+    MSLSWorker* workers = (MSLSWorker*)calloc(num_threads, sizeof(MSLSWorker));
+    pthread_t* threads = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
+    char* started = (char*)calloc(num_threads, sizeof(char));
+    Rng* streams = (Rng*)malloc(num_threads * sizeof(Rng));
+    if (!workers || !threads || !started || !streams)
+    {
+        fprintf(stderr, "Error: Memory allocation failed in MSLS_solve\n");
+        free(workers);
+        free(threads);
+        free(started);
+        free(streams);
+        Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
+        return res;
+    }
+    // Per-thread streams are split off the caller's generator
+    rng_split(streams, num_threads, rng_next(rng));
 
-    // Iterate for the specified number of solutions
-    for (int iter = 0; iter < num_solutions*20; iter++)
+    // Preallocate all per-thread buffers before any thread starts
+    int alloc_failed = 0;
+    for (int t = 0; t < num_threads; t++)
     {
-        // Generate a random starting solution
-        int* current_solution = (int*)malloc(solution_size * sizeof(int));
-        if (!current_solution)
+        MSLSWorker* worker = &workers[t];
+        worker->distances = distances;
+        worker->costs = costs;
+        worker->num_nodes = num_nodes;
+        worker->solution_size = solution_size;
+        worker->first_iteration = t;
+        worker->stride = num_threads;
+        worker->total_iterations = run_iterations;
+        worker->rng = streams[t];
+        worker->bestCost = INT_MAX;
+        worker->worstCost = INT_MIN;
+        worker->totalCost = 0;
+
+        worker->all_nodes = (int*)malloc(num_nodes * sizeof(int));
+        worker->current_solution = (int*)malloc(solution_size * sizeof(int));
+        worker->bestSolution = (int*)malloc(solution_size * sizeof(int));
+        worker->worstSolution = (int*)malloc(solution_size * sizeof(int));
+        int scratch_ok = arena_init(&worker->scratch, delta_local_search_scratch_size(num_nodes));
+        if (!worker->all_nodes || !worker->current_solution || !worker->bestSolution || !worker->worstSolution || !scratch_ok)
         {
-            fprintf(stderr, "Error: Memory allocation failed in MSLS_solve\n");
-            Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-            return res;
+            alloc_failed = 1;
         }
+    }
+    free(streams);
 
-        int* all_nodes = (int*)malloc(num_nodes * sizeof(int));
-        if (!all_nodes)
+    if (alloc_failed)
+    {
+        fprintf(stderr, "Error: Memory allocation failed in MSLS_solve\n");
+        for (int t = 0; t < num_threads; t++)
+            free_worker(&workers[t]);
+        free(workers);
+        free(threads);
+        free(started);
+        Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
+        return res;
+    }
+
+    for (int t = 0; t < num_threads; t++)
+    {
+        if (pthread_create(&threads[t], NULL, MSLS_worker_run, &workers[t]) == 0)
         {
-            fprintf(stderr, "Error: Memory allocation failed in MSLS_solve\n");
-            free(current_solution);
-            Result res = {INT_MAX, INT_MIN, 0.0, NULL, 0, NULL, 0};
-            return res;
+            started[t] = 1;
         }
-
-        for (int i = 0; i < num_nodes; i++)
+        else
         {
-            all_nodes[i] = i;
+            // Could not spawn a thread: run its share on the calling thread
+            MSLS_worker_run(&workers[t]);
         }
+    }
+    for (int t = 0; t < num_threads; t++)
+    {
+        if (started[t])
+            pthread_join(threads[t], NULL);
+    }
 
-        shuffle_array(all_nodes, num_nodes);
-        memcpy(current_solution, all_nodes, solution_size * sizeof(int));
-        free(all_nodes);
-
-        // Perform local search on the current solution
-        Result local_res = perform_local_search(current_solution, solution_size, distances, costs, num_nodes);
+    // Reduce per-thread results in thread order
+    int bestCost = INT_MAX;
+    int worstCost = INT_MIN;
+    long long totalCost = 0;
+    int bestThread = -1;
+    int worstThread = -1;
 
-        // Update best, worst, and total costs
-        totalCost += local_res.bestCost;
-        if (local_res.bestCost < bestCost)
+    for (int t = 0; t < num_threads; t++)
+    {
+        if (workers[t].failed)
+        {
+            fprintf(stderr, "Error: Local search failed in MSLS_solve\n");
+        }
+        totalCost += workers[t].totalCost;
+        instr_merge(&workers[t].counters);
+        if (workers[t].bestCost < bestCost)
         {
-            bestCost = local_res.bestCost;
-            if (bestSolution)
-                free(bestSolution);
-            bestSolution = (int*)malloc(solution_size * sizeof(int));
-            if (bestSolution)
-            {
-                memcpy(bestSolution, local_res.bestSolution, solution_size * sizeof(int));
-                bestSolutionSize = solution_size;
-            }
+            bestCost = workers[t].bestCost;
+            bestThread = t;
         }
-        if (local_res.bestCost > worstCost)
+        if (workers[t].worstCost > worstCost)
         {
-            worstCost = local_res.bestCost;
-            if (worstSolution)
-                free(worstSolution);
-            worstSolution = (int*)malloc(solution_size * sizeof(int));
-            if (worstSolution)
-            {
-                memcpy(worstSolution, local_res.worstSolution, solution_size * sizeof(int));
-                worstSolutionSize = solution_size;
-            }
+            worstCost = workers[t].worstCost;
+            worstThread = t;
         }
+    }
 
-        // Free resources allocated for this iteration
-        free(current_solution);
-        free(local_res.bestSolution);
-        free(local_res.worstSolution);
+    // Hand the winning buffers over to the Result instead of copying them
+    int* bestSolution = NULL;
+    int bestSolutionSize = 0;
+    int* worstSolution = NULL;
+    int worstSolutionSize = 0;
+    if (bestThread >= 0)
+    {
+        bestSolution = workers[bestThread].bestSolution;
+        bestSolutionSize = solution_size;
+        workers[bestThread].bestSolution = NULL;
+    }
+    if (worstThread >= 0)
+    {
+        worstSolution = workers[worstThread].worstSolution;
+        worstSolutionSize = solution_size;
+        workers[worstThread].worstSolution = NULL;
     }
 
+    for (int t = 0; t < num_threads; t++)
+        free_worker(&workers[t]);
+    free(workers);
+    free(threads);
+    free(started);
+
     double averageCost = (total_iterations > 0) ? ((double)totalCost / total_iterations) : 0.0;
 
     Result res;
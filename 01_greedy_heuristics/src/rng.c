@@ -0,0 +1,106 @@
+#include "rng.h"
+
+static inline uint64_t rotl(const uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t splitmix64(uint64_t* state)
+{
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void rng_seed(Rng* rng, uint64_t seed)
+{
+    uint64_t state = seed;
+    for (int i = 0; i < 4; i++)
+    {
+        rng->s[i] = splitmix64(&state);
+    }
+}
+
+uint64_t rng_next(Rng* rng)
+{
+    uint64_t* s = rng->s;
+    const uint64_t result = rotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+uint32_t rng_bounded(Rng* rng, uint32_t bound)
+{
+    // Lemire's nearly divisionless method
+    uint64_t m = (uint64_t)(uint32_t)(rng_next(rng) >> 32) * bound;
+    uint32_t low = (uint32_t)m;
+    if (low < bound)
+    {
+        uint32_t threshold = -bound % bound;
+        while (low < threshold)
+        {
+            m = (uint64_t)(uint32_t)(rng_next(rng) >> 32) * bound;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+void rng_jump(Rng* rng)
+{
+    static const uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                     0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int b = 0; b < 64; b++)
+        {
+            if (JUMP[i] & ((uint64_t)1 << b))
+            {
+                s0 ^= rng->s[0];
+                s1 ^= rng->s[1];
+                s2 ^= rng->s[2];
+                s3 ^= rng->s[3];
+            }
+            rng_next(rng);
+        }
+    }
+
+    rng->s[0] = s0;
+    rng->s[1] = s1;
+    rng->s[2] = s2;
+    rng->s[3] = s3;
+}
+
+void rng_split(Rng* streams, int count, uint64_t seed)
+{
+    if (count <= 0) return;
+    rng_seed(&streams[0], seed);
+    for (int i = 1; i < count; i++)
+    {
+        streams[i] = streams[i - 1];
+        rng_jump(&streams[i]);
+    }
+}
+
+void rng_shuffle(Rng* rng, int* array, int n)
+{
+    for (int i = n - 1; i > 0; i--)
+    {
+        int j = (int)rng_bounded(rng, (uint32_t)(i + 1));
+        int temp = array[j];
+        array[j] = array[i];
+        array[i] = temp;
+    }
+}
@@ -0,0 +1,200 @@
+#include "spatial_grid.h"
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+int spatial_grid_build(SpatialGrid* grid, int** data, int num_nodes)
+{
+    memset(grid, 0, sizeof(*grid));
+    if (num_nodes <= 0)
+    {
+        return 0;
+    }
+    grid->num_nodes = num_nodes;
+
+    int min_x = INT_MAX, max_x = INT_MIN, min_y = INT_MAX, max_y = INT_MIN;
+    grid->min_cost = INT_MAX;
+    for (int i = 0; i < num_nodes; i++)
+    {
+        if (data[i][0] < min_x) min_x = data[i][0];
+        if (data[i][0] > max_x) max_x = data[i][0];
+        if (data[i][1] < min_y) min_y = data[i][1];
+        if (data[i][1] > max_y) max_y = data[i][1];
+        if (data[i][2] < grid->min_cost) grid->min_cost = data[i][2];
+    }
+    grid->min_x = min_x;
+    grid->min_y = min_y;
+
+    // About two nodes per cell on a uniform spread; a degenerate extent counts as width 1
+    double width = max_x > min_x ? (double)(max_x - min_x) : 1.0;
+    double height = max_y > min_y ? (double)(max_y - min_y) : 1.0;
+    int target_cells = num_nodes / 2 > 0 ? num_nodes / 2 : 1;
+    grid->cell_size = sqrt(width * height / target_cells);
+    if (grid->cell_size < 1.0)
+    {
+        grid->cell_size = 1.0;
+    }
+    grid->cells_x = (int)(width / grid->cell_size) + 1;
+    grid->cells_y = (int)(height / grid->cell_size) + 1;
+    int num_cells = grid->cells_x * grid->cells_y;
+
+    grid->xs = (int*)malloc(num_nodes * sizeof(int));
+    grid->ys = (int*)malloc(num_nodes * sizeof(int));
+    grid->cell_of = (int*)malloc(num_nodes * sizeof(int));
+    grid->cell_start = (int*)calloc(num_cells + 1, sizeof(int));
+    grid->cell_nodes = (int*)malloc(num_nodes * sizeof(int));
+    if (!grid->xs || !grid->ys || !grid->cell_of || !grid->cell_start || !grid->cell_nodes)
+    {
+        return 0;
+    }
+
+    // Counting sort of the nodes by cell
+    for (int i = 0; i < num_nodes; i++)
+    {
+        grid->xs[i] = data[i][0];
+        grid->ys[i] = data[i][1];
+        int cx = (int)((data[i][0] - min_x) / grid->cell_size);
+        int cy = (int)((data[i][1] - min_y) / grid->cell_size);
+        if (cx >= grid->cells_x) cx = grid->cells_x - 1;
+        if (cy >= grid->cells_y) cy = grid->cells_y - 1;
+        grid->cell_of[i] = cy * grid->cells_x + cx;
+        grid->cell_start[grid->cell_of[i] + 1]++;
+    }
+    for (int c = 0; c < num_cells; c++)
+    {
+        grid->cell_start[c + 1] += grid->cell_start[c];
+    }
+    int* fill = (int*)malloc(num_cells * sizeof(int));
+    if (!fill)
+    {
+        return 0;
+    }
+    memcpy(fill, grid->cell_start, num_cells * sizeof(int));
+    for (int i = 0; i < num_nodes; i++)
+    {
+        grid->cell_nodes[fill[grid->cell_of[i]]++] = i;
+    }
+    free(fill);
+    return 1;
+}
+
+void spatial_grid_free(SpatialGrid* grid)
+{
+    free(grid->xs);
+    free(grid->ys);
+    free(grid->cell_of);
+    free(grid->cell_start);
+    free(grid->cell_nodes);
+    memset(grid, 0, sizeof(*grid));
+}
+
+size_t spatial_view_scratch_size(const SpatialGrid* grid)
+{
+    return (grid->cells_x * grid->cells_y + 2 * grid->num_nodes) * sizeof(int) + 3 * ARENA_ALIGNMENT;
+}
+
+int spatial_view_init(SpatialView* view, const SpatialGrid* grid, Arena* scratch)
+{
+    int num_cells = grid->cells_x * grid->cells_y;
+    view->grid = grid;
+    view->cell_count = (int*)arena_alloc(scratch, num_cells * sizeof(int));
+    view->nodes = (int*)arena_alloc(scratch, grid->num_nodes * sizeof(int));
+    view->slot = (int*)arena_alloc(scratch, grid->num_nodes * sizeof(int));
+    if (!view->cell_count || !view->nodes || !view->slot)
+    {
+        return 0;
+    }
+    for (int c = 0; c < num_cells; c++)
+    {
+        view->cell_count[c] = grid->cell_start[c + 1] - grid->cell_start[c];
+    }
+    memcpy(view->nodes, grid->cell_nodes, grid->num_nodes * sizeof(int));
+    for (int i = 0; i < grid->num_nodes; i++)
+    {
+        view->slot[view->nodes[i]] = i;
+    }
+    return 1;
+}
+
+void spatial_view_remove(SpatialView* view, int node)
+{
+    // Swap the node behind the last available one of its cell
+    int cell = view->grid->cell_of[node];
+    int last = view->grid->cell_start[cell] + --view->cell_count[cell];
+    int moved = view->nodes[last];
+    int slot = view->slot[node];
+    view->nodes[slot] = moved;
+    view->slot[moved] = slot;
+    view->nodes[last] = node;
+    view->slot[node] = last;
+}
+
+int spatial_view_nearest(const SpatialView* view, const int** distances, const int* costs, int from, int* nearest)
+{
+    const SpatialGrid* grid = view->grid;
+    int cx = grid->cell_of[from] % grid->cells_x;
+    int cy = grid->cell_of[from] / grid->cells_x;
+    int max_ring = grid->cells_x > grid->cells_y ? grid->cells_x : grid->cells_y;
+    int min_cost = costs ? grid->min_cost : 0;
+
+    int best = INT_MAX;
+    int count = 0;
+    for (int r = 0; r <= max_ring; r++)
+    {
+        // Cells of ring r are at least (r - 1) cells away from any point of the centre cell,
+        // and distances are rounded, so the ring cannot tie once that bound exceeds the best
+        if (count > 0 && r > 0)
+        {
+            double bound = floor((r - 1) * grid->cell_size + 0.5) + min_cost;
+            if (bound > best)
+            {
+                break;
+            }
+        }
+
+        for (int y = cy - r; y <= cy + r; y++)
+        {
+            if (y < 0 || y >= grid->cells_y)
+                continue;
+            // Inner rows of the ring only have their two end cells
+            int step = (y == cy - r || y == cy + r) ? 1 : 2 * r;
+            for (int x = cx - r; x <= cx + r; x += step)
+            {
+                if (x < 0 || x >= grid->cells_x)
+                    continue;
+                int cell = y * grid->cells_x + x;
+                const int* nodes = view->nodes + grid->cell_start[cell];
+                for (int k = 0; k < view->cell_count[cell]; k++)
+                {
+                    int j = nodes[k];
+                    int value = distances[from][j] + (costs ? costs[j] : 0);
+                    if (value < best)
+                    {
+                        best = value;
+                        count = 0;
+                        nearest[count++] = j;
+                    }
+                    else if (value == best)
+                    {
+                        nearest[count++] = j;
+                    }
+                }
+            }
+        }
+    }
+
+    // Ties in index order, as a linear scan over the nodes finds them
+    for (int i = 1; i < count; i++)
+    {
+        int node = nearest[i];
+        int k = i - 1;
+        while (k >= 0 && nearest[k] > node)
+        {
+            nearest[k + 1] = nearest[k];
+            k--;
+        }
+        nearest[k + 1] = node;
+    }
+    return count;
+}
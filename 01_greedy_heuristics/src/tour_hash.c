@@ -0,0 +1,96 @@
+#include "tour_hash.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+// Slots probed before a hash is given up on
+#define SEEN_SET_MAX_PROBES 32
+
+/**
+ * @brief Open addressing over atomic slots, filled with compare-and-swap; 0 marks an empty
+ * slot, so the hash 0 is stored as 1.
+ */
+struct SeenSet {
+    _Atomic uint64_t* slots;
+    size_t mask;
+};
+
+uint64_t tour_hash(const int* solution, int solution_size)
+{
+    uint64_t hash = 0;
+    for (int i = 0; i < solution_size; i++)
+    {
+        hash ^= tour_hash_node(solution[i]);
+        hash ^= tour_hash_edge(solution[i], solution[i + 1 == solution_size ? 0 : i + 1]);
+    }
+    return hash;
+}
+
+SeenSet* seen_set_create(size_t capacity)
+{
+    size_t size = 1;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    SeenSet* set = (SeenSet*)malloc(sizeof(SeenSet));
+    if (!set)
+    {
+        return NULL;
+    }
+    set->slots = (_Atomic uint64_t*)calloc(size, sizeof(_Atomic uint64_t));
+    if (!set->slots)
+    {
+        free(set);
+        return NULL;
+    }
+    set->mask = size - 1;
+    return set;
+}
+
+void seen_set_destroy(SeenSet* set)
+{
+    if (!set)
+    {
+        return;
+    }
+    free((void*)set->slots);
+    free(set);
+}
+
+int seen_set_contains(const SeenSet* set, uint64_t hash)
+{
+    hash = hash ? hash : 1;
+    for (size_t probe = 0; probe < SEEN_SET_MAX_PROBES; probe++)
+    {
+        uint64_t slot = atomic_load_explicit(&set->slots[(hash + probe) & set->mask], memory_order_relaxed);
+        if (slot == hash)
+        {
+            return 1;
+        }
+        if (slot == 0)
+        {
+            return 0;
+        }
+    }
+    return 0;
+}
+
+int seen_set_insert(SeenSet* set, uint64_t hash)
+{
+    hash = hash ? hash : 1;
+    for (size_t probe = 0; probe < SEEN_SET_MAX_PROBES; probe++)
+    {
+        _Atomic uint64_t* slot = &set->slots[(hash + probe) & set->mask];
+        uint64_t expected = 0;
+        if (atomic_compare_exchange_strong_explicit(slot, &expected, hash, memory_order_relaxed, memory_order_relaxed))
+        {
+            return 1;
+        }
+        // The slot was taken, by this very hash if it was inserted before
+        if (expected == hash)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
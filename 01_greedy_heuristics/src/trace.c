@@ -0,0 +1,92 @@
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int trace_init(Trace* trace, int capacity)
+{
+    trace->capacity = capacity > 0 ? capacity : 1;
+    trace->points = (TracePoint*)malloc(trace->capacity * sizeof(TracePoint));
+    trace->next = 0;
+    trace->recorded = 0;
+    if (!trace->points)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for trace\n");
+        trace->capacity = 0;
+        return 0;
+    }
+    return 1;
+}
+
+void trace_free(Trace* trace)
+{
+    free(trace->points);
+    trace->points = NULL;
+    trace->capacity = 0;
+    trace_clear(trace);
+}
+
+void trace_clear(Trace* trace)
+{
+    trace->next = 0;
+    trace->recorded = 0;
+}
+
+int trace_size(const Trace* trace)
+{
+    return trace->recorded < trace->capacity ? (int)trace->recorded : trace->capacity;
+}
+
+const TracePoint* trace_at(const Trace* trace, int i)
+{
+    // Before the buffer wraps the oldest point is in slot 0, afterwards in the next slot
+    int oldest = trace->recorded < trace->capacity ? 0 : trace->next;
+    return &trace->points[(oldest + i) % trace->capacity];
+}
+
+int trace_write_csv(const Trace* trace, const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+    if (!file)
+    {
+        fprintf(stderr, "Error: Cannot open file %s\n", filename);
+        return 0;
+    }
+
+    fprintf(file, "elapsed_us;iteration;best_eval\n");
+    int size = trace_size(trace);
+    for (int i = 0; i < size; i++)
+    {
+        const TracePoint* point = trace_at(trace, i);
+        fprintf(file, "%lld;%d;%d\n", (long long)point->elapsed_us, point->iteration, point->best_eval);
+    }
+
+    fclose(file);
+    return 1;
+}
+
+int trace_write_binary(const Trace* trace, const char* filename)
+{
+    FILE* file = fopen(filename, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "Error: Cannot open file %s\n", filename);
+        return 0;
+    }
+
+    uint32_t size = (uint32_t)trace_size(trace);
+    fwrite("TRC1", 1, 4, file);
+    fwrite(&size, sizeof(size), 1, file);
+    for (uint32_t i = 0; i < size; i++)
+    {
+        const TracePoint* point = trace_at(trace, (int)i);
+        int32_t iteration = point->iteration;
+        int32_t best_eval = point->best_eval;
+        fwrite(&point->elapsed_us, sizeof(point->elapsed_us), 1, file);
+        fwrite(&iteration, sizeof(iteration), 1, file);
+        fwrite(&best_eval, sizeof(best_eval), 1, file);
+    }
+
+    int ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
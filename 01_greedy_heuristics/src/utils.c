@@ -1,16 +1,7 @@
 #include "utils.h"
+#include <unistd.h>
 
-int calculate_cost(const int* solution, int solution_size, const int** distances, const int* costs) {
-    int cost = 0;
-    for(int j = 0; j < solution_size - 1; j++) {
-        cost += distances[solution[j]][solution[j+1]];
-    }
-    cost += distances[solution[solution_size -1]][solution[0]];
-    for(int j = 0; j < solution_size; j++) {
-        cost += costs[solution[j]];
-    }
-    return cost;
-}
+// calculate_cost lives in moves.cpp, over the shared kernels
 
 void calculate_cost_breakdown(const int* solution, int solution_size, const int** distances, const int* costs, int* path_length, int* node_costs) {
     int length = 0;
@@ -26,15 +17,9 @@ void calculate_cost_breakdown(const int* solution, int solution_size, const int*
     *node_costs = n_costs;
 }
 
-void shuffle_array(int* array, int n) {
-    if (n > 1) {
-        for(int i = n -1; i > 0; i--) {
-            int j = rand() % (i +1);
-            int temp = array[j];
-            array[j] = array[i];
-            array[i] = temp;
-        }
-    }
+int available_threads(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
 }
 
 int** read_file(const char* filename, int* num_nodes) {
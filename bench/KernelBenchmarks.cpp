@@ -0,0 +1,412 @@
+#include "DistanceMatrix.h"
+#include "LocalSearchSolver.h"
+#include "RandomSolution.h"
+#include "RandomGenerator.h"
+#include "InstanceGenerator.h"
+
+#include "utils.h"
+#include "moves.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Micro-benchmarks of the evaluation kernels of the C++ and C solvers.
+// Time per iteration is the cost of one kernel call (ns/op) and items_per_second
+// is the number of evaluations per second.
+namespace LS {
+
+    struct InstanceSpec {
+        std::string name;
+        std::string filename; // empty for generated instances
+        int size;
+    };
+
+    // Number of pre-drawn move arguments cycled through by the delta benchmarks
+    const int NUM_SAMPLES = 4096;
+    // greedyCycleRepair is quadratic per insertion, larger instances take minutes per call
+    const int MAX_REPAIR_NODES = 1000;
+
+    // Coordinates of one instance plus the matrices built from them. The matrices of
+    // the 20k instance take 1.6 GB each, so only one instance and one matrix layout
+    // are kept in memory at a time; benchmarks are registered grouped by instance.
+    class BenchInstance {
+    private:
+        std::string name;
+        std::vector<int> xs, ys, costs;
+        std::shared_ptr<const DistanceMatrix> matrix;
+        int** cDistances = nullptr;
+        RandomSolution tour;
+
+        static std::unique_ptr<BenchInstance> current;
+
+        explicit BenchInstance(const InstanceSpec& spec)
+            : name(spec.name)
+        {
+            if (!spec.filename.empty())
+            {
+                DistanceMatrix reader;
+                reader.readCoordinates(spec.filename, xs, ys);
+                costs = reader.getCosts();
+            }
+            else
+            {
+                // Same ranges as the course instances: uniform points, costs in [100, 2000]
+                GeneratorConfig config;
+                config.size = spec.size;
+                config.seed = spec.size;
+                InstanceData generated = generateInstance(config);
+                xs = std::move(generated.xs);
+                ys = std::move(generated.ys);
+                costs = std::move(generated.costs);
+            }
+
+            Rng rng(42);
+            tour.generate(size(), size() / 2, rng);
+        }
+
+    public:
+        ~BenchInstance()
+        {
+            releaseDistances();
+        }
+
+        static BenchInstance& get(const InstanceSpec& spec)
+        {
+            if (!current || current->name != spec.name)
+            {
+                current.reset();
+                current.reset(new BenchInstance(spec));
+            }
+            return *current;
+        }
+
+        int size() const { return static_cast<int>(xs.size()); }
+        const Solution& getTour() const { return tour; }
+
+        const std::shared_ptr<const DistanceMatrix>& getMatrix()
+        {
+            if (!matrix)
+            {
+                releaseDistances();
+                auto created = std::make_shared<DistanceMatrix>();
+                created->create(xs, ys, costs);
+                matrix = created;
+            }
+            return matrix;
+        }
+
+        const int** getCDistances()
+        {
+            if (cDistances == nullptr)
+            {
+                releaseDistances();
+                int** data = createCData();
+                cDistances = calcDistances(data, size());
+                free_data(data, size());
+            }
+            return const_cast<const int**>(cDistances);
+        }
+
+        // Rows of (x, y, cost) as produced by read_file
+        int** createCData() const
+        {
+            int** data = static_cast<int**>(std::malloc(size() * sizeof(int*)));
+            for (int i = 0; i < size(); ++i)
+            {
+                data[i] = static_cast<int*>(std::malloc(3 * sizeof(int)));
+                data[i][0] = xs[i];
+                data[i][1] = ys[i];
+                data[i][2] = costs[i];
+            }
+            return data;
+        }
+
+        const int* getCosts() const { return costs.data(); }
+
+        void releaseDistances()
+        {
+            matrix.reset();
+            if (cDistances != nullptr)
+            {
+                free_distances(cDistances, size());
+                cDistances = nullptr;
+            }
+        }
+    };
+
+    std::unique_ptr<BenchInstance> BenchInstance::current;
+
+    // Pairs of positions in the tour and nodes outside of it, drawn once per benchmark
+    struct MoveSamples {
+        std::vector<int> first;
+        std::vector<int> second;
+        std::vector<int> outsideNode;
+
+        explicit MoveSamples(const Solution& tour, int totalNodes)
+        {
+            Rng rng(7);
+            int tourSize = tour.getNumberOfNodes();
+            std::vector<int> outside;
+            for (int node = 0; node < totalNodes; ++node)
+            {
+                if (!tour.contains(node)) outside.push_back(node);
+            }
+            for (int s = 0; s < NUM_SAMPLES; ++s)
+            {
+                int i = static_cast<int>(rng.bounded(tourSize));
+                int j = static_cast<int>(rng.bounded(tourSize - 1));
+                first.push_back(i);
+                second.push_back(j >= i ? j + 1 : j);
+                outsideNode.push_back(outside[rng.bounded(static_cast<uint32_t>(outside.size()))]);
+            }
+        }
+    };
+
+    void reportEvaluations(benchmark::State& state)
+    {
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // C++ kernels
+
+    void benchEvaluate(benchmark::State& state, InstanceSpec spec)
+    {
+        auto& instance = BenchInstance::get(spec);
+        const auto& distances = instance.getMatrix()->getDistanceMatrix();
+        const auto& costs = instance.getMatrix()->getCosts();
+        const Solution& tour = instance.getTour();
+
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(tour.evaluate(distances, costs));
+        }
+        reportEvaluations(state);
+    }
+
+    void benchDeltaInterRoute(benchmark::State& state, InstanceSpec spec)
+    {
+        auto& instance = BenchInstance::get(spec);
+        const auto& distances = instance.getMatrix()->getDistanceMatrix();
+        const auto& costs = instance.getMatrix()->getCosts();
+        const Solution& tour = instance.getTour();
+        MoveSamples samples(tour, instance.size());
+
+        int s = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(tour.calculateDeltaInterRoute(distances, costs, samples.first[s], samples.outsideNode[s]));
+            s = (s + 1) & (NUM_SAMPLES - 1);
+        }
+        reportEvaluations(state);
+    }
+
+    void benchDeltaInterRouteCandidates(benchmark::State& state, InstanceSpec spec)
+    {
+        auto& instance = BenchInstance::get(spec);
+        const auto& distances = instance.getMatrix()->getDistanceMatrix();
+        const auto& costs = instance.getMatrix()->getCosts();
+        const Solution& tour = instance.getTour();
+        MoveSamples samples(tour, instance.size());
+        const std::string directions[2] = { "next", "previous" };
+
+        int s = 0;
+        int removedIndex = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(tour.calculateDeltaInterRouteNodesCandidates(
+                distances, costs, samples.first[s], samples.outsideNode[s], removedIndex, directions[s & 1]));
+            s = (s + 1) & (NUM_SAMPLES - 1);
+        }
+        reportEvaluations(state);
+    }
+
+    void benchDeltaIntraRouteNodes(benchmark::State& state, InstanceSpec spec)
+    {
+        auto& instance = BenchInstance::get(spec);
+        const auto& distances = instance.getMatrix()->getDistanceMatrix();
+        const Solution& tour = instance.getTour();
+        MoveSamples samples(tour, instance.size());
+
+        int s = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(tour.calculateDeltaIntraRouteNodes(distances, samples.first[s], samples.second[s]));
+            s = (s + 1) & (NUM_SAMPLES - 1);
+        }
+        reportEvaluations(state);
+    }
+
+    void benchDeltaIntraRouteEdges(benchmark::State& state, InstanceSpec spec)
+    {
+        auto& instance = BenchInstance::get(spec);
+        const auto& distances = instance.getMatrix()->getDistanceMatrix();
+        const Solution& tour = instance.getTour();
+        MoveSamples samples(tour, instance.size());
+
+        int s = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(tour.calculateDeltaIntraRouteEdges(distances, samples.first[s], samples.second[s]));
+            s = (s + 1) & (NUM_SAMPLES - 1);
+        }
+        reportEvaluations(state);
+    }
+
+    void benchExchangeTwoEdges(benchmark::State& state, InstanceSpec spec)
+    {
+        auto& instance = BenchInstance::get(spec);
+        Solution tour = instance.getTour();
+        MoveSamples samples(tour, instance.size());
+
+        int s = 0;
+        for (auto _ : state)
+        {
+            tour.exchangeTwoEdges(samples.first[s], samples.second[s]);
+            benchmark::ClobberMemory();
+            s = (s + 1) & (NUM_SAMPLES - 1);
+        }
+        reportEvaluations(state);
+    }
+
+    void benchGreedyCycleRepair(benchmark::State& state, InstanceSpec spec)
+    {
+        auto& instance = BenchInstance::get(spec);
+        const Solution& tour = instance.getTour();
+        LocalSearchSolver solver(instance.getMatrix(), spec.name, 0.5, tour);
+        // Destroy a quarter of the tour, as a single LNS destroy step does on average
+        int destroyed = tour.getNumberOfNodes() / 4;
+
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            solver.setInitialSolutionCopy(tour);
+            solver.getBestSolutionPtr()->removeNodes(0, destroyed);
+            std::vector<int> repaired;
+            state.ResumeTiming();
+
+            solver.greedyCycleRepair(repaired);
+            benchmark::DoNotOptimize(repaired.data());
+        }
+        state.SetItemsProcessed(state.iterations() * destroyed);
+        state.SetLabel("items = inserted nodes");
+    }
+
+    // C kernels
+
+    void benchCDeltaTwoNodes(benchmark::State& state, InstanceSpec spec)
+    {
+        auto& instance = BenchInstance::get(spec);
+        const int** distances = instance.getCDistances();
+        const std::vector<int>& tour = instance.getTour().getNodes();
+        MoveSamples samples(instance.getTour(), instance.size());
+
+        int s = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(delta_two_nodes_exchange(tour.data(), static_cast<int>(tour.size()), distances, samples.first[s], samples.second[s]));
+            s = (s + 1) & (NUM_SAMPLES - 1);
+        }
+        reportEvaluations(state);
+    }
+
+    void benchCDeltaTwoEdges(benchmark::State& state, InstanceSpec spec)
+    {
+        auto& instance = BenchInstance::get(spec);
+        const int** distances = instance.getCDistances();
+        const std::vector<int>& tour = instance.getTour().getNodes();
+        MoveSamples samples(instance.getTour(), instance.size());
+
+        int s = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(delta_two_edges_exchange(tour.data(), static_cast<int>(tour.size()), distances, samples.first[s], samples.second[s]));
+            s = (s + 1) & (NUM_SAMPLES - 1);
+        }
+        reportEvaluations(state);
+    }
+
+    void benchCDeltaInterRoute(benchmark::State& state, InstanceSpec spec)
+    {
+        auto& instance = BenchInstance::get(spec);
+        const int** distances = instance.getCDistances();
+        const std::vector<int>& tour = instance.getTour().getNodes();
+        MoveSamples samples(instance.getTour(), instance.size());
+
+        int s = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(delta_inter_route_exchange(tour.data(), static_cast<int>(tour.size()), distances, instance.getCosts(),
+                                                                samples.first[s], samples.outsideNode[s]));
+            s = (s + 1) & (NUM_SAMPLES - 1);
+        }
+        reportEvaluations(state);
+    }
+
+    void benchCCalcDistances(benchmark::State& state, InstanceSpec spec)
+    {
+        auto& instance = BenchInstance::get(spec);
+        // Leave room for the matrix built by every iteration
+        instance.releaseDistances();
+        int** data = instance.createCData();
+
+        for (auto _ : state)
+        {
+            int** distances = calcDistances(data, instance.size());
+            benchmark::DoNotOptimize(distances);
+            state.PauseTiming();
+            free_distances(distances, instance.size());
+            state.ResumeTiming();
+        }
+        free_data(data, instance.size());
+        state.SetItemsProcessed(state.iterations() * instance.size() * instance.size());
+        state.SetLabel("items = matrix entries");
+    }
+
+    void registerBenchmarks()
+    {
+        const std::string dataDir = BENCH_DATA_DIR;
+        const std::vector<InstanceSpec> specs = {
+            { "TSPA", dataDir + "/TSPA.csv", 0 },
+            { "TSPB", dataDir + "/TSPB.csv", 0 },
+            { "uniform1k", "", 1000 },
+            { "uniform5k", "", 5000 },
+            { "uniform20k", "", 20000 }
+        };
+
+        for (const auto& spec : specs)
+        {
+            const std::string suffix = "/" + spec.name;
+            benchmark::RegisterBenchmark(("Solution::evaluate" + suffix).c_str(), benchEvaluate, spec);
+            benchmark::RegisterBenchmark(("Solution::calculateDeltaInterRoute" + suffix).c_str(), benchDeltaInterRoute, spec);
+            benchmark::RegisterBenchmark(("Solution::calculateDeltaInterRouteNodesCandidates" + suffix).c_str(), benchDeltaInterRouteCandidates, spec);
+            benchmark::RegisterBenchmark(("Solution::calculateDeltaIntraRouteNodes" + suffix).c_str(), benchDeltaIntraRouteNodes, spec);
+            benchmark::RegisterBenchmark(("Solution::calculateDeltaIntraRouteEdges" + suffix).c_str(), benchDeltaIntraRouteEdges, spec);
+            benchmark::RegisterBenchmark(("Solution::exchangeTwoEdges" + suffix).c_str(), benchExchangeTwoEdges, spec);
+            if (spec.size <= MAX_REPAIR_NODES)
+            {
+                benchmark::RegisterBenchmark(("LocalSearchSolver::greedyCycleRepair" + suffix).c_str(), benchGreedyCycleRepair, spec)
+                    ->Unit(benchmark::kMicrosecond);
+            }
+            benchmark::RegisterBenchmark(("c/delta_two_nodes_exchange" + suffix).c_str(), benchCDeltaTwoNodes, spec);
+            benchmark::RegisterBenchmark(("c/delta_two_edges_exchange" + suffix).c_str(), benchCDeltaTwoEdges, spec);
+            benchmark::RegisterBenchmark(("c/delta_inter_route_exchange" + suffix).c_str(), benchCDeltaInterRoute, spec);
+            benchmark::RegisterBenchmark(("c/calcDistances" + suffix).c_str(), benchCCalcDistances, spec)
+                ->Unit(benchmark::kMillisecond);
+        }
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    LS::registerBenchmarks();
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
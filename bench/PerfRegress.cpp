@@ -0,0 +1,561 @@
+#include "DistanceMatrix.h"
+#include "LSNLocalSearchSolver.h"
+#include "RandomSolution.h"
+#include "RandomGenerator.h"
+#include "InstanceGenerator.h"
+#include "ConvergenceTrace.h"
+#include "Instrumentation.h"
+
+#include "algorithms.h"
+#include "msls.h"
+#include "ils.h"
+#include "instr.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Regression gate for the solvers: runs a fixed, seeded matrix of algorithms over the
+// course instances and generated ones, and compares evaluations per second, iterations
+// per second and the best cost at fixed time checkpoints against a stored baseline.
+// Built with instrumentation so that evaluations can be counted; the baseline has to be
+// recorded by the same binary.
+namespace LS {
+
+    struct PerfOptions {
+        std::string outputFile = "perf_results.csv";
+        std::string baselineFile;
+        bool updateBaseline = false;
+        double costTolerance = 0.02;  // relative increase of a cost metric that still passes
+        double rateTolerance = 0.25;  // relative decrease of a rate metric that still passes
+        int timeMs = 1000;            // budget of the time-limited algorithms (ILS, LNS)
+        int repetitions = 3;          // runs of the matrix, every metric is the median over them
+        uint64_t seed = 20241;
+    };
+
+    struct PerfInstance {
+        std::string name;
+        std::vector<int> xs, ys, costs;
+    };
+
+    // One metric of one (algorithm, instance) cell of the matrix
+    struct PerfMetric {
+        std::string algorithm;
+        std::string instance;
+        std::string metric;
+        double value;
+    };
+
+    // Construction heuristics and MSLS are at least cubic in the instance size
+    const int MAX_CONSTRUCTIVE_NODES = 200;
+    // Time checkpoints, as percentages of the time budget
+    const int CHECKPOINT_PERCENTS[] = { 25, 50, 100 };
+
+    PerfInstance loadInstance(const std::string& name, const std::string& filename)
+    {
+        PerfInstance instance;
+        instance.name = name;
+        DistanceMatrix reader;
+        reader.readCoordinates(filename, instance.xs, instance.ys);
+        instance.costs = reader.getCosts();
+        return instance;
+    }
+
+    // Same ranges as the course instances: uniform points, costs in [100, 2000]
+    PerfInstance uniformInstance(const std::string& name, int size, uint64_t seed)
+    {
+        GeneratorConfig config;
+        config.size = size;
+        config.seed = seed;
+        InstanceData generated = generateInstance(config);
+
+        PerfInstance instance;
+        instance.name = name;
+        instance.xs = std::move(generated.xs);
+        instance.ys = std::move(generated.ys);
+        instance.costs = std::move(generated.costs);
+        return instance;
+    }
+
+    class PerfRunner {
+    private:
+        const PerfOptions& options;
+        const PerfInstance& instance;
+        std::shared_ptr<const DistanceMatrix> matrix;
+        int** cDistances;
+        SpatialGrid grid; // of the instance, for the nearest-neighbour constructions
+        std::vector<PerfMetric>& metrics;
+
+        int size() const { return static_cast<int>(instance.costs.size()); }
+
+        void add(const std::string& algorithm, const std::string& metric, double value)
+        {
+            metrics.push_back(PerfMetric{ algorithm, instance.name, metric, value });
+        }
+
+        void addRates(const std::string& algorithm, double seconds, int64_t evaluations, int64_t iterations)
+        {
+            add(algorithm, "wall_ms", seconds * 1000);
+            if (evaluations > 0)
+            {
+                add(algorithm, "evals_per_sec", evaluations / seconds);
+            }
+            if (iterations > 0)
+            {
+                add(algorithm, "iters_per_sec", iterations / seconds);
+            }
+        }
+
+        // Best cost reached by each checkpoint. Checkpoints before the first recorded point
+        // report that point, the initial cost of the run, so that every checkpoint is present
+        // whether the first improvement comes early or late.
+        void addCheckpoints(const std::string& algorithm, const std::vector<std::pair<int64_t, int>>& points)
+        {
+            if (points.empty())
+            {
+                return;
+            }
+            for (int percent : CHECKPOINT_PERCENTS)
+            {
+                int64_t checkpointUs = static_cast<int64_t>(options.timeMs) * 10 * percent;
+                int best = points.front().second;
+                for (const auto& point : points)
+                {
+                    if (point.first > checkpointUs)
+                    {
+                        break;
+                    }
+                    best = point.second;
+                }
+                add(algorithm, "best_at_" + std::to_string(percent) + "pct", best);
+            }
+        }
+
+        static double secondsSince(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        static int64_t evaluationsOf(const InstrCounters& counters)
+        {
+            return counters.inter_route_evals + counters.intra_nodes_evals + counters.intra_edges_evals;
+        }
+
+        // Runs one C algorithm through Algo.solve and records its metrics
+        void runC(Algo* algo, int numSolutions, int64_t constructions, const Trace* trace)
+        {
+            if (!algo)
+            {
+                throw std::runtime_error("Could not create algorithm");
+            }
+            ::Rng rng;
+            rng_seed(&rng, options.seed);
+            instr_take();
+
+            auto start = std::chrono::steady_clock::now();
+            Result res = algo->solve(algo, const_cast<const int**>(cDistances), size(), instance.costs.data(), numSolutions, &rng);
+            double seconds = secondsSince(start);
+            InstrCounters counters = instr_take();
+
+            std::string name = algo->name;
+            if (!res.bestSolution)
+            {
+                free_Result(res);
+                throw std::runtime_error(name + " failed on " + instance.name);
+            }
+            add(name, "best_cost", res.bestCost);
+            addRates(name, seconds, evaluationsOf(counters), constructions > 0 ? constructions : counters.local_searches);
+            if (trace)
+            {
+                std::vector<std::pair<int64_t, int>> points;
+                for (int i = 0; i < trace_size(trace); ++i)
+                {
+                    const ::TracePoint* point = trace_at(trace, i);
+                    points.emplace_back(point->elapsed_us, point->best_eval);
+                }
+                addCheckpoints(name, points);
+            }
+            free_Result(res);
+        }
+
+    public:
+        PerfRunner(const PerfOptions& options, const PerfInstance& instance, std::vector<PerfMetric>& metrics)
+            : options(options), instance(instance), cDistances(nullptr), metrics(metrics)
+        {
+            auto created = std::make_shared<DistanceMatrix>();
+            created->create(instance.xs, instance.ys, instance.costs);
+            matrix = created;
+
+            // Rows of (x, y, cost) as produced by read_file
+            int** data = static_cast<int**>(std::malloc(size() * sizeof(int*)));
+            for (int i = 0; i < size(); ++i)
+            {
+                data[i] = static_cast<int*>(std::malloc(3 * sizeof(int)));
+                data[i][0] = instance.xs[i];
+                data[i][1] = instance.ys[i];
+                data[i][2] = instance.costs[i];
+            }
+            cDistances = calcDistances(data, size());
+            bool gridBuilt = spatial_grid_build(&grid, data, size()) != 0;
+            free_data(data, size());
+            if (!gridBuilt)
+            {
+                spatial_grid_free(&grid);
+                free_distances(cDistances, size());
+                throw std::runtime_error("Could not build the spatial grid of " + instance.name);
+            }
+        }
+
+        ~PerfRunner()
+        {
+            spatial_grid_free(&grid);
+            free_distances(cDistances, size());
+        }
+
+        PerfRunner(const PerfRunner&) = delete;
+        PerfRunner& operator=(const PerfRunner&) = delete;
+
+        void runConstructive()
+        {
+            if (size() > MAX_CONSTRUCTIVE_NODES)
+            {
+                return;
+            }
+            // One construction from every start node
+            NearestNeighboursEndInsert* nearestEnd = create_NearestNeighboursEndInsert(&grid);
+            runC(reinterpret_cast<Algo*>(nearestEnd), 1, size(), nullptr);
+            std::free(nearestEnd);
+            NearestNeighboursAnywhereInsert* nearestAnywhere = create_NearestNeighboursAnywhereInsert(&grid);
+            runC(reinterpret_cast<Algo*>(nearestAnywhere), 1, size(), nullptr);
+            std::free(nearestAnywhere);
+            GreedyCycle* greedyCycle = create_GreedyCycle();
+            runC(reinterpret_cast<Algo*>(greedyCycle), 1, size(), nullptr);
+            std::free(greedyCycle);
+            Greedy2Regret* greedy2Regret = create_Greedy2Regret();
+            runC(reinterpret_cast<Algo*>(greedy2Regret), 1, size(), nullptr);
+            std::free(greedy2Regret);
+
+            // Single-threaded so that the descent sequence only depends on the seed
+            MSLS* msls = create_MSLS(1);
+            if (msls)
+            {
+                msls->num_threads = 1;
+            }
+            runC(reinterpret_cast<Algo*>(msls), 1, 0, nullptr);
+            std::free(const_cast<char*>(msls->base.name));
+            std::free(msls);
+        }
+
+        void runILS()
+        {
+            ILS* ils = create_ILS(options.timeMs, 5);
+            Trace trace;
+            if (!ils || !trace_init(&trace, 4096))
+            {
+                throw std::runtime_error("Could not create ILS");
+            }
+            ils->num_islands = 1;
+            ils->trace = &trace;
+            runC(reinterpret_cast<Algo*>(ils), 0, 0, &trace);
+            trace_free(&trace);
+            std::free(const_cast<char*>(ils->base.name));
+            std::free(ils);
+        }
+
+        void runLNS()
+        {
+            const double fractionNodes = 0.5;
+            Rng rng(options.seed);
+            RandomSolution initialSolution;
+            initialSolution.generate(size(), static_cast<int>(size() * fractionNodes), rng);
+
+            LSNLocalSearchSolver solver(matrix, instance.name, fractionNodes, initialSolution);
+            solver.setRng(rng);
+            ConvergenceTrace trace;
+            solver.setTrace(&trace);
+
+            auto start = std::chrono::steady_clock::now();
+            solver.run(options.timeMs * 1000.0, true);
+            double seconds = secondsSince(start);
+
+            const RunCounters& counters = solver.getRunCounters();
+            int64_t evaluations = counters.interRouteEvaluations + counters.intraNodesEvaluations +
+                                  counters.intraEdgesEvaluations;
+            const std::string name = "LNS";
+            add(name, "best_cost", solver.getBestSolutionEval());
+            addRates(name, seconds, evaluations, solver.getIterationCounts().back());
+
+            std::vector<std::pair<int64_t, int>> points;
+            for (const auto& point : trace.chronological())
+            {
+                points.emplace_back(point.elapsedUs, point.bestEval);
+            }
+            addCheckpoints(name, points);
+        }
+    };
+
+    // Median of every metric over the repetitions, in the order of first appearance
+    std::vector<PerfMetric> medianMetrics(const std::vector<std::vector<PerfMetric>>& runs)
+    {
+        std::vector<PerfMetric> medians;
+        std::map<std::string, std::vector<double>> values;
+        for (const auto& run : runs)
+        {
+            for (const auto& m : run)
+            {
+                std::vector<double>& samples = values[m.algorithm + ";" + m.instance + ";" + m.metric];
+                if (samples.empty())
+                {
+                    medians.push_back(m);
+                }
+                samples.push_back(m.value);
+            }
+        }
+        for (auto& m : medians)
+        {
+            std::vector<double>& samples = values[m.algorithm + ";" + m.instance + ";" + m.metric];
+            std::sort(samples.begin(), samples.end());
+            std::size_t half = samples.size() / 2;
+            m.value = samples.size() % 2 == 1 ? samples[half] : (samples[half - 1] + samples[half]) / 2;
+        }
+        return medians;
+    }
+
+    void writeMetrics(const std::vector<PerfMetric>& metrics, const std::string& filename)
+    {
+        std::ofstream out(filename);
+        if (!out.is_open())
+        {
+            throw std::runtime_error("Could not open file for writing: " + filename);
+        }
+        out << "algorithm;instance;metric;value\n";
+        for (const auto& m : metrics)
+        {
+            out << m.algorithm << ";" << m.instance << ";" << m.metric << ";" << m.value << "\n";
+        }
+    }
+
+    // Baseline values keyed by "algorithm;instance;metric"; throws std::runtime_error if the
+    // file cannot be read or holds no metrics, so that a lost baseline fails the gate
+    std::map<std::string, double> readMetrics(const std::string& filename)
+    {
+        std::map<std::string, double> values;
+        std::ifstream in(filename);
+        if (!in.is_open())
+        {
+            throw std::runtime_error("Could not open baseline " + filename + ", record one with --update-baseline");
+        }
+        std::string line;
+        std::getline(in, line); // header
+        while (std::getline(in, line))
+        {
+            std::size_t last = line.rfind(';');
+            if (line.empty() || last == std::string::npos)
+            {
+                continue;
+            }
+            values[line.substr(0, last)] = std::stod(line.substr(last + 1));
+        }
+        if (values.empty())
+        {
+            throw std::runtime_error("Baseline " + filename + " holds no metrics");
+        }
+        return values;
+    }
+
+    // Prints every metric outside its tolerance and returns the number of regressions.
+    // Costs must not grow by more than costTolerance and rates must not drop by more
+    // than rateTolerance; wall times are informational only.
+    int compareToBaseline(const std::vector<PerfMetric>& metrics, const std::map<std::string, double>& baseline,
+                          const PerfOptions& options)
+    {
+        std::map<std::string, double> current;
+        for (const auto& m : metrics)
+        {
+            current[m.algorithm + ";" + m.instance + ";" + m.metric] = m.value;
+        }
+
+        int regressions = 0;
+        for (const auto& entry : baseline)
+        {
+            const std::string& key = entry.first;
+            double expected = entry.second;
+            bool isCost = key.find(";best_") != std::string::npos;
+            bool isRate = key.find("_per_sec") != std::string::npos;
+            if (!isCost && !isRate)
+            {
+                continue;
+            }
+
+            auto found = current.find(key);
+            if (found == current.end())
+            {
+                std::cout << "REGRESSION " << key << ": missing (baseline " << expected << ")" << std::endl;
+                ++regressions;
+                continue;
+            }
+
+            double actual = found->second;
+            double change = expected != 0 ? (actual - expected) / expected : 0.0;
+            bool regressed = isCost ? change > options.costTolerance : -change > options.rateTolerance;
+            if (regressed)
+            {
+                std::cout << "REGRESSION " << key << ": " << actual << " vs baseline " << expected
+                          << " (" << (change > 0 ? "+" : "") << change * 100 << "%)" << std::endl;
+                ++regressions;
+            }
+        }
+        for (const auto& entry : current)
+        {
+            if (baseline.count(entry.first) == 0)
+            {
+                std::cout << "NEW " << entry.first << ": " << entry.second << std::endl;
+            }
+        }
+        return regressions;
+    }
+
+    std::string usage(const char* program)
+    {
+        std::ostringstream out;
+        out << "Usage: " << program << " [options]\n"
+            << "  --output FILE          results file (default perf_results.csv)\n"
+            << "  --baseline FILE        baseline to compare against; fails if it cannot be read\n"
+            << "  --update-baseline      write the results to the baseline file instead of comparing\n"
+            << "  --cost-tolerance X     allowed relative cost increase (default 0.02)\n"
+            << "  --rate-tolerance X     allowed relative drop of evals/iters per second (default 0.25)\n"
+            << "  --time-ms N            time budget of ILS and LNS (default 1000)\n"
+            << "  --repetitions N        runs of the matrix, metrics are medians (default 3)\n"
+            << "  --seed N               seed of every run (default 20241)\n";
+        return out.str();
+    }
+
+    PerfOptions parseOptions(int argc, char** argv)
+    {
+        PerfOptions options;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--update-baseline")
+            {
+                options.updateBaseline = true;
+                continue;
+            }
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value or unknown option: " + arg);
+            }
+            std::string value = argv[++i];
+            if (arg == "--output")
+                options.outputFile = value;
+            else if (arg == "--baseline")
+                options.baselineFile = value;
+            else if (arg == "--cost-tolerance")
+                options.costTolerance = std::stod(value);
+            else if (arg == "--rate-tolerance")
+                options.rateTolerance = std::stod(value);
+            else if (arg == "--time-ms")
+                options.timeMs = std::stoi(value);
+            else if (arg == "--repetitions")
+                options.repetitions = std::stoi(value);
+            else if (arg == "--seed")
+                options.seed = std::stoull(value);
+            else
+                throw std::runtime_error("Unknown option: " + arg);
+        }
+        if (options.repetitions < 1 || options.timeMs < 1)
+        {
+            throw std::runtime_error("--repetitions and --time-ms must be positive");
+        }
+        if (options.updateBaseline && options.baselineFile.empty())
+        {
+            throw std::runtime_error("--update-baseline requires --baseline");
+        }
+        return options;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    LS::PerfOptions options;
+    try
+    {
+        options = LS::parseOptions(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl << LS::usage(argv[0]);
+        return 1;
+    }
+
+    // Read before the matrix runs, so that a missing baseline fails at once
+    std::map<std::string, double> baseline;
+    if (!options.baselineFile.empty() && !options.updateBaseline)
+    {
+        try
+        {
+            baseline = LS::readMetrics(options.baselineFile);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<LS::PerfInstance> instances;
+    instances.push_back(LS::loadInstance("TSPA", PERF_DATA_DIR "/TSPA.csv"));
+    instances.push_back(LS::loadInstance("TSPB", PERF_DATA_DIR "/TSPB.csv"));
+    instances.push_back(LS::uniformInstance("uniform200", 200, 200));
+    instances.push_back(LS::uniformInstance("uniform1k", 1000, 1000));
+
+    std::vector<LS::PerfMetric> metrics;
+    try
+    {
+        std::vector<std::vector<LS::PerfMetric>> runs(options.repetitions);
+        for (const auto& instance : instances)
+        {
+            for (int rep = 0; rep < options.repetitions; ++rep)
+            {
+                std::cout << "Running " << instance.name << " (" << rep + 1 << "/" << options.repetitions << ")" << std::endl;
+                LS::PerfRunner runner(options, instance, runs[rep]);
+                runner.runConstructive();
+                runner.runILS();
+                runner.runLNS();
+            }
+        }
+        metrics = LS::medianMetrics(runs);
+        LS::writeMetrics(metrics, options.outputFile);
+        if (options.updateBaseline)
+        {
+            LS::writeMetrics(metrics, options.baselineFile);
+            std::cout << "Baseline written to " << options.baselineFile << std::endl;
+            return 0;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (options.baselineFile.empty())
+    {
+        std::cout << "No baseline given, results written to " << options.outputFile << std::endl;
+        return 0;
+    }
+
+    int regressions = LS::compareToBaseline(metrics, baseline, options);
+    std::cout << regressions << " regression(s) against " << options.baselineFile << std::endl;
+    return regressions == 0 ? 0 : 1;
+}
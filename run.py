@@ -182,10 +182,44 @@ Code goes here
         out_md.write(df.reset_index().to_markdown(index=False))
     
 
+def save_similarity_plots(csv_filename):
+    # one scatter of the evaluation against each similarity measure of SimilarityAnalysis
+    df = pd.read_csv(csv_filename)
+    others = df[df.is_best == 0]
+    measures = [('common_edges_best', 'Common edges with best'),
+                ('common_nodes_best', 'Common nodes with best'),
+                ('avg_common_edges', 'Average common edges'),
+                ('avg_common_nodes', 'Average common nodes')]
+
+    fig, axes = plt.subplots(2, 2, figsize=(10, 8))
+    for ax, (column, label) in zip(axes.flat, measures):
+        ax.scatter(others[column], others.evaluation, s=4, alpha=0.5)
+        correlation = np.corrcoef(others[column], others.evaluation)[0, 1]
+        ax.set_xlabel(label)
+        ax.set_ylabel('Evaluation')
+        ax.set_title(f'{label} (r = {correlation:.3f})')
+
+    name = Path(csv_filename).stem
+    fig.suptitle(name)
+    fig.tight_layout()
+    filename = Path(csv_filename).with_suffix('.png')
+    plt.savefig(filename, dpi=300, bbox_inches='tight')
+    plt.close(fig)
+
+
 if __name__ =="__main__":
     parser = argparse.ArgumentParser(description='This script reads the result of a specified experiment, verifies the scores, and generates the visualisations')
-    parser.add_argument('experiment_dir', help='')
+    parser.add_argument('experiment_dir', nargs='?', help='')
+    parser.add_argument('--similarity', nargs='+', metavar='CSV',
+                        help='plot the fitness-similarity CSV files of SimilarityAnalysis instead')
     args = parser.parse_args()
+
+    if args.similarity:
+        for csv_filename in args.similarity:
+            save_similarity_plots(csv_filename)
+        raise SystemExit(0)
+    if args.experiment_dir is None:
+        parser.error('experiment_dir is required')
     
     tspa_dict = read_instance(args.experiment_dir, "TSPA.csv")
     tspb_dict = read_instance(args.experiment_dir, "TSPB.csv")
@@ -9,25 +9,37 @@
 namespace LS {
 
     BaseSolver::BaseSolver(const std::string& instanceFilename, double fractionNodes)
+        : BaseSolver(DistanceMatrix::load(instanceFilename), instanceNameFromFilename(instanceFilename), fractionNodes)
+    {
+    }
+
+    BaseSolver::BaseSolver(std::shared_ptr<const DistanceMatrix> instance, const std::string& instanceName, double fractionNodes)
+        : instance(std::move(instance)),
+          distanceMatrix(this->instance->getDistanceMatrix()),
+          costs(this->instance->getCosts()),
+          instanceName(instanceName)
     {
-        DistanceMatrix distanceMatrixCreator;
-        distanceMatrixCreator.create(instanceFilename);
-        distanceMatrix = distanceMatrixCreator.getDistanceMatrix();
-        costs = distanceMatrixCreator.getCosts();
         totalNodes = costs.size();
 
+        numNodes = selectionSize(totalNodes, fractionNodes);
+    }
+
+    int BaseSolver::selectionSize(int totalNodes, double fractionNodes)
+    {
+        return static_cast<int>(totalNodes * fractionNodes);
+    }
+
+    std::string BaseSolver::instanceNameFromFilename(const std::string& instanceFilename)
+    {
         // Extract instance name from filename
         size_t delimiterPos = instanceFilename.find_last_of("/\\");
         std::string filename = (delimiterPos != std::string::npos) ? 
                                 instanceFilename.substr(delimiterPos + 1) : 
                                 instanceFilename;
         size_t dotPos = filename.find_last_of('.');
-        instanceName = (dotPos != std::string::npos) ? 
-                        filename.substr(0, dotPos) : 
-                        filename;
-
-        // Determine number of nodes to cover
-        numNodes = static_cast<int>(totalNodes * fractionNodes);
+        return (dotPos != std::string::npos) ? 
+                filename.substr(0, dotPos) : 
+                filename;
     }
 
     int BaseSolver::getTotalNodes() const
@@ -50,6 +62,16 @@ namespace LS {
         return costs;
     }
 
+    std::shared_ptr<const DistanceMatrix> BaseSolver::getInstance() const
+    {
+        return instance;
+    }
+
+    const std::string& BaseSolver::getInstanceName() const
+    {
+        return instanceName;
+    }
+
     void BaseSolver::printSolutionStats(const std::vector<int>& evaluations) const
     {
         int minEval = *std::min_element(evaluations.begin(), evaluations.end());
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 
 #include "Solution.h"
 #include "DistanceMatrix.h"
@@ -11,19 +12,28 @@ namespace LS {
 
     class BaseSolver {
     protected:
-        std::vector<std::vector<int>> distanceMatrix;
-        std::vector<int> costs;
+        // Instance data is read-only and shared between solvers of the same instance
+        std::shared_ptr<const DistanceMatrix> instance;
+        const std::vector<std::vector<int>>& distanceMatrix;
+        const std::vector<int>& costs;
         int totalNodes;
         int numNodes;
         std::string instanceName;
 
     public:
         BaseSolver(const std::string& instanceFilename, double fractionNodes);
-        
+        BaseSolver(std::shared_ptr<const DistanceMatrix> instance, const std::string& instanceName, double fractionNodes);
+
+        static std::string instanceNameFromFilename(const std::string& instanceFilename);
+        // Nodes a solution of fractionNodes of totalNodes nodes covers, rounded down
+        static int selectionSize(int totalNodes, double fractionNodes);
+
         int getTotalNodes() const;
         int getNumNodes() const;
         const std::vector<std::vector<int>>& getDistanceMatrix() const;
         const std::vector<int>& getCosts() const;
+        std::shared_ptr<const DistanceMatrix> getInstance() const;
+        const std::string& getInstanceName() const;
 
         void printSolutionStats(const std::vector<int>& evaluations) const;
     };
@@ -0,0 +1,78 @@
+#include "ConvergenceTrace.h"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace LS {
+
+    ConvergenceTrace::ConvergenceTrace(std::size_t capacity)
+        : points(capacity > 0 ? capacity : 1), next(0), recorded(0)
+    {
+    }
+
+    void ConvergenceTrace::clear()
+    {
+        next = 0;
+        recorded = 0;
+    }
+
+    std::size_t ConvergenceTrace::size() const
+    {
+        return recorded < points.size() ? recorded : points.size();
+    }
+
+    std::size_t ConvergenceTrace::dropped() const
+    {
+        return recorded - size();
+    }
+
+    std::vector<TracePoint> ConvergenceTrace::chronological() const
+    {
+        // Before the buffer wraps the oldest point is in slot 0, afterwards in the next slot
+        std::size_t oldest = recorded < points.size() ? 0 : next;
+        std::vector<TracePoint> ordered;
+        ordered.reserve(size());
+        for (std::size_t i = 0; i < size(); ++i)
+        {
+            ordered.emplace_back(points[(oldest + i) % points.size()]);
+        }
+        return ordered;
+    }
+
+    void ConvergenceTrace::writeCSV(const std::string& filename) const
+    {
+        std::ofstream file(filename);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Could not open file for writing: " + filename);
+        }
+
+        file << "elapsed_us;iteration;best_eval\n";
+        for (const auto& point : chronological())
+        {
+            file << point.elapsedUs << ";" << point.iteration << ";" << point.bestEval << "\n";
+        }
+    }
+
+    void ConvergenceTrace::writeBinary(const std::string& filename) const
+    {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Could not open file for writing: " + filename);
+        }
+
+        uint32_t count = static_cast<uint32_t>(size());
+        file.write("TRC1", 4);
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        for (const auto& point : chronological())
+        {
+            int32_t iteration = point.iteration;
+            int32_t bestEval = point.bestEval;
+            file.write(reinterpret_cast<const char*>(&point.elapsedUs), sizeof(point.elapsedUs));
+            file.write(reinterpret_cast<const char*>(&iteration), sizeof(iteration));
+            file.write(reinterpret_cast<const char*>(&bestEval), sizeof(bestEval));
+        }
+    }
+
+}
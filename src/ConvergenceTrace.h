@@ -0,0 +1,53 @@
+#ifndef CONVERGENCE_TRACE_H
+#define CONVERGENCE_TRACE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace LS {
+
+    // One improvement of the best solution during a time-budgeted run
+    struct TracePoint {
+        int64_t elapsedUs;
+        int iteration;
+        int bestEval;
+    };
+
+    // Convergence trace kept in a ring buffer allocated up front, so recording never
+    // allocates. Once full, the oldest points are overwritten and the plateau is kept.
+    class ConvergenceTrace {
+    private:
+        std::vector<TracePoint> points;
+        std::size_t next;
+        std::size_t recorded;
+
+    public:
+        explicit ConvergenceTrace(std::size_t capacity = 4096);
+
+        void clear();
+
+        void record(int64_t elapsedUs, int iteration, int bestEval)
+        {
+            points[next] = TracePoint{ elapsedUs, iteration, bestEval };
+            next = next + 1 == points.size() ? 0 : next + 1;
+            ++recorded;
+        }
+
+        // Number of points held and number of overwritten ones
+        std::size_t size() const;
+        std::size_t dropped() const;
+        // Held points, oldest first
+        std::vector<TracePoint> chronological() const;
+
+        // CSV with the header elapsed_us;iteration;best_eval
+        void writeCSV(const std::string& filename) const;
+        // Magic "TRC1", uint32 count, then int64 elapsed_us, int32 iteration, int32 best_eval per
+        // point in native byte order (the format written by the C trace_write_binary)
+        void writeBinary(const std::string& filename) const;
+    };
+
+}
+
+#endif // CONVERGENCE_TRACE_H
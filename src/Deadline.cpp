@@ -0,0 +1,89 @@
+#include "Deadline.h"
+
+#include <chrono>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define LS_DEADLINE_TSC 1
+#endif
+
+namespace LS {
+
+    namespace {
+
+        uint64_t steadyNanoseconds()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+#ifdef LS_DEADLINE_TSC
+        // Counts ticks over a millisecond of steady_clock; assumes an invariant TSC, which
+        // every x86 CPU of the last decade provides
+        double calibrateTicksPerMicrosecond()
+        {
+            uint64_t startNs = steadyNanoseconds();
+            uint64_t startTicks = __rdtsc();
+            uint64_t endNs;
+            do
+            {
+                endNs = steadyNanoseconds();
+            } while (endNs - startNs < 1000000);
+            uint64_t endTicks = __rdtsc();
+            return static_cast<double>(endTicks - startTicks) * 1000.0 / static_cast<double>(endNs - startNs);
+        }
+#endif
+
+    }
+
+    Deadline::Deadline(const std::atomic<bool>* cancelFlag)
+        : endTicks(std::numeric_limits<uint64_t>::max()),
+          cancelFlag(cancelFlag),
+          countdown(CHECK_INTERVAL),
+          expired(false)
+    {
+    }
+
+    Deadline::Deadline(double budgetMicroseconds, const std::atomic<bool>* cancelFlag)
+        : Deadline(cancelFlag)
+    {
+        double budgetTicks = budgetMicroseconds > 0 ? budgetMicroseconds * ticksPerMicrosecond() : 0.0;
+        uint64_t now = nowTicks();
+        if (budgetTicks < static_cast<double>(std::numeric_limits<uint64_t>::max() - now))
+        {
+            endTicks = now + static_cast<uint64_t>(budgetTicks);
+        }
+    }
+
+    bool Deadline::check()
+    {
+        countdown = CHECK_INTERVAL;
+        if (!expired)
+        {
+            expired = nowTicks() >= endTicks ||
+                      (cancelFlag != nullptr && cancelFlag->load(std::memory_order_relaxed));
+        }
+        return expired;
+    }
+
+    uint64_t Deadline::nowTicks()
+    {
+#ifdef LS_DEADLINE_TSC
+        return __rdtsc();
+#else
+        return steadyNanoseconds();
+#endif
+    }
+
+    double Deadline::ticksPerMicrosecond()
+    {
+#ifdef LS_DEADLINE_TSC
+        static const double ticks = calibrateTicksPerMicrosecond();
+        return ticks;
+#else
+        return 1000.0;
+#endif
+    }
+
+}
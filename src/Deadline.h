@@ -0,0 +1,54 @@
+#ifndef LS_DEADLINE_H
+#define LS_DEADLINE_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace LS {
+
+    // Cooperative time budget of a run, polled from the inner loops of its searches.
+    // poll() costs a decrement per call and reads the clock only every CHECK_INTERVAL calls;
+    // on x86 the clock is the time-stamp counter, calibrated against steady_clock once per
+    // process. Expiry is sticky. A Deadline is polled by one thread; copies poll independently
+    // and share the end time and the cancellation flag.
+    class Deadline {
+    public:
+        // About a microsecond of move evaluations between clock reads
+        static const int CHECK_INTERVAL = 256;
+
+    private:
+        uint64_t endTicks;
+        const std::atomic<bool>* cancelFlag;
+        int countdown;
+        bool expired;
+
+    public:
+        // Never expires, unless cancelFlag (if given) is set
+        explicit Deadline(const std::atomic<bool>* cancelFlag = nullptr);
+        // Expires budgetMicroseconds from now, or earlier when cancelFlag is set
+        explicit Deadline(double budgetMicroseconds, const std::atomic<bool>* cancelFlag = nullptr);
+
+        bool poll()
+        {
+            if (--countdown > 0)
+            {
+                return expired;
+            }
+            return check();
+        }
+
+        // Reads the clock now; returns whether the budget is used up or the run was cancelled
+        bool check();
+
+        bool isExpired() const
+        {
+            return expired;
+        }
+
+        static uint64_t nowTicks();
+        static double ticksPerMicrosecond();
+    };
+
+}
+
+#endif // LS_DEADLINE_H
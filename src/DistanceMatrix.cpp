@@ -3,9 +3,30 @@
 
 #include <cmath>
 #include <iostream>
+#include <stdexcept>
 
 namespace LS {
 
+    std::shared_ptr<const DistanceMatrix> DistanceMatrix::load(const std::string& filename)
+    {
+        auto matrix = std::make_shared<DistanceMatrix>();
+        matrix->create(filename);
+        return matrix;
+    }
+
+    std::shared_ptr<const DistanceMatrix> DistanceMatrix::fromCoordinates(const std::vector<int>& xs, const std::vector<int>& ys,
+                                                                          const std::vector<int>& nodeCosts)
+    {
+        if (xs.empty() || xs.size() != ys.size() || xs.size() != nodeCosts.size())
+        {
+            throw std::runtime_error("Instance needs one x, y and cost per node, got " + std::to_string(xs.size()) + ", " +
+                                     std::to_string(ys.size()) + " and " + std::to_string(nodeCosts.size()));
+        }
+        auto matrix = std::make_shared<DistanceMatrix>();
+        matrix->create(xs, ys, nodeCosts);
+        return matrix;
+    }
+
     void DistanceMatrix::readCoordinates(const std::string& filename,
                                          std::vector<int>& xs,
                                          std::vector<int>& ys)
@@ -44,8 +65,22 @@ namespace LS {
         std::vector<int> xs, ys;
 
         readCoordinates(filename, xs, ys);
+        computeDistances(xs, ys);
+    }
 
+    void DistanceMatrix::create(const std::vector<int>& xs, const std::vector<int>& ys, const std::vector<int>& nodeCosts)
+    {
+        // Builds an instance held in memory, e.g. a generated one
+        costs = nodeCosts;
+        computeDistances(xs, ys);
+    }
+
+    void DistanceMatrix::computeDistances(const std::vector<int>& xs, const std::vector<int>& ys)
+    {
         size_t size = xs.size();
+        xCoordinates = xs;
+        yCoordinates = ys;
+        distanceMatrix.clear();
         distanceMatrix.reserve(size);
         for (size_t i = 0; i < size; ++i)
         {
@@ -72,6 +107,16 @@ namespace LS {
         return costs;
     }
 
+    const std::vector<int>& DistanceMatrix::getXCoordinates() const
+    {
+        return xCoordinates;
+    }
+
+    const std::vector<int>& DistanceMatrix::getYCoordinates() const
+    {
+        return yCoordinates;
+    }
+
     void DistanceMatrix::printDistanceMatrix() const
     {
         // Print the Distance Matrix
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 
 namespace LS {
 
@@ -10,14 +11,27 @@ namespace LS {
     private:
         std::vector<std::vector<int>> distanceMatrix;
         std::vector<int> costs;
+        // Coordinates the distances were computed from
+        std::vector<int> xCoordinates;
+        std::vector<int> yCoordinates;
+
+        void computeDistances(const std::vector<int>& xs, const std::vector<int>& ys);
 
     public:
+        static std::shared_ptr<const DistanceMatrix> load(const std::string& filename);
+        // Instance held in memory; throws std::runtime_error unless all three have one entry per node
+        static std::shared_ptr<const DistanceMatrix> fromCoordinates(const std::vector<int>& xs, const std::vector<int>& ys,
+                                                                     const std::vector<int>& nodeCosts);
+
         void create(const std::string& filename);
+        void create(const std::vector<int>& xs, const std::vector<int>& ys, const std::vector<int>& nodeCosts);
         void readCoordinates(const std::string& filename,
                              std::vector<int>& xs,
                              std::vector<int>& ys);
         const std::vector<std::vector<int>>& getDistanceMatrix() const;
         const std::vector<int>& getCosts() const;
+        const std::vector<int>& getXCoordinates() const;
+        const std::vector<int>& getYCoordinates() const;
         void printDistanceMatrix() const;
     };
 
@@ -0,0 +1,323 @@
+#include "EmbeddedSolver.h"
+#include "BaseSolver.h"
+#include "LocalSearchSolver.h"
+#include "LSNLocalSearchSolver.h"
+#include "HEASolver.h"
+#include "RandomSolution.h"
+#include "ThreadPool.h"
+#include "Deadline.h"
+
+#include "ils.h"
+#include "spatial_grid.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace LS {
+
+    struct EmbeddedSolver::Construction {
+        SpatialGrid grid{};
+        Algo* algo = nullptr;
+
+        ~Construction()
+        {
+            std::free(algo);
+            spatial_grid_free(&grid);
+        }
+    };
+
+    void SolverOptions::apply(const std::string& key, const std::string& value)
+    {
+        // std::stoull and std::stoul accept a sign and wrap "-1" around to the largest value
+        if ((key == "seed" || key == "workers" || key == "eval-threads") && value.find('-') != std::string::npos)
+        {
+            throw std::runtime_error("Invalid value for " + key + ": " + value);
+        }
+        try
+        {
+            if (key == "algorithm")
+                algorithm = value;
+            else if (key == "fraction")
+                fractionNodes = std::stod(value);
+            else if (key == "seed")
+                seed = std::stoull(value);
+            else if (key == "population")
+                populationSize = std::stoi(value);
+            else if (key == "workers")
+                workers = static_cast<unsigned int>(std::stoul(value));
+            else if (key == "perturbation")
+                perturbationStrength = std::stoi(value);
+            else if (key == "eval-threads")
+                evalThreads = static_cast<unsigned int>(std::stoul(value));
+            else
+                throw std::runtime_error("Unknown solver option: " + key);
+        }
+        catch (const std::logic_error&)
+        {
+            // std::stoi and friends throw invalid_argument or out_of_range
+            throw std::runtime_error("Invalid value for " + key + ": " + value);
+        }
+    }
+
+    void SolverOptions::validate() const
+    {
+        if (algorithm != "ls" && algorithm != "lns" && algorithm != "lns-ls" && algorithm != "hea" &&
+            algorithm != "hea-ls" && algorithm != "ils" && algorithm != "nn-end" && algorithm != "nn-anywhere")
+        {
+            throw std::runtime_error("Unknown algorithm: " + algorithm);
+        }
+        if (fractionNodes <= 0.0 || fractionNodes > 1.0)
+        {
+            throw std::runtime_error("The fraction of nodes must be in (0, 1]");
+        }
+        if (populationSize < 2)
+        {
+            throw std::runtime_error("The HEA population needs at least 2 members");
+        }
+        if (workers < 1)
+        {
+            throw std::runtime_error("At least one worker is needed");
+        }
+        if (perturbationStrength < 0)
+        {
+            throw std::runtime_error("The perturbation strength must not be negative");
+        }
+        if (evalThreads < 1)
+        {
+            throw std::runtime_error("At least one evaluation thread is needed");
+        }
+    }
+
+    EmbeddedSolver::EmbeddedSolver(std::shared_ptr<const DistanceMatrix> instance, const SolverOptions& options)
+        : instance(std::move(instance)),
+          options(options),
+          rng(options.seed),
+          selectionSize(0),
+          cancelled(false),
+          cancelledFlag(0),
+          ils(nullptr)
+    {
+        if (this->instance == nullptr)
+        {
+            throw std::runtime_error("No instance given");
+        }
+        options.validate();
+
+        if (options.evalThreads > 1)
+        {
+            evaluationPool.reset(new ThreadPool(options.evalThreads));
+        }
+
+        const std::string name = "embedded";
+        int totalNodes = static_cast<int>(this->instance->getCosts().size());
+        selectionSize = BaseSolver::selectionSize(totalNodes, options.fractionNodes);
+        if (selectionSize < 3)
+        {
+            throw std::runtime_error("The fraction of nodes selects " + std::to_string(selectionSize) + " of " +
+                                     std::to_string(totalNodes) + " nodes, fewer than the 3 a cycle needs");
+        }
+        // LNS and HEA draw a new start on every run, so this one only initialises them
+        RandomSolution initialSolution;
+        initialSolution.generate(totalNodes, selectionSize, rng);
+        if (options.algorithm == "lns" || options.algorithm == "lns-ls")
+        {
+            lns.reset(new LSNLocalSearchSolver(this->instance, name, options.fractionNodes, initialSolution));
+            lns->seed(rng());
+            lns->setCancelFlag(&cancelled);
+            lns->setParallelEvaluation(evaluationPool.get());
+        }
+        else if (options.algorithm == "hea" || options.algorithm == "hea-ls")
+        {
+            hea.reset(new HEASolver(this->instance, name, options.fractionNodes, initialSolution));
+            hea->seed(rng());
+            hea->setPopulationSize(options.populationSize);
+            hea->setCancelFlag(&cancelled);
+            hea->setParallelEvaluation(evaluationPool.get());
+            if (options.workers > 1)
+            {
+                workerPool.reset(new ThreadPool(options.workers));
+                hea->setWorkerPool(workerPool.get());
+            }
+        }
+        else if (options.algorithm == "nn-end" || options.algorithm == "nn-anywhere")
+        {
+            // The grid is built once from the (x, y, cost) rows read_file would produce
+            const std::vector<int>& xs = this->instance->getXCoordinates();
+            const std::vector<int>& ys = this->instance->getYCoordinates();
+            const std::vector<int>& costs = this->instance->getCosts();
+            std::vector<std::array<int, 3>> nodes(costs.size());
+            std::vector<int*> data(costs.size());
+            for (std::size_t i = 0; i < costs.size(); ++i)
+            {
+                nodes[i] = { xs[i], ys[i], costs[i] };
+                data[i] = nodes[i].data();
+            }
+            construction.reset(new Construction());
+            if (!spatial_grid_build(&construction->grid, data.data(), totalNodes))
+            {
+                throw std::runtime_error("Could not build the spatial grid");
+            }
+            if (options.algorithm == "nn-end")
+            {
+                NearestNeighboursEndInsert* nn = create_NearestNeighboursEndInsert(&construction->grid);
+                if (nn != nullptr) nn->solution_size = selectionSize;
+                construction->algo = reinterpret_cast<Algo*>(nn);
+            }
+            else
+            {
+                NearestNeighboursAnywhereInsert* nn = create_NearestNeighboursAnywhereInsert(&construction->grid);
+                if (nn != nullptr) nn->solution_size = selectionSize;
+                construction->algo = reinterpret_cast<Algo*>(nn);
+            }
+            if (construction->algo == nullptr)
+            {
+                throw std::runtime_error("Could not create " + options.algorithm);
+            }
+        }
+        if (options.algorithm == "ils" || construction != nullptr)
+        {
+            for (const auto& row : this->instance->getDistanceMatrix())
+            {
+                rows.push_back(row.data());
+            }
+        }
+    }
+
+    EmbeddedSolver::~EmbeddedSolver()
+    {
+        if (ils != nullptr)
+        {
+            std::free(const_cast<char*>(ils->name));
+            std::free(ils);
+        }
+    }
+
+    const SolverOptions& EmbeddedSolver::getOptions() const
+    {
+        return options;
+    }
+
+    const SolveResult& EmbeddedSolver::getResult() const
+    {
+        return result;
+    }
+
+    void EmbeddedSolver::cancel()
+    {
+        cancelled.store(true, std::memory_order_relaxed);
+        __atomic_store_n(&cancelledFlag, 1, __ATOMIC_RELAXED);
+    }
+
+    void EmbeddedSolver::solveLocalSearch(double timeLimitMs)
+    {
+        int totalNodes = static_cast<int>(instance->getCosts().size());
+        RandomSolution start;
+        start.generate(totalNodes, selectionSize, rng);
+        LocalSearchSolver solver(instance, "embedded", options.fractionNodes, start);
+        solver.seed(rng());
+        solver.setParallelEvaluation(evaluationPool.get());
+        Deadline deadline(timeLimitMs * 1000, &cancelled);
+        solver.runBasic("TWO_EDGES", "STEEPEST", &deadline);
+        result.tour = solver.getBestFullSolution().getNodes();
+        result.evaluation = solver.getBestSolutionEval();
+        result.iterations = 0;
+    }
+
+    void EmbeddedSolver::solveILS(double timeLimitMs)
+    {
+        if (ils == nullptr)
+        {
+            ILS* created = create_ILS(static_cast<int>(timeLimitMs), options.perturbationStrength);
+            if (created == nullptr)
+            {
+                throw std::runtime_error("Could not create ILS");
+            }
+            created->num_islands = static_cast<int>(options.workers);
+            created->solution_size = selectionSize;
+            created->quiet = 1;
+            created->cancel_flag = &cancelledFlag;
+            ils = &created->base;
+        }
+        ILS* iteratedLocalSearch = reinterpret_cast<ILS*>(ils);
+        iteratedLocalSearch->max_time_ms = static_cast<int>(timeLimitMs);
+        iteratedLocalSearch->migration_interval_ms = std::max(1, static_cast<int>(timeLimitMs) / 10);
+
+        ::Rng cRng;
+        rng_seed(&cRng, rng());
+        Result res = ils->solve(ils, rows.data(), static_cast<int>(rows.size()), instance->getCosts().data(), 0, &cRng);
+        if (res.bestSolution == nullptr)
+        {
+            free_Result(res);
+            throw std::runtime_error("ILS failed");
+        }
+        result.tour.assign(res.bestSolution, res.bestSolution + res.bestSolutionSize);
+        result.evaluation = res.bestCost;
+        result.iterations = iteratedLocalSearch->last_iterations;
+        free_Result(res);
+    }
+
+    void EmbeddedSolver::solveConstruction()
+    {
+        ::Rng cRng;
+        rng_seed(&cRng, rng());
+        Algo* algo = construction->algo;
+        // One construction from every start node
+        Result res = algo->solve(algo, rows.data(), static_cast<int>(rows.size()), instance->getCosts().data(), 1, &cRng);
+        if (res.bestSolution == nullptr)
+        {
+            free_Result(res);
+            throw std::runtime_error(std::string(algo->name) + " failed");
+        }
+        result.tour.assign(res.bestSolution, res.bestSolution + res.bestSolutionSize);
+        result.evaluation = res.bestCost;
+        result.iterations = static_cast<int>(rows.size());
+        free_Result(res);
+    }
+
+    const SolveResult& EmbeddedSolver::solve(double timeLimitMs)
+    {
+        if (!(timeLimitMs > 0))
+        {
+            throw std::runtime_error("The time limit must be positive");
+        }
+        cancelled.store(false, std::memory_order_relaxed);
+        __atomic_store_n(&cancelledFlag, 0, __ATOMIC_RELAXED);
+        auto start = std::chrono::steady_clock::now();
+
+        bool innerLocalSearch = options.algorithm == "lns-ls" || options.algorithm == "hea-ls";
+        if (lns != nullptr)
+        {
+            lns->run(timeLimitMs * 1000, innerLocalSearch);
+            result.tour = lns->getBestFullSolution().getNodes();
+            result.evaluation = lns->getBestSolutionEval();
+            // Also clears the counts, which would otherwise grow by one per solve
+            result.iterations = static_cast<int>(lns->getAverageIterations());
+        }
+        else if (hea != nullptr)
+        {
+            hea->run(timeLimitMs * 1000, innerLocalSearch);
+            result.tour = hea->getBestFullSolution().getNodes();
+            result.evaluation = hea->getBestSolutionEval();
+            result.iterations = static_cast<int>(hea->getAverageIterations());
+        }
+        else if (options.algorithm == "ils")
+        {
+            solveILS(timeLimitMs);
+        }
+        else if (construction != nullptr)
+        {
+            solveConstruction();
+        }
+        else
+        {
+            solveLocalSearch(timeLimitMs);
+        }
+
+        result.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+}
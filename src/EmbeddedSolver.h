@@ -0,0 +1,104 @@
+#ifndef EMBEDDED_SOLVER_H
+#define EMBEDDED_SOLVER_H
+
+#include "DistanceMatrix.h"
+#include "RandomGenerator.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct Algo;
+
+namespace LS {
+
+    class LSNLocalSearchSolver;
+    class HEASolver;
+    class ThreadPool;
+
+    // Settings of an EmbeddedSolver, settable by name like the flags of ExperimentConfig
+    struct SolverOptions {
+        // "ls" (one steepest 2-edge descent), "lns", "lns-ls", "hea", "hea-ls", "ils" (the
+        // iterated local search of 01_greedy_heuristics), "nn-end" or "nn-anywhere" (its
+        // nearest-neighbour constructions from every start node, which ignore the time limit);
+        // "-ls" descends after every repair. Every algorithm selects
+        // BaseSolver::selectionSize(nodes, fractionNodes) nodes, which must be at least 3.
+        std::string algorithm = "lns-ls";
+        double fractionNodes = 0.5;
+        uint64_t seed = 1;
+        int populationSize = 20;
+        // Threads evolving the HEA population, or ILS islands
+        unsigned int workers = 1;
+        int perturbationStrength = 5; // moves of an ILS perturbation
+        // Threads splitting each steepest sweep of ls, lns and hea (with one worker) on
+        // instances of at least LocalSearchSolver::DEFAULT_PARALLEL_THRESHOLD nodes; 1 sweeps
+        // serially. A split sweep finds the move a serial one finds.
+        unsigned int evalThreads = 1;
+
+        // Keys are algorithm, fraction, seed, population, workers, perturbation and
+        // eval-threads; throws std::runtime_error on unknown keys or invalid values
+        void apply(const std::string& key, const std::string& value);
+        void validate() const;
+    };
+
+    struct SolveResult {
+        std::vector<int> tour;
+        int evaluation = 0;
+        int iterations = 0; // of LNS, HEA and ILS, constructions of NN, 0 for a single descent
+        double elapsedMs = 0.0;
+    };
+
+    // Solver for embedding in another process: takes an instance held in memory and returns
+    // its results in memory. Successive solves are independent runs drawn from one seeded
+    // stream, so a solver replays the same sequence of results for the same seed (except HEA
+    // with several workers and ILS with several islands). Not thread-safe, except cancel.
+    class EmbeddedSolver {
+    private:
+        std::shared_ptr<const DistanceMatrix> instance;
+        SolverOptions options;
+        Rng rng;
+        // Nodes of every solution, passed to the C++ and the C solvers alike
+        int selectionSize;
+        std::atomic<bool> cancelled;
+        // The same request for the C solvers, which poll a plain int with atomic loads
+        int cancelledFlag;
+        std::unique_ptr<ThreadPool> workerPool;
+        std::unique_ptr<ThreadPool> evaluationPool;
+        std::unique_ptr<LSNLocalSearchSolver> lns;
+        std::unique_ptr<HEASolver> hea;
+        Algo* ils; // the ILS of 01_greedy_heuristics, created on the first ILS solve
+        // Nearest-neighbour construction with the spatial grid of the instance
+        struct Construction;
+        std::unique_ptr<Construction> construction;
+        // Rows of the distance matrix, the int** view the C solvers take
+        std::vector<const int*> rows;
+        SolveResult result;
+
+        void solveLocalSearch(double timeLimitMs);
+        void solveILS(double timeLimitMs);
+        void solveConstruction();
+
+    public:
+        // Throws std::runtime_error on invalid options
+        EmbeddedSolver(std::shared_ptr<const DistanceMatrix> instance, const SolverOptions& options);
+        ~EmbeddedSolver();
+
+        EmbeddedSolver(const EmbeddedSolver&) = delete;
+        EmbeddedSolver& operator=(const EmbeddedSolver&) = delete;
+
+        const SolverOptions& getOptions() const;
+
+        // Runs the algorithm for timeLimitMs milliseconds and returns its best solution
+        const SolveResult& solve(double timeLimitMs);
+        // Result of the last solve, empty before the first
+        const SolveResult& getResult() const;
+        // Ends the running solve early, from any thread; no effect while none is running.
+        // "nn-end" and "nn-anywhere" ignore it and always complete their constructions.
+        void cancel();
+    };
+
+}
+
+#endif // EMBEDDED_SOLVER_H
@@ -0,0 +1,285 @@
+#include "ExperimentConfig.h"
+
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace LS {
+
+    namespace {
+
+        std::string trim(const std::string& text)
+        {
+            const char* whitespace = " \t\r\n";
+            std::size_t begin = text.find_first_not_of(whitespace);
+            if (begin == std::string::npos) return "";
+            std::size_t end = text.find_last_not_of(whitespace);
+            return text.substr(begin, end - begin + 1);
+        }
+
+        std::vector<std::string> splitList(const std::string& list)
+        {
+            std::vector<std::string> items;
+            std::stringstream stream(list);
+            std::string item;
+            while (std::getline(stream, item, ','))
+            {
+                item = trim(item);
+                if (!item.empty()) items.emplace_back(item);
+            }
+            return items;
+        }
+
+        template <typename T, typename Convert>
+        T parseNumber(const std::string& key, const std::string& value, Convert convert)
+        {
+            try
+            {
+                std::size_t used = 0;
+                T parsed = convert(value, &used);
+                if (used == value.size()) return parsed;
+            }
+            catch (const std::exception&)
+            {
+            }
+            throw std::runtime_error("Invalid value '" + value + "' for " + key);
+        }
+
+        int parseInt(const std::string& key, const std::string& value, int minValue)
+        {
+            int parsed = parseNumber<int>(key, value, [](const std::string& v, std::size_t* used) { return std::stoi(v, used); });
+            if (parsed < minValue)
+            {
+                throw std::runtime_error("Invalid value '" + value + "' for " + key);
+            }
+            return parsed;
+        }
+
+        double parseDouble(const std::string& key, const std::string& value)
+        {
+            return parseNumber<double>(key, value, [](const std::string& v, std::size_t* used) { return std::stod(v, used); });
+        }
+
+    }
+
+    ExperimentConfig::ExperimentConfig()
+        : seed(static_cast<uint64_t>(std::time(nullptr)))
+    {
+    }
+
+    std::string ExperimentConfig::usage(const std::string& program)
+    {
+        return "Usage: " + program + " [options] [instance.csv ...]\n"
+               "  --instances LIST     comma-separated instance files (default data/TSPA.csv,data/TSPB.csv)\n"
+               "  --algorithm NAME     lns, lns-ls (with inner local search) or all (default all);\n"
+               "                       hea, hea-ls and hea-all run the hybrid evolutionary algorithm instead\n"
+               "  --time-ms LIST       time limit per instance in ms, one value applies to all\n"
+               "                       (default 20173.5,22698.6 for the default instances)\n"
+               "  --repetitions N      runs per instance and algorithm (default 20)\n"
+               "  --fraction F         fraction of the nodes in a solution (default 0.5)\n"
+               "  --population N       members of an HEA population, at least 2 (default 20)\n"
+               "  --hea-workers N      threads evolving each HEA population asynchronously; above 1,\n"
+               "                       repetitions run one at a time and are not reproducible (default 1)\n"
+               "  --threads N          concurrent runs, 0 for all hardware threads (default 0)\n"
+               "  --eval-threads N     threads splitting each steepest sweep of a run on instances of\n"
+               "                       at least 1000 nodes; above 1, repetitions run one at a time\n"
+               "                       (default 1; a split sweep finds the move a serial one finds)\n"
+               "  --restart-after N    share the best solution between concurrent runs of an instance;\n"
+               "                       a run stalled for N iterations restarts from it (default 0, off;\n"
+               "                       results then depend on thread scheduling)\n"
+               "  --seed N             random seed (default current time)\n"
+               "  --output-dir DIR     directory of solutions and traces (default lab7/solutions)\n"
+               "  --config FILE        read key=value lines using the option names above\n"
+               "  --help               show this help\n";
+    }
+
+    void ExperimentConfig::apply(const std::string& key, const std::string& value)
+    {
+        if (key == "instances")
+        {
+            for (const auto& instance : splitList(value)) instances.emplace_back(instance);
+        }
+        else if (key == "algorithm")
+        {
+            if (value == "lns" || value == "hea")
+            {
+                runWithoutInnerLocalSearch = true;
+                runWithInnerLocalSearch = false;
+            }
+            else if (value == "lns-ls" || value == "hea-ls")
+            {
+                runWithoutInnerLocalSearch = false;
+                runWithInnerLocalSearch = true;
+            }
+            else if (value == "all" || value == "hea-all")
+            {
+                runWithoutInnerLocalSearch = true;
+                runWithInnerLocalSearch = true;
+            }
+            else
+            {
+                throw std::runtime_error("Unknown algorithm '" + value + "'");
+            }
+            solver = value.rfind("hea", 0) == 0 ? "hea" : "lns";
+        }
+        else if (key == "time-ms")
+        {
+            timeLimitsMs.clear();
+            for (const auto& item : splitList(value))
+            {
+                double limit = parseDouble(key, item);
+                if (limit <= 0) throw std::runtime_error("Invalid value '" + item + "' for " + key);
+                timeLimitsMs.emplace_back(limit);
+            }
+        }
+        else if (key == "repetitions")
+        {
+            repetitions = parseInt(key, value, 1);
+        }
+        else if (key == "fraction")
+        {
+            fractionNodes = parseDouble(key, value);
+            if (fractionNodes <= 0 || fractionNodes > 1)
+            {
+                throw std::runtime_error("Invalid value '" + value + "' for " + key);
+            }
+        }
+        else if (key == "population")
+        {
+            populationSize = parseInt(key, value, 2);
+        }
+        else if (key == "hea-workers")
+        {
+            heaWorkers = static_cast<unsigned int>(parseInt(key, value, 1));
+        }
+        else if (key == "threads")
+        {
+            threads = static_cast<unsigned int>(parseInt(key, value, 0));
+        }
+        else if (key == "eval-threads")
+        {
+            evalThreads = static_cast<unsigned int>(parseInt(key, value, 1));
+        }
+        else if (key == "restart-after")
+        {
+            restartAfter = parseInt(key, value, 0);
+        }
+        else if (key == "seed")
+        {
+            // std::stoull accepts a sign and wraps "-1" around to 2^64 - 1
+            if (value.find('-') != std::string::npos)
+            {
+                throw std::runtime_error("Invalid value '" + value + "' for " + key);
+            }
+            seed = parseNumber<uint64_t>(key, value, [](const std::string& v, std::size_t* used) { return std::stoull(v, used); });
+        }
+        else if (key == "output-dir")
+        {
+            outputDir = value;
+        }
+        else if (key == "config")
+        {
+            loadFile(value);
+        }
+        else
+        {
+            throw std::runtime_error("Unknown option '" + key + "'");
+        }
+    }
+
+    void ExperimentConfig::loadFile(const std::string& filename)
+    {
+        std::ifstream file(filename);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Could not open config file: " + filename);
+        }
+
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line))
+        {
+            ++lineNumber;
+            line = trim(line);
+            if (line.empty() || line[0] == '#') continue;
+
+            std::size_t separator = line.find('=');
+            if (separator == std::string::npos)
+            {
+                throw std::runtime_error("Expected key=value in " + filename + ":" + std::to_string(lineNumber));
+            }
+            apply(trim(line.substr(0, separator)), trim(line.substr(separator + 1)));
+        }
+    }
+
+    ExperimentConfig ExperimentConfig::parse(int argc, char** argv)
+    {
+        ExperimentConfig config;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0)
+            {
+                config.apply("instances", arg);
+                continue;
+            }
+
+            std::string key = arg.substr(2);
+            if (key == "help")
+            {
+                config.helpRequested = true;
+                return config;
+            }
+
+            std::string value;
+            std::size_t separator = key.find('=');
+            if (separator != std::string::npos)
+            {
+                value = key.substr(separator + 1);
+                key = key.substr(0, separator);
+            }
+            else if (i + 1 < argc)
+            {
+                value = argv[++i];
+            }
+            else
+            {
+                throw std::runtime_error("Missing value for --" + key);
+            }
+            config.apply(key, value);
+        }
+
+        // The default time limits were tuned for the default instances only
+        if (config.instances.empty())
+        {
+            config.instances = { "data/TSPA.csv", "data/TSPB.csv" };
+            if (config.timeLimitsMs.empty())
+            {
+                config.timeLimitsMs = { 20173.5, 22698.6 };
+            }
+        }
+        if (config.timeLimitsMs.empty())
+        {
+            throw std::runtime_error("--time-ms is required when instances are given");
+        }
+        config.validate();
+        return config;
+    }
+
+    double ExperimentConfig::timeLimitMs(std::size_t instanceIdx) const
+    {
+        return timeLimitsMs.size() == 1 ? timeLimitsMs[0] : timeLimitsMs[instanceIdx];
+    }
+
+    void ExperimentConfig::validate() const
+    {
+        if (timeLimitsMs.size() != 1 && timeLimitsMs.size() != instances.size())
+        {
+            throw std::runtime_error("Expected one time limit or one per instance, got " +
+                                     std::to_string(timeLimitsMs.size()) + " for " +
+                                     std::to_string(instances.size()) + " instances");
+        }
+    }
+
+}
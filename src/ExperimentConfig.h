@@ -0,0 +1,54 @@
+#ifndef EXPERIMENT_CONFIG_H
+#define EXPERIMENT_CONFIG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace LS {
+
+    // Settings of an LNS or HEA experiment, read from command-line flags and/or a config file
+    // of key=value lines using the long flag names
+    class ExperimentConfig {
+    public:
+        std::vector<std::string> instances;
+        // Per-instance time limits in milliseconds; a single value applies to every instance
+        std::vector<double> timeLimitsMs;
+        bool runWithoutInnerLocalSearch = true;
+        bool runWithInnerLocalSearch = true;
+        // "lns" or "hea", the solver behind both of the above
+        std::string solver = "lns";
+        // Members of an HEA population
+        int populationSize = 20;
+        // Threads evolving each HEA population asynchronously; with more than one the
+        // repetitions run one after another
+        unsigned int heaWorkers = 1;
+        int repetitions = 20;
+        double fractionNodes = 0.5;
+        unsigned int threads = 0; // 0 uses all hardware threads
+        // Threads splitting each steepest sweep of a run on instances of at least
+        // LocalSearchSolver::DEFAULT_PARALLEL_THRESHOLD nodes; with more than one the
+        // repetitions run one after another
+        unsigned int evalThreads = 1;
+        // Iterations without improvement after which a run continues from the best solution
+        // of the concurrent runs; 0 keeps runs independent
+        int restartAfter = 0;
+        uint64_t seed;
+        std::string outputDir = "lab7/solutions";
+        bool helpRequested = false;
+
+        ExperimentConfig();
+
+        // Throws std::runtime_error on unknown options or invalid values
+        static ExperimentConfig parse(int argc, char** argv);
+        static std::string usage(const std::string& program);
+
+        void apply(const std::string& key, const std::string& value);
+        void loadFile(const std::string& filename);
+        double timeLimitMs(std::size_t instanceIdx) const;
+        void validate() const;
+    };
+
+}
+
+#endif // EXPERIMENT_CONFIG_H
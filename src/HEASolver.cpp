@@ -0,0 +1,336 @@
+#include "HEASolver.h"
+#include "RandomSolution.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace LS {
+
+    namespace {
+
+        void atomicMin(std::atomic<int>& value, int candidate)
+        {
+            int current = value.load(std::memory_order_relaxed);
+            while (candidate < current &&
+                   !value.compare_exchange_weak(current, candidate, std::memory_order_relaxed))
+            {
+            }
+        }
+
+    }
+
+    HEASolver::Worker::Worker(std::shared_ptr<const DistanceMatrix> instance, const std::string& instanceName,
+                              double fractionNodes, const Solution& initialSolution)
+        : solver(std::move(instance), instanceName, fractionNodes, initialSolution)
+    {
+    }
+
+    HEASolver::HEASolver(const std::string& instanceFilename, double fractionNodes, const Solution& initialSolution)
+        : HEASolver(DistanceMatrix::load(instanceFilename), instanceNameFromFilename(instanceFilename),
+                    fractionNodes, initialSolution)
+    {
+    }
+
+    HEASolver::HEASolver(std::shared_ptr<const DistanceMatrix> instance, const std::string& instanceName,
+                         double fractionNodes, const Solution& initialSolution)
+        : LocalSearchSolver(std::move(instance), instanceName, fractionNodes, initialSolution),
+          initialSolution(initialSolution),
+          fractionNodes(fractionNodes),
+          populationSize(DEFAULT_POPULATION_SIZE),
+          workerPool(nullptr),
+          initialLocalSearchEvaluation(0),
+          trace(nullptr),
+          incumbent(nullptr),
+          restartAfter(0),
+          cancelFlag(nullptr),
+          iterations(0),
+          lastImprovement(0),
+          seedingAttempts(0),
+          seedingWorkers(0),
+          initialBest(0),
+          restartCount(0)
+    {
+    }
+
+    void HEASolver::setPopulationSize(int size)
+    {
+        if (size < 2)
+        {
+            throw std::runtime_error("The HEA population needs at least 2 members, got " + std::to_string(size));
+        }
+        populationSize = size;
+    }
+
+    int HEASolver::getPopulationSize() const
+    {
+        return populationSize;
+    }
+
+    void HEASolver::setWorkerPool(ThreadPool* pool)
+    {
+        workerPool = pool;
+    }
+
+    double HEASolver::getAverageIterations()
+    {
+        double avg = Utils::mean(iterationCounts);
+        iterationCounts.clear();
+        return avg;
+    }
+
+    const std::vector<int>& HEASolver::getIterationCounts() const
+    {
+        return iterationCounts;
+    }
+
+    int HEASolver::getInitialLocalSearchEval() const
+    {
+        return initialLocalSearchEvaluation;
+    }
+
+    const RunCounters& HEASolver::getRunCounters() const
+    {
+        return runCounters;
+    }
+
+    void HEASolver::setTrace(ConvergenceTrace* newTrace)
+    {
+        trace = newTrace;
+    }
+
+    void HEASolver::setIncumbent(SharedIncumbent* newIncumbent, int newRestartAfter)
+    {
+        incumbent = newIncumbent;
+        restartAfter = newRestartAfter;
+    }
+
+    int HEASolver::getRestartCount() const
+    {
+        return restartCount.load(std::memory_order_relaxed);
+    }
+
+    void HEASolver::setCancelFlag(const std::atomic<bool>* flag)
+    {
+        cancelFlag = flag;
+    }
+
+    bool HEASolver::accept(const Solution& solution, int evaluation, int iteration)
+    {
+        // A tour taken before is either still a member or was evicted by better ones, which
+        // only raise the bar, so it cannot enter again
+        uint64_t hash = solution.getHash();
+        if (seen->contains(hash) || !population->offer(solution, evaluation, hash))
+        {
+            return false;
+        }
+        seen->insert(hash);
+        // Only a new best member can improve the best solution, so the lock is rarely taken
+        if (evaluation > population->getBestEval())
+        {
+            return true;
+        }
+
+        std::lock_guard<std::mutex> lock(bestMutex);
+        if (evaluation < bestSolutionEvaluation)
+        {
+            // Copy assignment reuses the buffers of the previous best
+            bestSolution = solution;
+            bestSolutionEvaluation = evaluation;
+            lastImprovement.store(iteration, std::memory_order_relaxed);
+            if (trace != nullptr)
+            {
+                auto elapsed = std::chrono::steady_clock::now() - runStart;
+                trace->record(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(), iteration, evaluation);
+            }
+            if (incumbent != nullptr)
+            {
+                incumbent->publish(solution.getNodes(), evaluation);
+            }
+        }
+        return true;
+    }
+
+    void HEASolver::recombine(Worker& worker)
+    {
+        const auto& nodesA = worker.first.getNodes();
+        const auto& nodesB = worker.second.getNodes();
+        int sizeA = static_cast<int>(nodesA.size());
+        int sizeB = static_cast<int>(nodesB.size());
+        worker.secondPosition.assign(totalNodes, -1);
+        for (int i = 0; i < sizeB; ++i)
+        {
+            worker.secondPosition[nodesB[i]] = i;
+        }
+
+        // Nodes both parents have, in the first parent's order: every shared edge joins two
+        // of them that were consecutive in that parent, so it stays two consecutive nodes, and
+        // the repair only adds nodes of one parent or of neither
+        worker.childNodes.clear();
+        for (int i = 0; i < sizeA; ++i)
+        {
+            if (worker.secondPosition[nodesA[i]] >= 0)
+            {
+                worker.childNodes.push_back(nodesA[i]);
+            }
+        }
+        // The repair needs a cycle to insert into
+        if (worker.childNodes.size() < 2)
+        {
+            worker.childNodes = nodesA;
+        }
+        worker.child.setNodes(worker.childNodes);
+    }
+
+    bool HEASolver::insertIncumbent(Worker& worker, int iteration)
+    {
+        // The evaluation is polled first so that the tour is only copied when it pays off
+        int incumbentEval;
+        int bestEval = population->getBestEval();
+        if (incumbent->getBestEval() >= bestEval ||
+            !incumbent->read(worker.incumbentTour, incumbentEval) || incumbentEval >= bestEval)
+        {
+            return false;
+        }
+        worker.child.setNodes(worker.incumbentTour);
+        if (!accept(worker.child, incumbentEval, iteration))
+        {
+            return false;
+        }
+        restartCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void HEASolver::evolve(Worker& worker, Deadline deadline, bool innerLocalSearch)
+    {
+        // Start from clean counters, the thread may have run other work before
+        Instrumentation::take();
+        LocalSearchSolver& solver = worker.solver;
+
+        // Descents from random solutions until the population is full; the attempts are
+        // shared by the workers, so duplicates are drawn again a bounded number of times
+        RandomSolution randomSolution;
+        while (population->getSize() < populationSize &&
+               seedingAttempts.fetch_add(1, std::memory_order_relaxed) < 10 * populationSize && !deadline.check())
+        {
+            randomSolution.generate(totalNodes, numNodes, solver.getRng());
+            solver.setInitialSolutionCopy(randomSolution);
+            solver.runBasic("TWO_EDGES", "STEEPEST", &deadline);
+            atomicMin(initialBest, solver.getBestSolutionEval());
+            accept(solver.getBestFullSolution(), solver.getBestSolutionEval(), 0);
+        }
+        seedingWorkers.fetch_sub(1, std::memory_order_acq_rel);
+
+        while (!deadline.check())
+        {
+            if (!population->sampleParents(solver.getRng(), worker.first, worker.second))
+            {
+                // Other workers may still be descending towards the first two members
+                if (seedingWorkers.load(std::memory_order_acquire) == 0)
+                {
+                    break;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+            int iteration = iterations.fetch_add(1, std::memory_order_relaxed) + 1;
+
+            if (incumbent != nullptr && restartAfter > 0 &&
+                iteration - lastImprovement.load(std::memory_order_relaxed) > restartAfter)
+            {
+                lastImprovement.store(iteration, std::memory_order_relaxed);
+                insertIncumbent(worker, iteration);
+            }
+
+            {
+                // Recombination takes the place of the destroy phase of LNS
+                LS_TIME_PHASE(destroyNs);
+                recombine(worker);
+            }
+            solver.setInitialSolution(worker.child);
+
+            // A repair cut short by the deadline leaves a tour with too few nodes
+            if (!solver.repairBestSolution(&deadline))
+            {
+                break;
+            }
+            if (innerLocalSearch)
+            {
+                solver.runBasic("TWO_EDGES", "STEEPEST", &deadline);
+            }
+            accept(solver.getBestFullSolution(), solver.getBestSolutionEval(), iteration);
+        }
+
+        std::lock_guard<std::mutex> lock(bestMutex);
+        runCounters.add(Instrumentation::take());
+    }
+
+    void HEASolver::run(double timeLimitMicroseconds, bool innerLocalSearch)
+    {
+        int workerCount = workerPool != nullptr ? static_cast<int>(workerPool->size()) : 1;
+        // At least two members per shard, so that replacement still selects within a shard
+        int shardCount = std::max(1, std::min(workerCount, populationSize / 2));
+        population.reset(new PopulationServer(populationSize, shardCount));
+        if (seen == nullptr)
+        {
+            seen.reset(new SeenSet(SEEN_CAPACITY));
+        }
+        seen->clear();
+
+        // Every worker descends with its own solver, seeded from this solver's stream; they
+        // share the instance data
+        std::vector<Rng> streams = Rng::split(rng(), workerCount);
+        std::vector<std::unique_ptr<Worker>> workers;
+        for (int w = 0; w < workerCount; ++w)
+        {
+            workers.emplace_back(new Worker(instance, instanceName, fractionNodes, initialSolution));
+            workers.back()->solver.setRng(streams[w]);
+        }
+        // Sweeps are only split when the workers do not already occupy the threads
+        if (workerPool == nullptr)
+        {
+            workers[0]->solver.setParallelEvaluation(evaluationPool, parallelThreshold);
+        }
+
+        bestSolutionEvaluation = std::numeric_limits<int>::max();
+        runCounters = RunCounters();
+        iterations.store(0);
+        lastImprovement.store(0);
+        seedingAttempts.store(0);
+        seedingWorkers.store(workerCount);
+        initialBest.store(std::numeric_limits<int>::max());
+        restartCount.store(0);
+        if (trace != nullptr)
+        {
+            trace->clear();
+        }
+
+        runStart = std::chrono::steady_clock::now();
+        Deadline deadline(timeLimitMicroseconds, cancelFlag);
+        if (workerPool == nullptr)
+        {
+            evolve(*workers[0], deadline, innerLocalSearch);
+        }
+        else
+        {
+            // Each worker polls its own copy of the deadline
+            workerPool->parallelFor(workerCount, [&](int w, unsigned int)
+            {
+                evolve(*workers[w], deadline, innerLocalSearch);
+            });
+        }
+
+        if (population->getSize() == 0)
+        {
+            // Not even one descent fit into the budget
+            bestSolution = initialSolution;
+            bestSolutionEvaluation = initialSolution.evaluate(distanceMatrix, costs);
+            initialBest.store(bestSolutionEvaluation);
+        }
+        initialLocalSearchEvaluation = initialBest.load();
+        iterationCounts.emplace_back(iterations.load());
+    }
+
+}
@@ -0,0 +1,118 @@
+#ifndef HEA_SOLVER_H
+#define HEA_SOLVER_H
+
+#include "LocalSearchSolver.h"
+#include "Solution.h"
+#include "Instrumentation.h"
+#include "ConvergenceTrace.h"
+#include "SharedIncumbent.h"
+#include "PopulationServer.h"
+#include "TourHash.h"
+#include "ThreadPool.h"
+#include "Deadline.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace LS {
+
+    // Steady-state hybrid evolutionary algorithm over a population of local optima. Each
+    // iteration recombines two random members, keeping the nodes and edges both share and
+    // repairing the rest with greedy-cycle insertion, optionally descends from the offspring,
+    // and lets it replace the worst member unless it duplicates one. Tours the population took
+    // once are remembered by hash, so clones of them are rejected in O(1) without touching it.
+    // With a worker pool, every worker of the pool evolves the shared population on its own,
+    // so a slow descent never holds the others back.
+    class HEASolver : public LocalSearchSolver {
+    public:
+        static const int DEFAULT_POPULATION_SIZE = 20;
+        // Hashes of accepted tours remembered per run
+        static const int SEEN_CAPACITY = 1 << 16;
+
+    private:
+        // State of one worker during a run
+        struct Worker {
+            LocalSearchSolver solver;
+            Solution first;
+            Solution second;
+            Solution child;
+            std::vector<int> childNodes;
+            std::vector<int> secondPosition;
+            std::vector<int> incumbentTour;
+
+            Worker(std::shared_ptr<const DistanceMatrix> instance, const std::string& instanceName,
+                   double fractionNodes, const Solution& initialSolution);
+        };
+
+        Solution initialSolution;
+        double fractionNodes;
+        int populationSize;
+        std::unique_ptr<PopulationServer> population;
+        std::unique_ptr<SeenSet> seen;
+        ThreadPool* workerPool;
+        std::vector<int> iterationCounts;
+        int initialLocalSearchEvaluation;
+        RunCounters runCounters;
+        ConvergenceTrace* trace;
+        SharedIncumbent* incumbent;
+        int restartAfter;
+        const std::atomic<bool>* cancelFlag;
+
+        // Shared by the workers of a run; bestMutex guards the best solution, the trace and
+        // runCounters
+        std::mutex bestMutex;
+        std::chrono::steady_clock::time_point runStart;
+        std::atomic<int> iterations;
+        std::atomic<int> lastImprovement;
+        std::atomic<int> seedingAttempts;
+        std::atomic<int> seedingWorkers;
+        std::atomic<int> initialBest;
+        std::atomic<int> restartCount;
+
+        // Offers the solution to the population and records it if it is a new best;
+        // returns whether the population took it
+        bool accept(const Solution& solution, int evaluation, int iteration);
+        void recombine(Worker& worker);
+        bool insertIncumbent(Worker& worker, int iteration);
+        void evolve(Worker& worker, Deadline deadline, bool innerLocalSearch);
+
+    public:
+        HEASolver(const std::string& instanceFilename, double fractionNodes, const Solution& initialSolution);
+        HEASolver(std::shared_ptr<const DistanceMatrix> instance, const std::string& instanceName,
+                  double fractionNodes, const Solution& initialSolution);
+
+        void setPopulationSize(int size);
+        int getPopulationSize() const;
+        // Evolves with every worker of pool, nullptr evolves on the calling thread only. The
+        // pool must not be the one running this solver. Runs on a pool are not reproducible,
+        // as the order in which offspring reach the population depends on scheduling.
+        void setWorkerPool(ThreadPool* pool);
+        double getAverageIterations();
+        const std::vector<int>& getIterationCounts() const;
+        // Best member of the initial population
+        int getInitialLocalSearchEval() const;
+        // Counters of the last run, all zero unless built with LS_INSTRUMENTATION
+        const RunCounters& getRunCounters() const;
+        // Records every improvement of the best solution of the following runs, nullptr disables
+        void setTrace(ConvergenceTrace* newTrace);
+        // Publishes every improvement of the best solution to newIncumbent, nullptr disables.
+        // With newRestartAfter > 0, a run whose best has not improved for that many iterations
+        // replaces its worst member with the incumbent when the incumbent is better than its best.
+        void setIncumbent(SharedIncumbent* newIncumbent, int newRestartAfter = 0);
+        // Incumbents taken into the population during the last run
+        int getRestartCount() const;
+        // Runs stop early, within a few microseconds of work, once *flag is set; nullptr disables
+        void setCancelFlag(const std::atomic<bool>* flag);
+
+        // Builds the population by descending from random solutions, then evolves it until the
+        // time limit; innerLocalSearch also descends from every offspring
+        void run(double timeLimitMicroseconds, bool innerLocalSearch);
+    };
+
+}
+
+#endif // HEA_SOLVER_H
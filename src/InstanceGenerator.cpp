@@ -0,0 +1,185 @@
+#include "InstanceGenerator.h"
+#include "RandomGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace LS {
+
+    namespace {
+
+        // Standard normal draw (Box-Muller); std::normal_distribution differs between
+        // standard libraries, so instances would not be reproducible across platforms
+        double normal(Rng& rng)
+        {
+            double u1 = 1.0 - rng.uniformReal(); // (0, 1], keeps log finite
+            double u2 = rng.uniformReal();
+            return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+        }
+
+        int clampInt(double value, int low, int high)
+        {
+            return static_cast<int>(std::lround(std::min<double>(std::max<double>(value, low), high)));
+        }
+
+        int drawCost(const GeneratorConfig& config, Rng& rng)
+        {
+            const int range = config.maxCost - config.minCost;
+            switch (config.costDistribution)
+            {
+            case CostDistribution::Normal:
+                // Centered in the range, which then spans +-3 standard deviations
+                return clampInt(config.minCost + range / 2.0 + normal(rng) * range / 6.0, config.minCost, config.maxCost);
+            case CostDistribution::Exponential:
+                // Mostly cheap nodes with a long tail of expensive ones, mean a quarter of the range
+                return clampInt(config.minCost - std::log(1.0 - rng.uniformReal()) * range / 4.0, config.minCost, config.maxCost);
+            case CostDistribution::Uniform:
+            default:
+                return rng.uniformInt(config.minCost, config.maxCost);
+            }
+        }
+
+        void generateUniform(const GeneratorConfig& config, Rng& rng, InstanceData& instance)
+        {
+            for (int i = 0; i < config.size; ++i)
+            {
+                instance.xs.push_back(rng.uniformInt(0, config.width));
+                instance.ys.push_back(rng.uniformInt(0, config.height));
+                instance.costs.push_back(drawCost(config, rng));
+            }
+        }
+
+        void generateClustered(const GeneratorConfig& config, Rng& rng, InstanceData& instance)
+        {
+            int clusters = config.clusters > 0 ? config.clusters : std::max(4, config.size / 1000);
+            double spread = config.clusterSpread > 0 ? config.clusterSpread : config.width / 40.0;
+
+            std::vector<int> centerXs, centerYs;
+            for (int c = 0; c < clusters; ++c)
+            {
+                centerXs.push_back(rng.uniformInt(0, config.width));
+                centerYs.push_back(rng.uniformInt(0, config.height));
+            }
+            for (int i = 0; i < config.size; ++i)
+            {
+                int c = static_cast<int>(rng.bounded(static_cast<uint32_t>(clusters)));
+                instance.xs.push_back(clampInt(centerXs[c] + normal(rng) * spread, 0, config.width));
+                instance.ys.push_back(clampInt(centerYs[c] + normal(rng) * spread, 0, config.height));
+                instance.costs.push_back(drawCost(config, rng));
+            }
+        }
+
+        // Row-major lattice with cells of roughly square shape covering the area
+        void generateGrid(const GeneratorConfig& config, Rng& rng, InstanceData& instance)
+        {
+            int columns = std::max(1, static_cast<int>(std::ceil(std::sqrt(
+                static_cast<double>(config.size) * config.width / std::max(1, config.height)))));
+            int rows = (config.size + columns - 1) / columns;
+            double stepX = static_cast<double>(config.width) / columns;
+            double stepY = static_cast<double>(config.height) / rows;
+            for (int i = 0; i < config.size; ++i)
+            {
+                instance.xs.push_back(static_cast<int>((i % columns + 0.5) * stepX));
+                instance.ys.push_back(static_cast<int>((i / columns + 0.5) * stepY));
+                instance.costs.push_back(drawCost(config, rng));
+            }
+        }
+
+    }
+
+    void GeneratorConfig::validate() const
+    {
+        if (size <= 0)
+        {
+            throw std::runtime_error("Instance size must be positive");
+        }
+        if (width <= 0 || height <= 0)
+        {
+            throw std::runtime_error("Width and height must be positive");
+        }
+        if (minCost < 0 || maxCost < minCost)
+        {
+            throw std::runtime_error("Costs must satisfy 0 <= min cost <= max cost");
+        }
+        if (clusters < 0 || clusterSpread < 0)
+        {
+            throw std::runtime_error("Cluster count and spread must not be negative");
+        }
+    }
+
+    Layout parseLayout(const std::string& name)
+    {
+        if (name == "uniform") return Layout::Uniform;
+        if (name == "clustered") return Layout::Clustered;
+        if (name == "grid") return Layout::Grid;
+        throw std::runtime_error("Unknown layout: " + name + " (expected uniform, clustered or grid)");
+    }
+
+    CostDistribution parseCostDistribution(const std::string& name)
+    {
+        if (name == "uniform") return CostDistribution::Uniform;
+        if (name == "normal") return CostDistribution::Normal;
+        if (name == "exponential") return CostDistribution::Exponential;
+        throw std::runtime_error("Unknown cost distribution: " + name + " (expected uniform, normal or exponential)");
+    }
+
+    InstanceData generateInstance(const GeneratorConfig& config)
+    {
+        config.validate();
+
+        InstanceData instance;
+        instance.xs.reserve(config.size);
+        instance.ys.reserve(config.size);
+        instance.costs.reserve(config.size);
+
+        Rng rng(config.seed);
+        switch (config.layout)
+        {
+        case Layout::Clustered:
+            generateClustered(config, rng, instance);
+            break;
+        case Layout::Grid:
+            generateGrid(config, rng, instance);
+            break;
+        case Layout::Uniform:
+        default:
+            generateUniform(config, rng, instance);
+            break;
+        }
+        return instance;
+    }
+
+    void InstanceWriter::writeFile(const InstanceData& instance, const std::string& filename) const
+    {
+        std::ofstream out(filename, binary() ? std::ios::out | std::ios::binary : std::ios::out);
+        if (!out.is_open())
+        {
+            throw std::runtime_error("Could not open file for writing: " + filename);
+        }
+        write(instance, out);
+        if (!out)
+        {
+            throw std::runtime_error("Could not write instance file: " + filename);
+        }
+    }
+
+    void CsvInstanceWriter::write(const InstanceData& instance, std::ostream& out) const
+    {
+        for (int i = 0; i < instance.size(); ++i)
+        {
+            out << instance.xs[i] << ';' << instance.ys[i] << ';' << instance.costs[i] << '\n';
+        }
+    }
+
+    std::unique_ptr<InstanceWriter> makeInstanceWriter(const std::string& format)
+    {
+        if (format == "csv")
+        {
+            return std::unique_ptr<InstanceWriter>(new CsvInstanceWriter());
+        }
+        throw std::runtime_error("Unknown instance format: " + format + " (expected csv)");
+    }
+
+}
@@ -0,0 +1,73 @@
+#ifndef INSTANCE_GENERATOR_H
+#define INSTANCE_GENERATOR_H
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace LS {
+
+    // Node coordinates and costs, the content of an instance file
+    struct InstanceData {
+        std::vector<int> xs;
+        std::vector<int> ys;
+        std::vector<int> costs;
+
+        int size() const { return static_cast<int>(costs.size()); }
+    };
+
+    enum class Layout { Uniform, Clustered, Grid };
+    enum class CostDistribution { Uniform, Normal, Exponential };
+
+    // Parameters of a synthetic instance. The defaults match the course instances:
+    // points in [0, 4000] x [0, 2000] and costs in [100, 2000].
+    struct GeneratorConfig {
+        int size = 1000;
+        Layout layout = Layout::Uniform;
+        CostDistribution costDistribution = CostDistribution::Uniform;
+        int width = 4000;
+        int height = 2000;
+        int minCost = 100;
+        int maxCost = 2000;
+        int clusters = 0;          // 0 picks one cluster per 1000 nodes (at least 4)
+        double clusterSpread = 0;  // standard deviation around a center, 0 picks width / 40
+        uint64_t seed = 1;
+
+        // Throws std::runtime_error on invalid values
+        void validate() const;
+    };
+
+    Layout parseLayout(const std::string& name);
+    CostDistribution parseCostDistribution(const std::string& name);
+
+    // Same config and seed always give the same instance. Uniform draws x, y and cost
+    // of one node after the other from Rng(seed), like the benchmarks always have.
+    InstanceData generateInstance(const GeneratorConfig& config);
+
+    // Output format of an instance; new (e.g. binary) formats implement this and are
+    // registered in makeInstanceWriter
+    class InstanceWriter {
+    public:
+        virtual ~InstanceWriter() = default;
+        virtual bool binary() const = 0;
+        virtual void write(const InstanceData& instance, std::ostream& out) const = 0;
+
+        // Throws std::runtime_error if the file cannot be written
+        void writeFile(const InstanceData& instance, const std::string& filename) const;
+    };
+
+    // x;y;cost lines, the format of TSPA.csv and TSPB.csv
+    class CsvInstanceWriter : public InstanceWriter {
+    public:
+        bool binary() const override { return false; }
+        void write(const InstanceData& instance, std::ostream& out) const override;
+    };
+
+    // Throws std::runtime_error for unknown formats
+    std::unique_ptr<InstanceWriter> makeInstanceWriter(const std::string& format);
+
+}
+
+#endif // INSTANCE_GENERATOR_H
@@ -0,0 +1,48 @@
+#include "Instrumentation.h"
+
+#include <sstream>
+
+namespace LS {
+
+    void RunCounters::add(const RunCounters& other)
+    {
+        interRouteEvaluations += other.interRouteEvaluations;
+        intraNodesEvaluations += other.intraNodesEvaluations;
+        intraEdgesEvaluations += other.intraEdgesEvaluations;
+        appliedMoves += other.appliedMoves;
+        destroyNs += other.destroyNs;
+        repairNs += other.repairNs;
+        localSearchNs += other.localSearchNs;
+    }
+
+    std::string RunCounters::toJson(const std::string& extra) const
+    {
+        std::ostringstream out;
+        out << "{";
+        if (!extra.empty())
+        {
+            out << extra << ", ";
+        }
+        out << "\"inter_route_evals\": " << interRouteEvaluations
+            << ", \"intra_nodes_evals\": " << intraNodesEvaluations
+            << ", \"intra_edges_evals\": " << intraEdgesEvaluations
+            << ", \"applied_moves\": " << appliedMoves
+            << ", \"destroy_ns\": " << destroyNs
+            << ", \"repair_ns\": " << repairNs
+            << ", \"local_search_ns\": " << localSearchNs
+            << "}";
+        return out.str();
+    }
+
+    namespace Instrumentation {
+
+        RunCounters take()
+        {
+            RunCounters counters = threadCounters;
+            threadCounters = RunCounters();
+            return counters;
+        }
+
+    }
+
+}
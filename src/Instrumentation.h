@@ -0,0 +1,75 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace LS {
+
+    // Hot-path counters and phase times of one run. Each thread accumulates into its own
+    // instance, so no synchronization is needed on the hot path.
+    struct RunCounters {
+        int64_t interRouteEvaluations = 0;
+        int64_t intraNodesEvaluations = 0;
+        int64_t intraEdgesEvaluations = 0;
+        int64_t appliedMoves = 0;
+        int64_t destroyNs = 0;
+        int64_t repairNs = 0;
+        int64_t localSearchNs = 0;
+
+        void add(const RunCounters& other);
+        // Single-line JSON object, extra must be a (possibly empty) list of "key": value pairs
+        std::string toJson(const std::string& extra) const;
+    };
+
+    namespace Instrumentation {
+
+#ifdef LS_INSTRUMENTATION
+        constexpr bool enabled = true;
+#else
+        constexpr bool enabled = false;
+#endif
+
+        inline thread_local RunCounters threadCounters;
+
+        // Returns the counters of the calling thread and clears them
+        RunCounters take();
+
+    }
+
+    // Adds the lifetime of the scope to one of the calling thread's phase times
+    class ScopedPhaseTimer {
+    private:
+        int64_t& target;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit ScopedPhaseTimer(int64_t& target)
+            : target(target), start(std::chrono::steady_clock::now()) {}
+
+        ~ScopedPhaseTimer()
+        {
+            target += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+        ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+    };
+
+}
+
+// Instrumentation is compiled in only with LS_INSTRUMENTATION (CMake option
+// ENABLE_INSTRUMENTATION); otherwise these expand to nothing. LS_COUNT_LOCAL bumps a
+// plain local counter, for loops that may run on another thread than the run itself.
+#ifdef LS_INSTRUMENTATION
+#define LS_COUNT(field, amount) (::LS::Instrumentation::threadCounters.field += (amount))
+#define LS_TIME_PHASE(field) ::LS::ScopedPhaseTimer lsPhaseTimer_##field(::LS::Instrumentation::threadCounters.field)
+#define LS_COUNT_LOCAL(counter) (++(counter))
+#else
+#define LS_COUNT(field, amount) ((void)0)
+#define LS_TIME_PHASE(field) ((void)0)
+#define LS_COUNT_LOCAL(counter) ((void)0)
+#endif
+
+#endif // INSTRUMENTATION_H
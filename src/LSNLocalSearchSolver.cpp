@@ -8,18 +8,29 @@
 namespace LS {
 
     LSNLocalSearchSolver::LSNLocalSearchSolver(const std::string& instanceFilename, double fractionNodes, const Solution& initialSolution)
-        : LocalSearchSolver(instanceFilename, fractionNodes, initialSolution),
+        : LSNLocalSearchSolver(DistanceMatrix::load(instanceFilename), instanceNameFromFilename(instanceFilename),
+                               fractionNodes, initialSolution)
+    {
+    }
+
+    LSNLocalSearchSolver::LSNLocalSearchSolver(std::shared_ptr<const DistanceMatrix> instance, const std::string& instanceName,
+                                               double fractionNodes, const Solution& initialSolution)
+        : LocalSearchSolver(std::move(instance), instanceName, fractionNodes, initialSolution),
           initialSolution(initialSolution),
           fractionNodes(fractionNodes),
-          instanceFilename(instanceFilename)
+          initialLocalSearchEvaluation(0),
+          trace(nullptr),
+          incumbent(nullptr),
+          restartAfter(0),
+          restartCount(0),
+          cancelFlag(nullptr)
     {
     }
 
     void LSNLocalSearchSolver::setBestSolution(const Solution& newBest)
     {
+        // Copy assignment reuses the buffers of the previous best
         bestSolution = newBest;
-        bestSolution.setNodes(newBest.getNodes());
-        bestSolution.setSelectedNodes(newBest.getSelectedNodes());
     }
 
     double LSNLocalSearchSolver::getAverageIterations()
@@ -29,41 +40,129 @@ namespace LS {
         return avg;
     }
 
+    const std::vector<int>& LSNLocalSearchSolver::getIterationCounts() const
+    {
+        return iterationCounts;
+    }
+
+    int LSNLocalSearchSolver::getInitialLocalSearchEval() const
+    {
+        return initialLocalSearchEvaluation;
+    }
+
+    const RunCounters& LSNLocalSearchSolver::getRunCounters() const
+    {
+        return runCounters;
+    }
+
+    void LSNLocalSearchSolver::setTrace(ConvergenceTrace* newTrace)
+    {
+        trace = newTrace;
+    }
+
+    void LSNLocalSearchSolver::setIncumbent(SharedIncumbent* newIncumbent, int newRestartAfter)
+    {
+        incumbent = newIncumbent;
+        restartAfter = newRestartAfter;
+    }
+
+    int LSNLocalSearchSolver::getRestartCount() const
+    {
+        return restartCount;
+    }
+
+    void LSNLocalSearchSolver::setCancelFlag(const std::atomic<bool>* flag)
+    {
+        cancelFlag = flag;
+    }
+
+    bool LSNLocalSearchSolver::restartFromIncumbent()
+    {
+        // The evaluation is polled first so that the tour is only copied when it pays off
+        int incumbentEval;
+        if (incumbent->getBestEval() >= bestSolutionEvaluation ||
+            !incumbent->read(incumbentTour, incumbentEval) || incumbentEval >= bestSolutionEvaluation)
+        {
+            return false;
+        }
+        incumbentSolution.setNodes(incumbentTour);
+        setBestSolution(incumbentSolution);
+        bestSolutionEvaluation = incumbentEval;
+        ++restartCount;
+        return true;
+    }
+
     void LSNLocalSearchSolver::run(double timeLimitMicroseconds, bool innerLocalSearch)
     {
-        LocalSearchSolver solver(instanceFilename, fractionNodes, initialSolution);
+        // Start from clean counters, the thread may have run other work before
+        Instrumentation::take();
+
+        // The inner solver shares the instance data and is seeded from this solver's stream
+        LocalSearchSolver solver(instance, instanceName, fractionNodes, initialSolution);
+        solver.seed(rng());
+        solver.setParallelEvaluation(evaluationPool, parallelThreshold);
 
         RandomSolution newInitialSolution;
-        newInitialSolution.generate(totalNodes, numNodes);
+        newInitialSolution.generate(totalNodes, numNodes, rng);
         solver.setInitialSolutionCopy(newInitialSolution);
         auto start = std::chrono::steady_clock::now();
+        Deadline deadline(timeLimitMicroseconds, cancelFlag);
+        auto elapsedUs = [&start]()
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        };
+        if (trace != nullptr)
+        {
+            trace->clear();
+        }
 
         // Run local search on the initial solution
-        solver.runBasic("TWO_EDGES", "STEEPEST");
+        solver.runBasic("TWO_EDGES", "STEEPEST", &deadline);
 
         // Set the best found solution as best for LSNLS
         bestSolutionEvaluation = solver.getBestSolutionEval();
         setBestSolution(solver.getBestFullSolution());
 
-        std::cout << bestSolution.evaluate(distanceMatrix, costs) << std::endl;
+        initialLocalSearchEvaluation = bestSolutionEvaluation;
+        if (trace != nullptr)
+        {
+            trace->record(elapsedUs(), 0, bestSolutionEvaluation);
+        }
+        restartCount = 0;
+        if (incumbent != nullptr)
+        {
+            incumbent->publish(bestSolution.getNodes(), bestSolutionEvaluation);
+        }
 
         int counter = 0;
-        while (true)
+        int lastImprovement = 0;
+        while (!deadline.check())
         {
-            auto now = std::chrono::steady_clock::now();
-            double elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
-            if (elapsed > timeLimitMicroseconds)
+            counter++;
+
+            if (incumbent != nullptr && restartAfter > 0 && counter - lastImprovement > restartAfter)
             {
-                break;
+                lastImprovement = counter;
+                if (restartFromIncumbent())
+                {
+                    solver.setInitialSolution(bestSolution);
+                    if (trace != nullptr)
+                    {
+                        trace->record(elapsedUs(), counter, bestSolutionEvaluation);
+                    }
+                }
             }
-            counter++;
 
-            // Destroy and repair current best solution
-            solver.destroyAndRepairBestSolution();
+            // Destroy and repair current best solution; a repair cut short by the deadline
+            // leaves a tour with too few nodes, which must not be compared with the best
+            if (!solver.destroyAndRepairBestSolution(&deadline))
+            {
+                break;
+            }
 
             if (innerLocalSearch)
             {
-                solver.runBasic("TWO_EDGES", "STEEPEST");
+                solver.runBasic("TWO_EDGES", "STEEPEST", &deadline);
             }
 
             int solverBestEval = solver.getBestSolutionEval();
@@ -71,10 +170,19 @@ namespace LS {
             {
                 setBestSolution(solver.getBestFullSolution());
                 bestSolutionEvaluation = solverBestEval;
+                lastImprovement = counter;
+                if (trace != nullptr)
+                {
+                    trace->record(elapsedUs(), counter, bestSolutionEvaluation);
+                }
+                if (incumbent != nullptr)
+                {
+                    incumbent->publish(bestSolution.getNodes(), bestSolutionEvaluation);
+                }
             }
         }
         iterationCounts.emplace_back(counter);
-        std::cout << "Best found in run of LSNLS: " << bestSolutionEvaluation << std::endl;
+        runCounters = Instrumentation::take();
     }
 
 }
@@ -4,21 +4,54 @@
 #include "LocalSearchSolver.h"
 #include "Solution.h"
 #include "Utils.h"
+#include "Instrumentation.h"
+#include "ConvergenceTrace.h"
+#include "SharedIncumbent.h"
+#include "Deadline.h"
 namespace LS {
 
     class LSNLocalSearchSolver : public LocalSearchSolver {
     private:
         Solution initialSolution;
         double fractionNodes;
-        std::string instanceFilename;
         std::vector<int> iterationCounts;
+        int initialLocalSearchEvaluation;
+        RunCounters runCounters;
+        ConvergenceTrace* trace;
+        SharedIncumbent* incumbent;
+        int restartAfter;
+        int restartCount;
+        const std::atomic<bool>* cancelFlag;
+        // Buffers the incumbent is read into on a restart
+        std::vector<int> incumbentTour;
+        Solution incumbentSolution;
+
+        bool restartFromIncumbent();
 
     public:
         LSNLocalSearchSolver(const std::string& instanceFilename, double fractionNodes, const Solution& initialSolution);
+        LSNLocalSearchSolver(std::shared_ptr<const DistanceMatrix> instance, const std::string& instanceName,
+                             double fractionNodes, const Solution& initialSolution);
 
         void setBestSolution(const Solution& newBest);
         double getAverageIterations();
+        const std::vector<int>& getIterationCounts() const;
+        int getInitialLocalSearchEval() const;
+        // Counters of the last run, all zero unless built with LS_INSTRUMENTATION
+        const RunCounters& getRunCounters() const;
+        // Records every improvement of the best solution of the following runs, nullptr disables
+        void setTrace(ConvergenceTrace* newTrace);
+        // Publishes every improvement of the best solution to newIncumbent, nullptr disables.
+        // With newRestartAfter > 0, a run whose best has not improved for that many iterations
+        // continues from the incumbent when the incumbent is better.
+        void setIncumbent(SharedIncumbent* newIncumbent, int newRestartAfter = 0);
+        // Restarts from the incumbent during the last run
+        int getRestartCount() const;
+        // Runs stop early, within a few microseconds of work, once *flag is set; nullptr disables
+        void setCancelFlag(const std::atomic<bool>* flag);
 
+        // The time limit also bounds the initial descent, the repairs and the inner descents,
+        // which poll it every Deadline::CHECK_INTERVAL evaluations
         void run(double timeLimitMicroseconds, bool innerLocalSearch);
     };
 
@@ -5,16 +5,23 @@
 #include <numeric>
 #include <iostream>
 #include <limits>
-#include <random>
 #include <chrono>
+#include <array>
+#include <memory_resource>
 
 namespace LS {
 
     LocalSearchSolver::LocalSearchSolver(const std::string& instanceFilename, double fractionNodes, const Solution& initialSolution)
-        : BaseSolver(instanceFilename, fractionNodes), bestSolution(initialSolution)
+        : LocalSearchSolver(DistanceMatrix::load(instanceFilename), instanceNameFromFilename(instanceFilename),
+                            fractionNodes, initialSolution)
+    {
+    }
+
+    LocalSearchSolver::LocalSearchSolver(std::shared_ptr<const DistanceMatrix> instance, const std::string& instanceName,
+                                         double fractionNodes, const Solution& initialSolution)
+        : BaseSolver(std::move(instance), instanceName, fractionNodes), bestSolution(initialSolution),
+          evaluationPool(nullptr), parallelThreshold(DEFAULT_PARALLEL_THRESHOLD)
     {
-        bestSolution.setNodes(initialSolution.getNodes());
-        bestSolution.setSelectedNodes(initialSolution.getSelectedNodes());
         bestSolutionEvaluation = bestSolution.evaluate(distanceMatrix, costs);
 
         iterator1.reserve(bestSolution.getNumberOfNodes());
@@ -29,18 +36,33 @@ namespace LS {
         iteratorLong.resize(totalNodes);
         std::iota(iteratorLong.begin(), iteratorLong.end(), 0);
 
-        std::random_device rd;
-        rng.seed(rd());
+        // A repaired tour has numNodes edges; the slack covers the allocator's alignment
+        int maxTourSize = std::max(numNodes, bestSolution.getNumberOfNodes());
+        repairTour.reserve(maxTourSize);
+        repairBuffer.resize((maxTourSize + 1) * sizeof(std::array<int, 2>) + 64);
+    }
+
+    void LocalSearchSolver::seed(uint64_t seedValue)
+    {
+        rng.seed(seedValue);
+    }
+
+    void LocalSearchSolver::setRng(const Rng& newRng)
+    {
+        rng = newRng;
+    }
+
+    Rng& LocalSearchSolver::getRng()
+    {
+        return rng;
     }
 
     void LocalSearchSolver::reset()
     {
         // Set new random solution
         RandomSolution newInitialSolution;
-        newInitialSolution.generate(totalNodes, numNodes);
+        newInitialSolution.generate(totalNodes, numNodes, rng);
         bestSolution = newInitialSolution;
-        bestSolution.setNodes(newInitialSolution.getNodes());
-        bestSolution.setSelectedNodes(newInitialSolution.getSelectedNodes());
 
         bestSolutionEvaluation = bestSolution.evaluate(distanceMatrix, costs);
     }
@@ -54,8 +76,6 @@ namespace LS {
     void LocalSearchSolver::setInitialSolutionCopy(const Solution& newInitialSolution)
     {
         bestSolution = newInitialSolution;
-        bestSolution.setNodes(newInitialSolution.getNodes());
-        bestSolution.setSelectedNodes(newInitialSolution.getSelectedNodes());
         bestSolutionEvaluation = bestSolution.evaluate(distanceMatrix, costs);
     }
 
@@ -69,12 +89,12 @@ namespace LS {
         return bestSolutionEvaluation;
     }
 
-    std::vector<int> LocalSearchSolver::getBestSolution() const
+    const std::vector<int>& LocalSearchSolver::getBestSolution() const
     {
         return bestSolution.getNodes();
     }
 
-    Solution LocalSearchSolver::getBestFullSolution() const
+    const Solution& LocalSearchSolver::getBestFullSolution() const
     {
         return bestSolution;
     }
@@ -86,15 +106,14 @@ namespace LS {
 
     void LocalSearchSolver::perturbBestSolution(int n)
     {
-        std::uniform_int_distribution<int> distEdge(0, 99); // Assuming 100 edges
         for (int i = 0; i < n; ++i)
         {
             int edge1 = 0;
             int edge2 = 0;
             while (std::abs(edge1 - edge2) < 2)
             {
-                edge1 = distEdge(rng);
-                edge2 = distEdge(rng);
+                edge1 = rng.uniformInt(0, 99); // Assuming 100 edges
+                edge2 = rng.uniformInt(0, 99);
                 if (edge1 > edge2)
                 {
                     std::swap(edge1, edge2);
@@ -106,62 +125,80 @@ namespace LS {
         }
     }
 
-    void LocalSearchSolver::destroyAndRepairBestSolution()
+    bool LocalSearchSolver::destroyAndRepairBestSolution(Deadline* deadline)
     {
         // Destroy
-        int destroySequencesAmount = (rng() % 4) + 2;
-        int length = bestSolution.getNumberOfNodes() / (4 * destroySequencesAmount);
-
-        for (int idx = 0; idx < destroySequencesAmount; ++idx)
         {
-            std::uniform_int_distribution<int> distIndex(0, bestSolution.getNumberOfNodes() - length);
-            int indexF = distIndex(rng);
-            bestSolution.removeNodes(indexF, length);
+            LS_TIME_PHASE(destroyNs);
+            int destroySequencesAmount = static_cast<int>(rng.bounded(4)) + 2;
+            int length = bestSolution.getNumberOfNodes() / (4 * destroySequencesAmount);
+
+            for (int idx = 0; idx < destroySequencesAmount; ++idx)
+            {
+                int indexF = rng.uniformInt(0, bestSolution.getNumberOfNodes() - length);
+                bestSolution.removeNodes(indexF, length);
+            }
         }
 
         // Repair
-        std::vector<int> tmpSol;
-        greedyCycleRepair(tmpSol);
-
-        bestSolution.setNodes(tmpSol);
-        bestSolution.updateSelectedNodes();
-        bestSolutionEvaluation = bestSolution.evaluate(distanceMatrix, costs);
+        return repairBestSolution(deadline);
     }
 
-    void LocalSearchSolver::destroyAndRepairBestSolutionV2()
+    bool LocalSearchSolver::destroyAndRepairBestSolutionV2(Deadline* deadline)
     {
         // Similar to destroyAndRepairBestSolution with slight variations
-        int destroySequencesAmount = (rng() % 3) + 2;
-        int length = bestSolution.getNumberOfNodes() / (4 * destroySequencesAmount);
-
-        for (int idx = 0; idx < destroySequencesAmount; ++idx)
         {
-            std::uniform_int_distribution<int> distIndex(0, bestSolution.getNumberOfNodes() - length);
-            int indexF = distIndex(rng);
-            bestSolution.removeNodes(indexF, length);
+            LS_TIME_PHASE(destroyNs);
+            int destroySequencesAmount = static_cast<int>(rng.bounded(3)) + 2;
+            int length = bestSolution.getNumberOfNodes() / (4 * destroySequencesAmount);
+
+            for (int idx = 0; idx < destroySequencesAmount; ++idx)
+            {
+                int indexF = rng.uniformInt(0, bestSolution.getNumberOfNodes() - length);
+                bestSolution.removeNodes(indexF, length);
+            }
         }
 
         // Repair
-        std::vector<int> tmpSol;
-        greedyCycleRepair(tmpSol);
+        return repairBestSolution(deadline);
+    }
+
+    bool LocalSearchSolver::repairBestSolution(Deadline* deadline)
+    {
+        LS_TIME_PHASE(repairNs);
+        repairTour.clear();
+        bool completed = greedyCycleRepair(repairTour, deadline);
 
-        bestSolution.setNodes(tmpSol);
-        bestSolution.updateSelectedNodes();
+        // The previous tour's buffer goes back to repairTour for the next repair
+        bestSolution.swapNodes(repairTour);
         bestSolutionEvaluation = bestSolution.evaluate(distanceMatrix, costs);
+        return completed;
     }
 
-    void LocalSearchSolver::greedyCycleRepair(std::vector<int>& correctOrderNodes)
+    bool LocalSearchSolver::greedyCycleRepair(std::vector<int>& correctOrderNodes, Deadline* deadline)
     {
-        std::vector<std::vector<int>> edges;
+        Deadline unlimited;
+        Deadline& budget = deadline != nullptr ? *deadline : unlimited;
+        bool completed = true;
+
+        // Edges of the partial cycle; they live in repairBuffer unless the tour outgrew it
         const auto& nodes = bestSolution.getNodes();
+        std::pmr::monotonic_buffer_resource resource(repairBuffer.data(), repairBuffer.size());
+        std::pmr::vector<std::array<int, 2>> edges(&resource);
+        edges.reserve(std::max<size_t>(numNodes, nodes.size()));
         for (size_t idx = 0; idx < nodes.size() - 1; idx++)
         {
-            edges.emplace_back(std::vector<int>{nodes[idx], nodes[idx + 1]});
+            edges.push_back({nodes[idx], nodes[idx + 1]});
         }
-        edges.emplace_back(std::vector<int>{nodes.back(), nodes[0]});
+        edges.push_back({nodes.back(), nodes[0]});
 
         while (bestSolution.getNumberOfNodes() < numNodes)
         {
+            if (budget.isExpired())
+            {
+                completed = false;
+                break;
+            }
             int nodeToAddIdx = -1;
             int edgeToRemoveIdx = -1;
             int minTotalCost = std::numeric_limits<int>::max();
@@ -175,6 +212,7 @@ namespace LS {
                         int node1 = edges[edgeIdx][0];
                         int node2 = edges[edgeIdx][1];
 
+                        if (budget.poll()) break;
                         int totalCost = distanceMatrix[node1][nodeIdx] +
                                         distanceMatrix[node2][nodeIdx] -
                                         distanceMatrix[node1][node2] + costs[nodeIdx];
@@ -189,14 +227,20 @@ namespace LS {
                 }
             }
 
+            if (budget.isExpired())
+            {
+                // The scan was cut short, so its minimum may not be the greedy choice
+                completed = false;
+                break;
+            }
             if (edgeToRemoveIdx == -1 || nodeToAddIdx == -1) break; // No possible addition
 
             int nodeToConnect1 = edges[edgeToRemoveIdx][0];
             int nodeToConnect2 = edges[edgeToRemoveIdx][1];
 
             edges.erase(edges.begin() + edgeToRemoveIdx);
-            edges.emplace_back(std::vector<int>{nodeToConnect1, nodeToAddIdx});
-            edges.emplace_back(std::vector<int>{nodeToConnect2, nodeToAddIdx});
+            edges.push_back({nodeToConnect1, nodeToAddIdx});
+            edges.push_back({nodeToConnect2, nodeToAddIdx});
 
             bestSolution.addNode(nodeToAddIdx);
         }
@@ -229,27 +273,29 @@ namespace LS {
                 }
             }
         }
+        return completed;
     }
 
-    void LocalSearchSolver::runBasic(const std::string& neighborhoodMethod, const std::string& searchMethod)
+    void LocalSearchSolver::runBasic(const std::string& neighborhoodMethod, const std::string& searchMethod, Deadline* deadline)
     {
+        LS_TIME_PHASE(localSearchNs);
+        Deadline unlimited;
+        Deadline& budget = deadline != nullptr ? *deadline : unlimited;
         int currentBestDelta = -1;
         int bestInterDelta, bestIntraNodesDelta, bestIntraEdgesDelta;
 
-        int arg1, arg2;
+        int arg1 = -1, arg2 = -1;
         std::string moveType;
 
-        // Define neighborhood methods
-        typedef void (LocalSearchSolver::*VoidFunctionFourParams)(int&, int&, int&, const std::string&);
-        std::vector<VoidFunctionFourParams> neighborhoodMethods = {
+        // Define neighborhood methods; fixed tables, so a call does not allocate
+        typedef void (LocalSearchSolver::*NeighborhoodMethod)(int&, int&, int&, const std::string&, Deadline&);
+        static const std::array<NeighborhoodMethod, 3> neighborhoodMethods = {
             &LocalSearchSolver::findBestInterNeighbor,
             &LocalSearchSolver::findBestIntraNeighborNodes,
             &LocalSearchSolver::findBestIntraNeighborEdges
         };
 
-        std::vector<std::string> moveTypes = { "inter", "intra_nodes", "intra_edges" };
-
-        std::vector<int> neighborhoodMethodsIdxs = { 0 };
+        static const std::array<std::string, 3> moveTypes = { "inter", "intra_nodes", "intra_edges" };
 
         int methodIdx = 0;
         if (neighborhoodMethod == "TWO_NODES")
@@ -261,15 +307,11 @@ namespace LS {
             methodIdx = 2;
         }
 
-        // Randomly decide to include the methodIdx
-        std::uniform_int_distribution<int> dist(0,1);
-        if (dist(rng) == 1)
-        {
-            neighborhoodMethodsIdxs.push_back(methodIdx);
-        }
-        else
+        // Randomly decide whether the inter-route neighborhood (0) is searched before or after methodIdx
+        std::array<int, 2> neighborhoodMethodsIdxs = { 0, methodIdx };
+        if (rng.bounded(2) != 1)
         {
-            neighborhoodMethodsIdxs.insert(neighborhoodMethodsIdxs.begin(), methodIdx);
+            std::swap(neighborhoodMethodsIdxs[0], neighborhoodMethodsIdxs[1]);
         }
 
         // Iterate until no improvement
@@ -279,8 +321,8 @@ namespace LS {
 
             for (const auto& i : neighborhoodMethodsIdxs)
             {
-                int tempBestEval, tempArg1, tempArg2;
-                (this->*neighborhoodMethods[i])(tempBestEval, tempArg1, tempArg2, searchMethod);
+                int tempBestEval = 0, tempArg1 = -1, tempArg2 = -1;
+                (this->*neighborhoodMethods[i])(tempBestEval, tempArg1, tempArg2, searchMethod, budget);
 
                 if (tempBestEval < currentBestDelta)
                 {
@@ -304,141 +346,216 @@ namespace LS {
 
             bestSolutionEvaluation += currentBestDelta;
             applyMove(moveType, arg1, arg2);
+
+            if (budget.isExpired())
+            {
+                break;
+            }
         }
     }
 
-    void LocalSearchSolver::findBestInterNeighbor(int& outDelta, int& exchangedNode, int& newNode, const std::string& searchMethod)
+    void LocalSearchSolver::setParallelEvaluation(ThreadPool* pool, int minTotalNodes)
     {
-        // Finds best neighbor by exchanging some selected node with a not selected node
-        int delta = 0;
-        int minDelta = 0;
-        int minExchangedIdx = -1;
-        int minNewNode = -1;
+        evaluationPool = pool;
+        parallelThreshold = minTotalNodes;
+    }
+
+    template <typename EvaluateRange>
+    LocalSearchSolver::MoveCandidate LocalSearchSolver::findBestMove(int outerCount, Deadline& deadline, const EvaluateRange& evaluateRange)
+    {
+        if (evaluationPool == nullptr || totalNodes < parallelThreshold || outerCount < 2)
+        {
+            return evaluateRange(0, outerCount, deadline);
+        }
+
+        // Several chunks per worker balance the uneven cost of the outer iterations
+        int numChunks = std::min<int>(outerCount, evaluationPool->size() * 4);
+        chunkBest.assign(numChunks, MoveCandidate());
+        evaluationPool->parallelFor(numChunks, [&](int chunk, unsigned int)
+        {
+            int begin = static_cast<int>(static_cast<long long>(outerCount) * chunk / numChunks);
+            int end = static_cast<int>(static_cast<long long>(outerCount) * (chunk + 1) / numChunks);
+            // Every chunk polls its own copy, a Deadline is not shared between threads
+            Deadline chunkDeadline = deadline;
+            chunkBest[chunk] = evaluateRange(begin, end, chunkDeadline);
+        });
+        deadline.check();
+
+        // Reducing in chunk order with a strict comparison keeps the serial tie-breaking:
+        // the first best move in iteration order wins
+        MoveCandidate best = chunkBest[0];
+        int64_t evaluations = chunkBest[0].evaluations;
+        for (int chunk = 1; chunk < numChunks; ++chunk)
+        {
+            evaluations += chunkBest[chunk].evaluations;
+            if (chunkBest[chunk].delta < best.delta)
+            {
+                best = chunkBest[chunk];
+            }
+        }
+        best.evaluations = evaluations;
+        return best;
+    }
+
+    template <typename Sweep>
+    LocalSearchSolver::MoveCandidate LocalSearchSolver::visitTour(const Sweep& sweep) const
+    {
+        const std::vector<int>& nodes = bestSolution.getNodes();
+        TourCore::NestedDistances distances{&distanceMatrix};
+        return TourCore::visit(nodes.data(), bestSolution.getNumberOfNodes(), [&](const auto& tour)
+        {
+            return sweep(tour, distances);
+        });
+    }
 
-        if (searchMethod == "GREEDY")
+    void LocalSearchSolver::findBestInterNeighbor(int& outDelta, int& exchangedNode, int& newNode, const std::string& searchMethod, Deadline& deadline)
+    {
+        // Finds best neighbor by exchanging some selected node with a not selected node
+        bool greedy = searchMethod == "GREEDY";
+        if (greedy)
         {
-            std::shuffle(iterator1.begin(), iterator1.end(), rng);
-            std::shuffle(iteratorLong.begin(), iteratorLong.end(), rng);
+            rng.shuffle(iterator1);
+            rng.shuffle(iteratorLong);
         }
 
-        for (const auto& j : iteratorLong)
+        auto evaluateRange = [&](int begin, int end, Deadline& budget)
         {
-            if (!bestSolution.contains(j))
+            return visitTour([&](const auto& tour, const auto& distances)
             {
-                for (const auto& i : iterator1)
+                MoveCandidate best;
+                for (int jPos = begin; jPos < end; ++jPos)
                 {
-                    delta = bestSolution.calculateDeltaInterRoute(distanceMatrix, costs, i, j);
-                    if (delta < minDelta)
+                    int j = iteratorLong[jPos];
+                    if (!bestSolution.contains(j))
                     {
-                        minDelta = delta;
-                        minExchangedIdx = i;
-                        minNewNode = j;
-
-                        if (searchMethod == "GREEDY")
+                        for (const auto& i : iterator1)
                         {
-                            outDelta = minDelta;
-                            exchangedNode = minExchangedIdx;
-                            newNode = minNewNode;
-                            return;
+                            if (budget.poll()) return best;
+                            LS_COUNT_LOCAL(best.evaluations);
+                            int delta = TourCore::InterRoute::delta(tour, distances, costs.data(), i, j);
+                            if (delta < best.delta)
+                            {
+                                best.delta = delta;
+                                best.arg1 = i;
+                                best.arg2 = j;
+                                if (greedy) return best;
+                            }
                         }
                     }
                 }
-            }
-        }
+                return best;
+            });
+        };
+
+        int outerCount = iteratorLong.size();
+        MoveCandidate best = greedy ? evaluateRange(0, outerCount, deadline) : findBestMove(outerCount, deadline, evaluateRange);
+
+        LS_COUNT(interRouteEvaluations, best.evaluations);
 
-        outDelta = minDelta;
-        exchangedNode = minExchangedIdx;
-        newNode = minNewNode;
+        outDelta = best.delta;
+        exchangedNode = best.arg1;
+        newNode = best.arg2;
     }
 
-    void LocalSearchSolver::findBestIntraNeighborNodes(int& outDelta, int& firstNodeIdx, int& secondNodeIdx, const std::string& searchMethod)
+    void LocalSearchSolver::findBestIntraNeighborNodes(int& outDelta, int& firstNodeIdx, int& secondNodeIdx, const std::string& searchMethod, Deadline& deadline)
     {
-        int minDelta = 0;
-        int minNode1Idx = -1;
-        int minNode2Idx = -1;
-        int delta = 0;
-
-        if (searchMethod == "GREEDY")
+        bool greedy = searchMethod == "GREEDY";
+        if (greedy)
         {
-            std::shuffle(iterator1.begin(), iterator1.end(), rng);
-            std::shuffle(iterator2.begin(), iterator2.end(), rng);
+            rng.shuffle(iterator1);
+            rng.shuffle(iterator2);
         }
 
-        for (const auto& node1Idx : iterator1)
+        auto evaluateRange = [&](int begin, int end, Deadline& budget)
         {
-            for (const auto& node2Idx : iterator2)
+            return visitTour([&](const auto& tour, const auto& distances)
             {
-                if (node1Idx < node2Idx)
+                MoveCandidate best;
+                for (int pos = begin; pos < end; ++pos)
                 {
-                    delta = bestSolution.calculateDeltaIntraRouteNodes(distanceMatrix, node1Idx, node2Idx);
-                    if (delta < minDelta)
+                    int node1Idx = iterator1[pos];
+                    for (const auto& node2Idx : iterator2)
                     {
-                        minDelta = delta;
-                        minNode1Idx = node1Idx;
-                        minNode2Idx = node2Idx;
-
-                        if (searchMethod == "GREEDY")
+                        if (node1Idx < node2Idx)
                         {
-                            outDelta = minDelta;
-                            firstNodeIdx = minNode1Idx;
-                            secondNodeIdx = minNode2Idx;
-                            return;
+                            if (budget.poll()) return best;
+                            LS_COUNT_LOCAL(best.evaluations);
+                            int delta = TourCore::TwoNodes::delta(tour, distances, nullptr, node1Idx, node2Idx);
+                            if (delta < best.delta)
+                            {
+                                best.delta = delta;
+                                best.arg1 = node1Idx;
+                                best.arg2 = node2Idx;
+                                if (greedy) return best;
+                            }
                         }
                     }
                 }
-            }
-        }
+                return best;
+            });
+        };
 
-        outDelta = minDelta;
-        firstNodeIdx = minNode1Idx;
-        secondNodeIdx = minNode2Idx;
+        int outerCount = iterator1.size();
+        MoveCandidate best = greedy ? evaluateRange(0, outerCount, deadline) : findBestMove(outerCount, deadline, evaluateRange);
+
+        LS_COUNT(intraNodesEvaluations, best.evaluations);
+
+        outDelta = best.delta;
+        firstNodeIdx = best.arg1;
+        secondNodeIdx = best.arg2;
     }
 
-    void LocalSearchSolver::findBestIntraNeighborEdges(int& outDelta, int& firstEdgeIdx, int& secondEdgeIdx, const std::string& searchMethod)
+    void LocalSearchSolver::findBestIntraNeighborEdges(int& outDelta, int& firstEdgeIdx, int& secondEdgeIdx, const std::string& searchMethod, Deadline& deadline)
     {
-        int minDelta = 0;
-        int minEdge1Idx = -1;
-        int minEdge2Idx = -1;
-        int delta = 0;
-
-        if (searchMethod == "GREEDY")
+        bool greedy = searchMethod == "GREEDY";
+        if (greedy)
         {
-            std::shuffle(iterator1.begin(), iterator1.end(), rng);
-            std::shuffle(iterator2.begin(), iterator2.end(), rng);
+            rng.shuffle(iterator1);
+            rng.shuffle(iterator2);
         }
 
-        for (const auto& edge1Idx : iterator1)
+        auto evaluateRange = [&](int begin, int end, Deadline& budget)
         {
-            for (const auto& edge2Idx : iterator2)
+            return visitTour([&](const auto& tour, const auto& distances)
             {
-                if (std::abs(edge1Idx - edge2Idx) > 1)
+                MoveCandidate best;
+                for (int pos = begin; pos < end; ++pos)
                 {
-                    delta = bestSolution.calculateDeltaIntraRouteEdges(distanceMatrix, edge1Idx, edge2Idx);
-                    if (delta < minDelta)
+                    int edge1Idx = iterator1[pos];
+                    for (const auto& edge2Idx : iterator2)
                     {
-                        minDelta = delta;
-                        minEdge1Idx = edge1Idx;
-                        minEdge2Idx = edge2Idx;
-
-                        if (searchMethod == "GREEDY")
+                        if (std::abs(edge1Idx - edge2Idx) > 1)
                         {
-                            outDelta = minDelta;
-                            firstEdgeIdx = minEdge1Idx;
-                            secondEdgeIdx = minEdge2Idx;
-                            return;
+                            if (budget.poll()) return best;
+                            LS_COUNT_LOCAL(best.evaluations);
+                            int delta = TourCore::TwoEdges::delta(tour, distances, nullptr, edge1Idx, edge2Idx);
+                            if (delta < best.delta)
+                            {
+                                best.delta = delta;
+                                best.arg1 = edge1Idx;
+                                best.arg2 = edge2Idx;
+                                if (greedy) return best;
+                            }
                         }
                     }
                 }
-            }
-        }
+                return best;
+            });
+        };
+
+        int outerCount = iterator1.size();
+        MoveCandidate best = greedy ? evaluateRange(0, outerCount, deadline) : findBestMove(outerCount, deadline, evaluateRange);
+
+        LS_COUNT(intraEdgesEvaluations, best.evaluations);
 
-        outDelta = minDelta;
-        firstEdgeIdx = minEdge1Idx;
-        secondEdgeIdx = minEdge2Idx;
+        outDelta = best.delta;
+        firstEdgeIdx = best.arg1;
+        secondEdgeIdx = best.arg2;
     }
 
     void LocalSearchSolver::applyMove(const std::string& moveType, int arg1, int arg2)
     {
+        LS_COUNT(appliedMoves, 1);
         if (moveType == "inter")
         {
             bestSolution.exchangeNodeAtIndex(arg1, arg2);
@@ -3,44 +3,92 @@
 
 #include <vector>
 #include <string>
-#include <random>
 
 #include "BaseSolver.h"
 #include "Solution.h"
+#include "RandomGenerator.h"
+#include "ThreadPool.h"
+#include "Instrumentation.h"
+#include "Deadline.h"
 
 namespace LS {
 
     class LocalSearchSolver : public BaseSolver {
+    public:
+        // Instances with fewer nodes are always evaluated serially
+        static const int DEFAULT_PARALLEL_THRESHOLD = 1000;
+
     protected:
+        // Best move found in (part of) a neighborhood; delta 0 means no improving move
+        struct MoveCandidate {
+            int delta = 0;
+            int arg1 = -1;
+            int arg2 = -1;
+            int64_t evaluations = 0; // only counted with LS_INSTRUMENTATION
+        };
+
         Solution bestSolution;
         int bestSolutionEvaluation;
         std::vector<int> iterator1;
         std::vector<int> iterator2;
         std::vector<int> iteratorLong;
-        std::mt19937 rng;
+        Rng rng;
+        ThreadPool* evaluationPool;
+        int parallelThreshold;
+
+        // Scratch reused by every destroy-repair and parallel sweep, so the LNS loop does not
+        // allocate once these have reached their working size
+        std::vector<int> repairTour;
+        std::vector<unsigned char> repairBuffer; // Backs the monotonic resource of greedyCycleRepair
+        std::vector<MoveCandidate> chunkBest;
+
+        template <typename EvaluateRange>
+        MoveCandidate findBestMove(int outerCount, Deadline& deadline, const EvaluateRange& evaluateRange);
+        // Runs sweep(tour, distances) over the current best with the TourCore view of its
+        // size, so that the common sizes are swept with a compile-time tour length
+        template <typename Sweep>
+        MoveCandidate visitTour(const Sweep& sweep) const;
 
     public:
         LocalSearchSolver(const std::string& instanceFilename, double fractionNodes, const Solution& initialSolution);
+        LocalSearchSolver(std::shared_ptr<const DistanceMatrix> instance, const std::string& instanceName,
+                          double fractionNodes, const Solution& initialSolution);
+
+        void seed(uint64_t seedValue);
+        void setRng(const Rng& newRng);
+        Rng& getRng();
+
+        // Splits steepest neighborhood sweeps over the pool on instances with at least
+        // minTotalNodes nodes. The pool must not be the one running this solver.
+        void setParallelEvaluation(ThreadPool* pool, int minTotalNodes = DEFAULT_PARALLEL_THRESHOLD);
 
         void reset();
         void setInitialSolution(const Solution& newInitialSolution);
         void setInitialSolutionCopy(const Solution& newInitialSolution);
         void writeBestToCSV(const std::string& filename);
         int getBestSolutionEval() const;
-        std::vector<int> getBestSolution() const;
-        void greedyCycleRepair(std::vector<int>& tmpSol);
-        Solution getBestFullSolution() const;
+        const std::vector<int>& getBestSolution() const;
+        // Returns false if the deadline expired first; tmpSol is then a shorter, valid cycle
+        bool greedyCycleRepair(std::vector<int>& tmpSol, Deadline* deadline = nullptr);
+        const Solution& getBestFullSolution() const;
         Solution* getBestSolutionPtr();
 
         void perturbBestSolution(int n);
-        void destroyAndRepairBestSolution();
-        void destroyAndRepairBestSolutionV2();
+        // Both return false if the deadline expired before the repair completed the tour,
+        // which then has fewer than numNodes nodes
+        bool destroyAndRepairBestSolution(Deadline* deadline = nullptr);
+        bool destroyAndRepairBestSolutionV2(Deadline* deadline = nullptr);
+        // Completes the current best, e.g. an offspring set with setInitialSolution, by greedy
+        // cycle insertion; returns false on the same terms as the two above
+        bool repairBestSolution(Deadline* deadline);
 
-        void runBasic(const std::string& neighborhoodMethod, const std::string& searchMethod);
+        // Descends until no move improves or the deadline expires; a sweep cut short by the
+        // deadline still applies the best improving move it found
+        void runBasic(const std::string& neighborhoodMethod, const std::string& searchMethod, Deadline* deadline = nullptr);
 
-        void findBestInterNeighbor(int& bestEval, int& exchangedNode, int& newNode, const std::string& searchMethod);
-        void findBestIntraNeighborNodes(int& bestEval, int& firstNodeIdx, int& secondNodeIdx, const std::string& searchMethod);
-        void findBestIntraNeighborEdges(int& outDelta, int& firstEdgeIdx, int& secondEdgeIdx, const std::string& searchMethod);
+        void findBestInterNeighbor(int& bestEval, int& exchangedNode, int& newNode, const std::string& searchMethod, Deadline& deadline);
+        void findBestIntraNeighborNodes(int& bestEval, int& firstNodeIdx, int& secondNodeIdx, const std::string& searchMethod, Deadline& deadline);
+        void findBestIntraNeighborEdges(int& outDelta, int& firstEdgeIdx, int& secondEdgeIdx, const std::string& searchMethod, Deadline& deadline);
 
         void applyMove(const std::string& moveType, int arg1, int arg2);
     };
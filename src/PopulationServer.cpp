@@ -0,0 +1,162 @@
+#include "PopulationServer.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace LS {
+
+    PopulationServer::PopulationServer(int capacity, int shardCount)
+        : capacity(capacity),
+          size(0),
+          bestEval(std::numeric_limits<int>::max())
+    {
+        if (capacity < 1 || shardCount < 1 || shardCount > capacity)
+        {
+            throw std::runtime_error("Invalid population of " + std::to_string(capacity) + " members in " +
+                                     std::to_string(shardCount) + " shards");
+        }
+        for (int s = 0; s < shardCount; ++s)
+        {
+            shards.emplace_back(new Shard());
+            shards.back()->capacity = capacity / shardCount + (s < capacity % shardCount ? 1 : 0);
+            shards.back()->members.reserve(shards.back()->capacity);
+            shards.back()->worstEval.store(std::numeric_limits<int>::max(), std::memory_order_relaxed);
+        }
+    }
+
+    int PopulationServer::getCapacity() const
+    {
+        return capacity;
+    }
+
+    int PopulationServer::getSize() const
+    {
+        return size.load(std::memory_order_acquire);
+    }
+
+    int PopulationServer::getBestEval() const
+    {
+        return bestEval.load(std::memory_order_acquire);
+    }
+
+    bool PopulationServer::offer(const Solution& solution, int evaluation, uint64_t fingerprint)
+    {
+        Shard& shard = *shards[fingerprint % shards.size()];
+        if (evaluation >= shard.worstEval.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (const auto& member : shard.members)
+            {
+                if (member.evaluation == evaluation && member.fingerprint == fingerprint)
+                {
+                    return false;
+                }
+            }
+
+            if (static_cast<int>(shard.members.size()) < shard.capacity)
+            {
+                shard.members.push_back({solution, evaluation, fingerprint});
+                // Samplers pick their slots from the published sizes before locking a shard
+                shard.size.store(static_cast<int>(shard.members.size()), std::memory_order_release);
+                size.fetch_add(1, std::memory_order_acq_rel);
+            }
+            else
+            {
+                // Another worker may have raised the bar since the unlocked check
+                auto worst = std::max_element(shard.members.begin(), shard.members.end(),
+                                              [](const Member& a, const Member& b) { return a.evaluation < b.evaluation; });
+                if (evaluation >= worst->evaluation)
+                {
+                    return false;
+                }
+                // Copy assignment reuses the buffers of the replaced member
+                worst->solution = solution;
+                worst->evaluation = evaluation;
+                worst->fingerprint = fingerprint;
+            }
+
+            if (static_cast<int>(shard.members.size()) == shard.capacity)
+            {
+                int worstEval = std::numeric_limits<int>::min();
+                for (const auto& member : shard.members)
+                {
+                    worstEval = std::max(worstEval, member.evaluation);
+                }
+                shard.worstEval.store(worstEval, std::memory_order_release);
+            }
+        }
+
+        int best = bestEval.load(std::memory_order_relaxed);
+        while (evaluation < best &&
+               !bestEval.compare_exchange_weak(best, evaluation, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+        }
+        return true;
+    }
+
+    bool PopulationServer::sampleParents(Rng& rng, Solution& first, Solution& second)
+    {
+        int total = size.load(std::memory_order_acquire);
+        if (total < 2)
+        {
+            return false;
+        }
+        int firstIdx = static_cast<int>(rng.bounded(total));
+        int secondIdx = static_cast<int>(rng.bounded(total - 1));
+        if (secondIdx >= firstIdx)
+        {
+            ++secondIdx;
+        }
+
+        // Both indices are resolved in one pass, each shard size read once, so they stay
+        // distinct slots even if a shard grows meanwhile; shards only grow, so both are found
+        bool firstFound = false;
+        bool secondFound = false;
+        for (auto& shardPtr : shards)
+        {
+            Shard& shard = *shardPtr;
+            int shardSize = shard.size.load(std::memory_order_acquire);
+            bool firstHere = !firstFound && firstIdx < shardSize;
+            bool secondHere = !secondFound && secondIdx < shardSize;
+            if (firstHere || secondHere)
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                if (firstHere)
+                {
+                    first = shard.members[firstIdx].solution;
+                }
+                if (secondHere)
+                {
+                    second = shard.members[secondIdx].solution;
+                }
+            }
+            firstFound = firstFound || firstHere;
+            secondFound = secondFound || secondHere;
+            if (firstFound && secondFound)
+            {
+                break;
+            }
+            firstIdx -= firstFound ? 0 : shardSize;
+            secondIdx -= secondFound ? 0 : shardSize;
+        }
+        return true;
+    }
+
+    void PopulationServer::clear()
+    {
+        for (auto& shard : shards)
+        {
+            shard->members.clear();
+            shard->size.store(0, std::memory_order_relaxed);
+            shard->worstEval.store(std::numeric_limits<int>::max(), std::memory_order_relaxed);
+        }
+        size.store(0, std::memory_order_relaxed);
+        bestEval.store(std::numeric_limits<int>::max(), std::memory_order_relaxed);
+    }
+
+}
@@ -0,0 +1,68 @@
+#ifndef POPULATION_SERVER_H
+#define POPULATION_SERVER_H
+
+#include "Solution.h"
+#include "RandomGenerator.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace LS {
+
+    // Population of a steady-state evolution, shared by the workers evolving it without a
+    // generational barrier. Members are sharded by tour hash, each shard behind its own
+    // lock, so identical tours always meet in one shard and workers rarely contend. The
+    // evaluations of the best member and of the worst member of each full shard are atomics,
+    // so an offspring that cannot enter is rejected without taking a lock.
+    class PopulationServer {
+    private:
+        struct Member {
+            Solution solution;
+            int evaluation;
+            uint64_t fingerprint;
+        };
+
+        struct Shard {
+            std::mutex mutex;
+            std::vector<Member> members;
+            int capacity = 0;
+            std::atomic<int> size{0};
+            std::atomic<int> worstEval; // INT_MAX until the shard is full
+        };
+
+        std::vector<std::unique_ptr<Shard>> shards;
+        int capacity;
+        std::atomic<int> size;
+        std::atomic<int> bestEval;
+
+    public:
+        // capacity members spread over shardCount shards, each holding at least one
+        PopulationServer(int capacity, int shardCount);
+
+        PopulationServer(const PopulationServer&) = delete;
+        PopulationServer& operator=(const PopulationServer&) = delete;
+
+        int getCapacity() const;
+        int getSize() const;
+        // Evaluation of the best member, INT_MAX while empty
+        int getBestEval() const;
+
+        // Adds the solution unless a member has the same evaluation and fingerprint, the
+        // solution's getHash. Once its shard is full, the solution replaces the shard's worst
+        // member if it is better. Returns whether it was added.
+        bool offer(const Solution& solution, int evaluation, uint64_t fingerprint);
+
+        // Copies two members drawn uniformly without replacement into first and second.
+        // Returns false, leaving both untouched, while the population has fewer than two.
+        bool sampleParents(Rng& rng, Solution& first, Solution& second);
+
+        // Removes every member; must not run concurrently with the other members
+        void clear();
+    };
+
+}
+
+#endif // POPULATION_SERVER_H
@@ -0,0 +1,66 @@
+#include "RandomGenerator.h"
+
+namespace LS {
+
+    Rng::Rng(uint64_t seedValue)
+    {
+        seed(seedValue);
+    }
+
+    void Rng::seed(uint64_t seedValue)
+    {
+        // Expand the seed with splitmix64
+        uint64_t state = seedValue;
+        for (int i = 0; i < 4; ++i)
+        {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            s[i] = z ^ (z >> 31);
+        }
+    }
+
+    void Rng::jump()
+    {
+        static const uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                         0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+        uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for (uint64_t jumpWord : JUMP)
+        {
+            for (int b = 0; b < 64; ++b)
+            {
+                if (jumpWord & (uint64_t(1) << b))
+                {
+                    s0 ^= s[0];
+                    s1 ^= s[1];
+                    s2 ^= s[2];
+                    s3 ^= s[3];
+                }
+                (*this)();
+            }
+        }
+
+        s[0] = s0;
+        s[1] = s1;
+        s[2] = s2;
+        s[3] = s3;
+    }
+
+    std::vector<Rng> Rng::split(uint64_t seedValue, int count)
+    {
+        std::vector<Rng> streams;
+        if (count <= 0) return streams;
+
+        streams.reserve(count);
+        streams.emplace_back(seedValue);
+        for (int i = 1; i < count; ++i)
+        {
+            Rng next = streams.back();
+            next.jump();
+            streams.emplace_back(next);
+        }
+        return streams;
+    }
+
+}
@@ -0,0 +1,100 @@
+#ifndef RANDOM_GENERATOR_H
+#define RANDOM_GENERATOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <limits>
+
+namespace LS {
+
+    // xoshiro256** generator with explicit 64-bit seeding and jump-based stream splitting.
+    // Produces the same sequence as the C implementation in 01_greedy_heuristics/src/rng.c.
+    // Satisfies UniformRandomBitGenerator, but solvers use bounded()/shuffle() so that
+    // runs are reproducible independently of the standard library implementation.
+    class Rng {
+    private:
+        uint64_t s[4];
+
+        static uint64_t rotl(uint64_t x, int k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+    public:
+        typedef uint64_t result_type;
+
+        explicit Rng(uint64_t seedValue = 0);
+
+        void seed(uint64_t seedValue);
+
+        // Advances the generator by 2^128 outputs
+        void jump();
+
+        // Returns count non-overlapping streams, the first one seeded with seedValue
+        static std::vector<Rng> split(uint64_t seedValue, int count);
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()()
+        {
+            const uint64_t result = rotl(s[1] * 5, 7) * 9;
+            const uint64_t t = s[1] << 17;
+
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+
+            s[2] ^= t;
+            s[3] = rotl(s[3], 45);
+
+            return result;
+        }
+
+        // Uniform integer in [0, bound), Lemire's nearly divisionless method
+        uint32_t bounded(uint32_t bound)
+        {
+            uint64_t m = static_cast<uint64_t>(static_cast<uint32_t>((*this)() >> 32)) * bound;
+            uint32_t low = static_cast<uint32_t>(m);
+            if (low < bound)
+            {
+                uint32_t threshold = -bound % bound;
+                while (low < threshold)
+                {
+                    m = static_cast<uint64_t>(static_cast<uint32_t>((*this)() >> 32)) * bound;
+                    low = static_cast<uint32_t>(m);
+                }
+            }
+            return static_cast<uint32_t>(m >> 32);
+        }
+
+        // Uniform integer in [low, high]
+        int uniformInt(int low, int high)
+        {
+            return low + static_cast<int>(bounded(static_cast<uint32_t>(high - low + 1)));
+        }
+
+        // Uniform real in [0, 1) with 53 random bits
+        double uniformReal()
+        {
+            return static_cast<double>((*this)() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        // Fisher-Yates shuffle
+        template <typename T>
+        void shuffle(std::vector<T>& values)
+        {
+            for (std::size_t i = values.size(); i > 1; --i)
+            {
+                std::size_t j = bounded(static_cast<uint32_t>(i));
+                std::swap(values[i - 1], values[j]);
+            }
+        }
+    };
+
+}
+
+#endif // RANDOM_GENERATOR_H
@@ -1,27 +1,22 @@
 #include "RandomSolution.h"
 #include "Utils.h"
 
-#include <random>
-#include <set>
-#include <ctime>
+#include <algorithm>
 #include <iostream>
 
 namespace LS {
 
-    void RandomSolution::generate(int totalNodes, int desiredNumNodes)
+    void RandomSolution::generate(int totalNodes, int desiredNumNodes, Rng& rng)
     {
         // Clear existing nodes and reset
         nodes.clear();
-        selectedNodes.clear();
+        std::fill(selected.begin(), selected.end(), 0);
         numNodes = 0;
-
-        // Initialize random number generator
-        std::mt19937 rngEngine(static_cast<unsigned int>(std::time(nullptr)));
-        std::uniform_int_distribution<int> dist(0, totalNodes - 1);
+        hash = 0;
 
         while (nodes.size() < static_cast<size_t>(desiredNumNodes))
         {
-            int node = dist(rngEngine);
+            int node = static_cast<int>(rng.bounded(static_cast<uint32_t>(totalNodes)));
             // Use the inherited contains method to check if the node is already in the solution
             if (!contains(node))
             {
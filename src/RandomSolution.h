@@ -2,12 +2,13 @@
 #define RANDOM_SOLUTION_H
 
 #include "Solution.h"
+#include "RandomGenerator.h"
 
 namespace LS {
 
     class RandomSolution : public Solution {
     public:
-        void generate(int totalNodes, int numNodes);
+        void generate(int totalNodes, int numNodes, Rng& rng);
     };
 
 }
@@ -0,0 +1,111 @@
+#include "SharedIncumbent.h"
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace LS {
+
+    SharedIncumbent::SharedIncumbent(int capacity)
+        : bestEval(std::numeric_limits<int>::max()),
+          sequence(0),
+          tourSize(0),
+          tour(capacity > 0 ? capacity : 0),
+          publications(0)
+    {
+    }
+
+    bool SharedIncumbent::publish(const std::vector<int>& nodes, int eval)
+    {
+        // Cheap rejection without touching the sequence, the common case once runs converge
+        if (eval >= bestEval.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+        if (nodes.size() > tour.size())
+        {
+            throw std::runtime_error("Tour of " + std::to_string(nodes.size()) +
+                                     " nodes exceeds the incumbent capacity of " + std::to_string(tour.size()));
+        }
+
+        // Enter the write section by making the sequence odd; writers are rare, so a
+        // concurrent one is waited out by yielding
+        uint64_t start = sequence.load(std::memory_order_relaxed);
+        while (true)
+        {
+            if ((start & 1) == 0 &&
+                sequence.compare_exchange_weak(start, start + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                break;
+            }
+            std::this_thread::yield();
+            start = sequence.load(std::memory_order_relaxed);
+        }
+        // Keep stores to the tour from being reordered before the odd sequence is visible
+        std::atomic_thread_fence(std::memory_order_release);
+
+        // The other writer may have published something better meanwhile
+        if (eval >= bestEval.load(std::memory_order_relaxed))
+        {
+            sequence.store(start + 2, std::memory_order_release);
+            return false;
+        }
+
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+            tour[i].store(nodes[i], std::memory_order_relaxed);
+        }
+        tourSize.store(static_cast<int>(nodes.size()), std::memory_order_relaxed);
+        bestEval.store(eval, std::memory_order_release);
+        publications.fetch_add(1, std::memory_order_relaxed);
+
+        sequence.store(start + 2, std::memory_order_release);
+        return true;
+    }
+
+    bool SharedIncumbent::read(std::vector<int>& nodes, int& eval) const
+    {
+        while (true)
+        {
+            uint64_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            int snapshotEval = bestEval.load(std::memory_order_relaxed);
+            int size = tourSize.load(std::memory_order_relaxed);
+            if (snapshotEval == std::numeric_limits<int>::max())
+            {
+                return false;
+            }
+            nodes.resize(size);
+            for (int i = 0; i < size; ++i)
+            {
+                nodes[i] = tour[i].load(std::memory_order_relaxed);
+            }
+
+            // The loads above must complete before the sequence is checked again
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+            {
+                eval = snapshotEval;
+                return true;
+            }
+        }
+    }
+
+    uint64_t SharedIncumbent::getPublications() const
+    {
+        return publications.load(std::memory_order_relaxed);
+    }
+
+    void SharedIncumbent::reset()
+    {
+        bestEval.store(std::numeric_limits<int>::max(), std::memory_order_relaxed);
+        tourSize.store(0, std::memory_order_relaxed);
+        publications.store(0, std::memory_order_relaxed);
+    }
+
+}
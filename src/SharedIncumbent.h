@@ -0,0 +1,55 @@
+#ifndef SHARED_INCUMBENT_H
+#define SHARED_INCUMBENT_H
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace LS {
+
+    // Best solution found so far by concurrent workers on one instance.
+    // The evaluation is an atomic that can be polled on every iteration; the tour is
+    // guarded by a seqlock, so readers never block or write shared memory and a
+    // publication only waits for another publication in progress. Tour slots are atomics
+    // accessed with relaxed ordering, which keeps the torn reads a seqlock retries on
+    // free of data races.
+    class SharedIncumbent {
+    private:
+        std::atomic<int> bestEval;
+        std::atomic<uint64_t> sequence; // Odd while a tour is being written
+        std::atomic<int> tourSize;
+        std::vector<std::atomic<int>> tour;
+        std::atomic<uint64_t> publications;
+
+    public:
+        // capacity is the largest tour that will be published, usually the instance size
+        explicit SharedIncumbent(int capacity);
+
+        SharedIncumbent(const SharedIncumbent&) = delete;
+        SharedIncumbent& operator=(const SharedIncumbent&) = delete;
+
+        // Evaluation of the incumbent, INT_MAX while nothing was published
+        int getBestEval() const
+        {
+            return bestEval.load(std::memory_order_acquire);
+        }
+
+        // Makes nodes the incumbent if eval is strictly better; returns whether it did.
+        // Throws std::runtime_error if the tour exceeds the capacity.
+        bool publish(const std::vector<int>& nodes, int eval);
+
+        // Copies a consistent snapshot of the incumbent into nodes and eval, reusing the
+        // capacity of nodes. Returns false, leaving both untouched, if nothing was published.
+        bool read(std::vector<int>& nodes, int& eval) const;
+
+        // Number of successful publications
+        uint64_t getPublications() const;
+
+        // Forgets the incumbent; must not run concurrently with publish or read
+        void reset();
+    };
+
+}
+
+#endif // SHARED_INCUMBENT_H
@@ -0,0 +1,152 @@
+#include "Similarity.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace LS {
+
+    SimilarityIndex::SimilarityIndex(int totalNodes)
+        : totalNodes(totalNodes),
+          words((totalNodes + 63) / 64),
+          starts(1, 0)
+    {
+        if (totalNodes < 1)
+        {
+            throw std::runtime_error("Invalid similarity index over " + std::to_string(totalNodes) + " nodes");
+        }
+    }
+
+    int SimilarityIndex::add(const std::vector<int>& nodes)
+    {
+        bits.resize(bits.size() + words, 0);
+        next.resize(next.size() + totalNodes, -1);
+        prev.resize(prev.size() + totalNodes, -1);
+        uint64_t* tourBits = bits.data() + bits.size() - words;
+        int* tourNext = next.data() + next.size() - totalNodes;
+        int* tourPrev = prev.data() + prev.size() - totalNodes;
+
+        int length = static_cast<int>(nodes.size());
+        for (int i = 0; i < length; ++i)
+        {
+            int node = nodes[i];
+            if (node < 0 || node >= totalNodes)
+            {
+                throw std::runtime_error("Node " + std::to_string(node) + " is out of range");
+            }
+            tourBits[node / 64] |= uint64_t(1) << (node % 64);
+            tourNext[node] = nodes[(i + 1) % length];
+            tourPrev[node] = nodes[(i + length - 1) % length];
+        }
+        tourNodes.insert(tourNodes.end(), nodes.begin(), nodes.end());
+        starts.push_back(tourNodes.size());
+        return size() - 1;
+    }
+
+    int SimilarityIndex::size() const
+    {
+        return static_cast<int>(starts.size()) - 1;
+    }
+
+    int SimilarityIndex::tourLength(int tour) const
+    {
+        return static_cast<int>(starts[tour + 1] - starts[tour]);
+    }
+
+    int SimilarityIndex::commonNodes(int first, int second) const
+    {
+        const uint64_t* a = bits.data() + static_cast<std::size_t>(first) * words;
+        const uint64_t* b = bits.data() + static_cast<std::size_t>(second) * words;
+        int count = 0;
+        for (int w = 0; w < words; ++w)
+        {
+            count += __builtin_popcountll(a[w] & b[w]);
+        }
+        return count;
+    }
+
+    int SimilarityIndex::commonEdges(int first, int second) const
+    {
+        // Each edge (node, successor) of the first tour is shared if the second tour visits
+        // the successor right before or after the node
+        const int* nextA = next.data() + static_cast<std::size_t>(first) * totalNodes;
+        const int* nextB = next.data() + static_cast<std::size_t>(second) * totalNodes;
+        const int* prevB = prev.data() + static_cast<std::size_t>(second) * totalNodes;
+        int count = 0;
+        for (std::size_t i = starts[first]; i < starts[first + 1]; ++i)
+        {
+            int node = tourNodes[i];
+            int successor = nextA[node];
+            count += (nextB[node] == successor) | (prevB[node] == successor);
+        }
+        return count;
+    }
+
+    std::vector<SimilarityRow> fitnessSimilarity(const SimilarityIndex& index, const std::vector<int>& evaluations,
+                                                 int reference)
+    {
+        int count = index.size();
+        if (static_cast<int>(evaluations.size()) != count || reference < 0 || reference >= count)
+        {
+            throw std::runtime_error("Invalid evaluations or reference for " + std::to_string(count) + " tours");
+        }
+
+        std::vector<SimilarityRow> rows(count);
+        std::vector<long long> edgeSums(count, 0);
+        std::vector<long long> nodeSums(count, 0);
+        // Both measures are symmetric, so every pair is compared once
+        for (int i = 0; i < count; ++i)
+        {
+            for (int j = i + 1; j < count; ++j)
+            {
+                int edges = index.commonEdges(i, j);
+                int nodes = index.commonNodes(i, j);
+                edgeSums[i] += edges;
+                edgeSums[j] += edges;
+                nodeSums[i] += nodes;
+                nodeSums[j] += nodes;
+            }
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            SimilarityRow& row = rows[i];
+            row.evaluation = evaluations[i];
+            row.edgesToReference = index.commonEdges(i, reference);
+            row.nodesToReference = index.commonNodes(i, reference);
+            row.averageEdges = count > 1 ? static_cast<double>(edgeSums[i]) / (count - 1) : 0.0;
+            row.averageNodes = count > 1 ? static_cast<double>(nodeSums[i]) / (count - 1) : 0.0;
+        }
+        return rows;
+    }
+
+    double correlation(const std::vector<double>& xs, const std::vector<double>& ys)
+    {
+        std::size_t count = std::min(xs.size(), ys.size());
+        if (count < 2)
+        {
+            return 0.0;
+        }
+        double meanX = 0.0, meanY = 0.0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            meanX += xs[i];
+            meanY += ys[i];
+        }
+        meanX /= count;
+        meanY /= count;
+        double covariance = 0.0, varianceX = 0.0, varianceY = 0.0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            covariance += (xs[i] - meanX) * (ys[i] - meanY);
+            varianceX += (xs[i] - meanX) * (xs[i] - meanX);
+            varianceY += (ys[i] - meanY) * (ys[i] - meanY);
+        }
+        if (varianceX == 0.0 || varianceY == 0.0)
+        {
+            return 0.0;
+        }
+        return covariance / std::sqrt(varianceX * varianceY);
+    }
+
+}
@@ -0,0 +1,53 @@
+#ifndef SIMILARITY_H
+#define SIMILARITY_H
+
+#include <cstdint>
+#include <vector>
+
+namespace LS {
+
+    // Tours over the nodes of one instance, stored for counting the nodes and undirected edges
+    // they share. Every tour keeps a bitset of its nodes and its successor and predecessor of
+    // each node, so a comparison is a popcount over the bitsets plus one lookup per edge.
+    class SimilarityIndex {
+    private:
+        int totalNodes;
+        int words;
+        std::vector<uint64_t> bits;      // words per tour
+        std::vector<int> next;           // totalNodes per tour, -1 for unselected nodes
+        std::vector<int> prev;
+        std::vector<int> tourNodes;      // nodes of all tours in order
+        std::vector<std::size_t> starts; // of each tour in tourNodes, plus the end
+
+    public:
+        explicit SimilarityIndex(int totalNodes);
+
+        // Returns the index of the added tour
+        int add(const std::vector<int>& nodes);
+        int size() const;
+        int tourLength(int tour) const;
+
+        int commonNodes(int first, int second) const;
+        int commonEdges(int first, int second) const;
+    };
+
+    // Fitness and similarity of one tour of a population
+    struct SimilarityRow {
+        int evaluation;
+        int edgesToReference;
+        int nodesToReference;
+        double averageEdges; // over the other tours
+        double averageNodes;
+    };
+
+    // Compares every tour of index with the reference tour and with all others; evaluations
+    // holds the objective of every tour
+    std::vector<SimilarityRow> fitnessSimilarity(const SimilarityIndex& index, const std::vector<int>& evaluations,
+                                                 int reference);
+
+    // Pearson correlation coefficient, 0 when either series is constant
+    double correlation(const std::vector<double>& xs, const std::vector<double>& ys);
+
+}
+
+#endif // SIMILARITY_H
@@ -1,5 +1,6 @@
 #include "Solution.h"
 #include "Utils.h"
+#include "TourHash.h"
 
 #include <algorithm>
 #include <fstream>
@@ -7,19 +8,44 @@
 
 namespace LS {
 
+    void Solution::markSelected(int node, char value)
+    {
+        if (node >= static_cast<int>(selected.size()))
+        {
+            selected.resize(node + 1, 0);
+        }
+        selected[node] = value;
+    }
+
+    void Solution::toggleEdgeAt(int index)
+    {
+        hash ^= TourHash::edge(nodes[index], nodes[getNextNodeIndex(index)]);
+    }
+
     void Solution::addNode(int node)
     {
+        // The closing edge is replaced by two edges through the new last node
+        if (numNodes > 0) toggleEdgeAt(numNodes - 1);
         nodes.emplace_back(node);
-        selectedNodes.emplace(node);
+        markSelected(node, 1);
         ++numNodes;
+        hash ^= TourHash::node(node);
+        if (numNodes > 1) toggleEdgeAt(numNodes - 2);
+        toggleEdgeAt(numNodes - 1);
     }
 
     void Solution::removeNode(int index)
     {
         if (index < 0 || index >= numNodes) return;
-        selectedNodes.erase(nodes[index]);
+        int prevIdx = getPrevNodeIndex(index);
+        hash ^= TourHash::node(nodes[index]);
+        toggleEdgeAt(prevIdx);
+        if (prevIdx != index) toggleEdgeAt(index);
+        selected[nodes[index]] = 0;
         nodes.erase(nodes.begin() + index);
         --numNodes;
+        // The neighbours of the removed node are joined, unless it was the last one
+        if (numNodes > 0) toggleEdgeAt(prevIdx < index ? prevIdx : prevIdx - 1);
     }
 
     void Solution::removeNodes(int index, int amount)
@@ -32,7 +58,7 @@ namespace LS {
 
     bool Solution::contains(int node) const
     {
-        return selectedNodes.find(node) != selectedNodes.end();
+        return node >= 0 && node < static_cast<int>(selected.size()) && selected[node];
     }
 
     const std::vector<int>& Solution::getNodes() const
@@ -44,32 +70,44 @@ namespace LS {
     {
         nodes = newNodes;
         numNodes = nodes.size();
-        selectedNodes = std::set<int>(nodes.begin(), nodes.end());
+        updateSelectedNodes();
     }
 
-    int Solution::getNumberOfNodes() const
+    void Solution::swapNodes(std::vector<int>& newNodes)
     {
-        return numNodes;
+        nodes.swap(newNodes);
+        numNodes = nodes.size();
+        updateSelectedNodes();
     }
 
-    int Solution::calculateNumberOfNodes() const
+    TourCore::ArrayTour Solution::tourView() const
     {
-        return nodes.size();
+        return TourCore::ArrayTour{nodes.data(), static_cast<int>(nodes.size())};
     }
 
-    const std::set<int>& Solution::getSelectedNodes() const
+    uint64_t Solution::getHash() const
+    {
+        return hash;
+    }
+
+    int Solution::getNumberOfNodes() const
     {
-        return selectedNodes;
+        return numNodes;
     }
 
-    void Solution::setSelectedNodes(const std::set<int>& newSelected)
+    int Solution::calculateNumberOfNodes() const
     {
-        selectedNodes = newSelected;
+        return nodes.size();
     }
 
     void Solution::updateSelectedNodes()
     {
-        selectedNodes = std::set<int>(nodes.begin(), nodes.end());
+        std::fill(selected.begin(), selected.end(), 0);
+        for (int node : nodes)
+        {
+            markSelected(node, 1);
+        }
+        hash = TourHash::of(nodes);
     }
 
     int Solution::getNodeAtIndex(int index) const
@@ -78,18 +116,6 @@ namespace LS {
         return nodes[index];
     }
 
-    int Solution::getNextNodeIndex(int index) const
-    {
-        if (numNodes == 0) return -1;
-        return (index + 1) % numNodes;
-    }
-
-    int Solution::getPrevNodeIndex(int index) const
-    {
-        if (numNodes == 0) return -1;
-        return (index + numNodes - 1) % numNodes;
-    }
-
     int Solution::findNodeIndex(int node) const
     {
         auto it = std::find(nodes.begin(), nodes.end(), node);
@@ -102,15 +128,30 @@ namespace LS {
     void Solution::exchangeNodeAtIndex(int index, int newNode)
     {
         if (index < 0 || index >= numNodes) return;
-        selectedNodes.erase(nodes[index]);
+        int prevIdx = getPrevNodeIndex(index);
+        hash ^= TourHash::node(nodes[index]) ^ TourHash::node(newNode);
+        toggleEdgeAt(prevIdx);
+        if (prevIdx != index) toggleEdgeAt(index);
+        selected[nodes[index]] = 0;
         nodes[index] = newNode;
-        selectedNodes.emplace(newNode);
+        markSelected(newNode, 1);
+        toggleEdgeAt(prevIdx);
+        if (prevIdx != index) toggleEdgeAt(index);
     }
 
     void Solution::exchangeTwoNodes(int index1, int index2)
     {
         if (index1 < 0 || index1 >= numNodes || index2 < 0 || index2 >= numNodes) return;
+        // Edges leaving the positions before and at both indices, each toggled once
+        int edges[4] = { getPrevNodeIndex(index1), index1, getPrevNodeIndex(index2), index2 };
+        int count = 0;
+        for (int edge : edges)
+        {
+            if (std::find(edges, edges + count, edge) == edges + count) edges[count++] = edge;
+        }
+        for (int k = 0; k < count; ++k) toggleEdgeAt(edges[k]);
         std::swap(nodes[index1], nodes[index2]);
+        for (int k = 0; k < count; ++k) toggleEdgeAt(edges[k]);
     }
 
     bool Solution::areConsecutive(int index1, int index2) const
@@ -129,28 +170,18 @@ namespace LS {
         if (edgeIndex2 < edgeIndex1)
             std::swap(edgeIndex1, edgeIndex2);
 
-        auto start = nodes.begin() + edgeIndex1 + 1;
-        auto end = nodes.begin() + edgeIndex2 + 1;
-        std::reverse(start, end);
+        // The reversed segment keeps its undirected edges; only the two exchanged ones change
+        toggleEdgeAt(edgeIndex1);
+        toggleEdgeAt(edgeIndex2);
+        TourCore::reverseSegment(nodes.data(), numNodes, edgeIndex1 + 1, edgeIndex2);
+        toggleEdgeAt(edgeIndex1);
+        toggleEdgeAt(edgeIndex2);
     }
 
     int Solution::evaluate(const std::vector<std::vector<int>>& distanceMatrix,
                           const std::vector<int>& costs) const
     {
-        if (nodes.empty()) return 0;
-
-        int totalCost = costs[nodes[0]];
-
-        for (size_t i = 1; i < nodes.size(); ++i)
-        {
-            totalCost += costs[nodes[i]];
-            totalCost += distanceMatrix[nodes[i-1]][nodes[i]];
-        }
-
-        // Add distance from last to first node to complete the cycle
-        totalCost += distanceMatrix[nodes.back()][nodes[0]];
-
-        return totalCost;
+        return TourCore::evaluate(tourView(), TourCore::NestedDistances{&distanceMatrix}, costs.data());
     }
 
     int Solution::mostBeneficialNode(const std::vector<int>& allDistances,
@@ -179,82 +210,15 @@ namespace LS {
                                           const std::vector<int>& costs,
                                           int exchangeIndex, int newNode) const
     {
-        // Calculate node cost change
-        int delta = costs[newNode] - costs[nodes[exchangeIndex]];
-
-        // Calculate distance change
-        int prevNodeIdx = getPrevNodeIndex(exchangeIndex);
-        int nextNodeIdx = getNextNodeIndex(exchangeIndex);
-
-        int prevNode = nodes[prevNodeIdx];
-        int nextNode = nodes[nextNodeIdx];
-
-        // Subtract distance to the node to be exchanged
-        subtractDistanceFromDelta(delta, distanceMatrix, prevNode, nodes[exchangeIndex]);
-        subtractDistanceFromDelta(delta, distanceMatrix, nodes[exchangeIndex], nextNode);
-
-        // Add distance to the new node
-        addDistanceToDelta(delta, distanceMatrix, prevNode, newNode);
-        addDistanceToDelta(delta, distanceMatrix, newNode, nextNode);
-
-        return delta;
+        return TourCore::InterRoute::delta(tourView(), TourCore::NestedDistances{&distanceMatrix}, costs.data(),
+                                           exchangeIndex, newNode);
     }
 
     int Solution::calculateDeltaIntraRouteNodes(const std::vector<std::vector<int>>& distanceMatrix,
                                                int firstIndex, int secondIndex) const
     {
-        int delta = 0;
-
-        int firstNode = nodes[firstIndex];
-        int secondNode = nodes[secondIndex];
-
-        if (firstNode == secondNode)
-            return 0;
-
-        // Get previous and next of the first node
-        int firstPrevIdx = getPrevNodeIndex(firstIndex);
-        int firstNextIdx = getNextNodeIndex(firstIndex);
-
-        int firstPrevNode = nodes[firstPrevIdx];
-        int firstNextNode = nodes[firstNextIdx];
-
-        // Get previous and next of the second node
-        int secondPrevIdx = getPrevNodeIndex(secondIndex);
-        int secondNextIdx = getNextNodeIndex(secondIndex);
-
-        int secondPrevNode = nodes[secondPrevIdx];
-        int secondNextNode = nodes[secondNextIdx];
-
-        if (secondNextNode == firstNode)
-        {
-            // Switch first node with second node
-            // if second node precedes the first one
-            std::swap(firstNode, secondNode);
-        }
-
-        // Subtract distances between first-previous and second-next
-        subtractDistanceFromDelta(delta, distanceMatrix, firstPrevNode, firstNode);
-        subtractDistanceFromDelta(delta, distanceMatrix, secondNode, secondNextNode);
-
-        // Add distances between first-prev - second and first - second-next
-        addDistanceToDelta(delta, distanceMatrix, firstPrevNode, secondNode);
-        addDistanceToDelta(delta, distanceMatrix, firstNode, secondNextNode);
-
-        if (areConsecutive(firstIndex, secondIndex))
-        {
-            // This is enough to do for consecutive nodes
-            return delta;
-        }
-
-        // Subtract distances between first - first-next and second-prev - second
-        subtractDistanceFromDelta(delta, distanceMatrix, firstNode, firstNextNode);
-        subtractDistanceFromDelta(delta, distanceMatrix, secondPrevNode, secondNode);
-
-        // Add distances between second - first-next and first - second-prev
-        addDistanceToDelta(delta, distanceMatrix, secondNode, firstNextNode);
-        addDistanceToDelta(delta, distanceMatrix, firstNode, secondPrevNode);
-
-        return delta;
+        return TourCore::TwoNodes::delta(tourView(), TourCore::NestedDistances{&distanceMatrix}, nullptr,
+                                         firstIndex, secondIndex);
     }
 
     int Solution::calculateDeltaInterRouteNodesCandidates(const std::vector<std::vector<int>>& distanceMatrix,
@@ -301,22 +265,8 @@ namespace LS {
     int Solution::calculateDeltaIntraRouteEdges(const std::vector<std::vector<int>>& distanceMatrix,
                                                int firstEdgeIndex, int secondEdgeIndex) const
     {
-        // Get the nodes that are connected by edges
-        int node1Edge1 = nodes[firstEdgeIndex];
-        int node2Edge1 = nodes[getNextNodeIndex(firstEdgeIndex)];
-        int node1Edge2 = nodes[secondEdgeIndex];
-        int node2Edge2 = nodes[getNextNodeIndex(secondEdgeIndex)];
-
-        int delta = 0;
-        // Subtract distances of erased edges
-        delta -= distanceMatrix[node1Edge1][node2Edge1];
-        delta -= distanceMatrix[node1Edge2][node2Edge2];
-
-        // Add distances of new edges
-        delta += distanceMatrix[node1Edge1][node1Edge2];
-        delta += distanceMatrix[node2Edge1][node2Edge2];
-
-        return delta;
+        return TourCore::TwoEdges::delta(tourView(), TourCore::NestedDistances{&distanceMatrix}, nullptr,
+                                         firstEdgeIndex, secondEdgeIndex);
     }
 
     void Solution::subtractDistanceFromDelta(int& delta, const std::vector<std::vector<int>>& distanceMatrix,
@@ -3,8 +3,10 @@
 
 #include <vector>
 #include <string>
-#include <set>
 #include <limits>
+#include <cstdint>
+
+#include "TourCore.h"
 
 namespace LS {
 
@@ -12,10 +14,20 @@ namespace LS {
     protected:
         std::vector<int> nodes;
         int numNodes;
-        std::set<int> selectedNodes;
+        // selected[node] != 0 iff node is in the tour; grows to the largest node id seen, so
+        // membership updates and copies between solutions of one instance never allocate
+        std::vector<char> selected;
+        // TourHash of the tour, updated by every modification
+        uint64_t hash;
+
+        void markSelected(int node, char value);
+        // Toggles the key of the edge leaving position index
+        void toggleEdgeAt(int index);
+        // The nodes as seen by the kernels of TourCore.h
+        TourCore::ArrayTour tourView() const;
 
     public:
-        Solution() : numNodes(0) {}
+        Solution() : numNodes(0), hash(0) {}
 
         void addNode(int node);
         void removeNode(int index);
@@ -24,17 +36,22 @@ namespace LS {
 
         const std::vector<int>& getNodes() const;
         void setNodes(const std::vector<int>& newNodes);
+        // Exchanges the tour with newNodes, which receives the previous tour and its capacity
+        void swapNodes(std::vector<int>& newNodes);
+
+        // Equal for tours with the same nodes and edges, whatever their rotation or direction
+        uint64_t getHash() const;
 
         int getNumberOfNodes() const;
         int calculateNumberOfNodes() const;
 
-        const std::set<int>& getSelectedNodes() const;
-        void setSelectedNodes(const std::set<int>& newSelected);
         void updateSelectedNodes();
 
         int getNodeAtIndex(int index) const;
-        int getNextNodeIndex(int index) const;
-        int getPrevNodeIndex(int index) const;
+        // Positions wrap with a branch instead of a modulo; index must be a position of the
+        // tour. Defined here so that the move loops inline them.
+        int getNextNodeIndex(int index) const { return index + 1 == numNodes ? 0 : index + 1; }
+        int getPrevNodeIndex(int index) const { return index == 0 ? numNodes - 1 : index - 1; }
         int findNodeIndex(int node) const;
 
         void exchangeNodeAtIndex(int index, int newNode);
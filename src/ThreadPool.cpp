@@ -0,0 +1,110 @@
+#include "ThreadPool.h"
+
+namespace LS {
+
+    ThreadPool::ThreadPool(unsigned int numThreads)
+        : currentTask(nullptr), taskCount(0), nextTaskIndex(0),
+          activeWorkers(0), generation(0), stopping(false)
+    {
+        if (numThreads == 0)
+        {
+            numThreads = defaultThreadCount();
+        }
+
+        workers.reserve(numThreads);
+        for (unsigned int i = 0; i < numThreads; ++i)
+        {
+            workers.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    unsigned int ThreadPool::size() const
+    {
+        return workers.size();
+    }
+
+    unsigned int ThreadPool::defaultThreadCount()
+    {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        return hardwareThreads > 0 ? hardwareThreads : 1;
+    }
+
+    void ThreadPool::parallelFor(int count, const Task& task)
+    {
+        if (count <= 0) return;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        currentTask = &task;
+        taskCount = count;
+        nextTaskIndex.store(0, std::memory_order_relaxed);
+        activeWorkers = workers.size();
+        firstError = nullptr;
+        ++generation;
+        workAvailable.notify_all();
+
+        workDone.wait(lock, [this] { return activeWorkers == 0; });
+        currentTask = nullptr;
+
+        if (firstError)
+        {
+            std::exception_ptr error = firstError;
+            firstError = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    void ThreadPool::workerLoop(unsigned int workerIndex)
+    {
+        unsigned long long seenGeneration = 0;
+
+        while (true)
+        {
+            const Task* task;
+            int count;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                workAvailable.wait(lock, [&] { return stopping || generation != seenGeneration; });
+                if (stopping) return;
+                seenGeneration = generation;
+                task = currentTask;
+                count = taskCount;
+            }
+
+            // Claim task indices until the range is exhausted
+            int taskIndex;
+            while ((taskIndex = nextTaskIndex.fetch_add(1, std::memory_order_relaxed)) < count)
+            {
+                try {
+                    (*task)(taskIndex, workerIndex);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!firstError) firstError = std::current_exception();
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--activeWorkers == 0)
+                {
+                    workDone.notify_one();
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,55 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <exception>
+
+namespace LS {
+
+    // Persistent pool of worker threads executing index ranges.
+    // The calling thread only dispatches work and waits for its completion.
+    class ThreadPool {
+    public:
+        typedef std::function<void(int taskIndex, unsigned int workerIndex)> Task;
+
+    private:
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable workDone;
+
+        const Task* currentTask;
+        int taskCount;
+        std::atomic<int> nextTaskIndex;
+        unsigned int activeWorkers;
+        unsigned long long generation;
+        bool stopping;
+        std::exception_ptr firstError;
+
+        void workerLoop(unsigned int workerIndex);
+
+    public:
+        // numThreads == 0 uses all hardware threads
+        explicit ThreadPool(unsigned int numThreads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        unsigned int size() const;
+
+        // Runs task(i, worker) for every i in [0, count) and blocks until all are done.
+        // The first exception thrown by a task is rethrown here.
+        void parallelFor(int count, const Task& task);
+
+        static unsigned int defaultThreadCount();
+    };
+
+}
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,198 @@
+#ifndef LS_TOUR_CORE_H
+#define LS_TOUR_CORE_H
+
+#include <vector>
+
+namespace LS {
+
+    // Header-only core of the move deltas, the evaluation and the 2-opt reversal, shared by
+    // Solution and by the C solvers of 01_greedy_heuristics through moves.cpp, so that both
+    // compute every move the same way. Kernels are templates over
+    //  - a distance provider: distances(a, b) between two nodes,
+    //  - a tour view: tour[i], tour.next(i), tour.prev(i) and tour.size() over the positions
+    //    of a cycle,
+    //  - a neighborhood: a type whose static delta(tour, distances, costs, a, b) prices a move.
+    // Kernels count nothing; the callers keep their own instrumentation. visit picks a tour
+    // view whose size is a compile-time constant for the common instance sizes.
+    namespace TourCore {
+
+        // Rows of a matrix, the int** of the C solvers
+        struct RowDistances {
+            const int* const* rows;
+
+            int operator()(int a, int b) const { return rows[a][b]; }
+        };
+
+        // DistanceMatrix::getDistanceMatrix
+        struct NestedDistances {
+            const std::vector<std::vector<int>>* matrix;
+
+            int operator()(int a, int b) const { return (*matrix)[a][b]; }
+        };
+
+        // Cycle held in an array, one node per position; neighbours wrap without a modulo
+        struct ArrayTour {
+            const int* nodes;
+            int length;
+
+            int operator[](int i) const { return nodes[i]; }
+            int size() const { return length; }
+            int next(int i) const { return i + 1 == length ? 0 : i + 1; }
+            int prev(int i) const { return i == 0 ? length - 1 : i - 1; }
+        };
+
+        // ArrayTour of a size known at compile time: the wrap compares with a constant and loops
+        // bounded by size() have a constant trip count the compiler can unroll
+        template <int N>
+        struct FixedTour {
+            static_assert(N > 0, "A fixed tour has at least one node");
+            const int* nodes;
+
+            int operator[](int i) const { return nodes[i]; }
+            static constexpr int size() { return N; }
+            int next(int i) const { return i + 1 == N ? 0 : i + 1; }
+            int prev(int i) const { return i == 0 ? N - 1 : i - 1; }
+        };
+
+        template <int... Sizes>
+        struct SizeList {};
+
+        // Tour sizes with a FixedTour instantiation of the sweeps that go through visit: 100 are
+        // the selected nodes of the 200-node instances at fraction 0.5. Building with
+        // LS_FIXED_TOUR_SIZES= (empty) keeps only the runtime-size ArrayTour.
+#ifndef LS_FIXED_TOUR_SIZES
+#define LS_FIXED_TOUR_SIZES 100
+#endif
+        using FixedSizes = SizeList<LS_FIXED_TOUR_SIZES>;
+
+        template <typename Visitor>
+        auto visit(const int* nodes, int size, Visitor&& visitor, SizeList<>)
+        {
+            return visitor(ArrayTour{nodes, size});
+        }
+
+        template <typename Visitor, int N, int... Rest>
+        auto visit(const int* nodes, int size, Visitor&& visitor, SizeList<N, Rest...>)
+        {
+            if (size == N)
+            {
+                return visitor(FixedTour<N>{nodes});
+            }
+            return visit(nodes, size, visitor, SizeList<Rest...>());
+        }
+
+        // Calls visitor with the FixedTour of the nodes if their number is one of FixedSizes,
+        // with their ArrayTour otherwise; every instantiation must return the same type
+        template <typename Visitor>
+        auto visit(const int* nodes, int size, Visitor&& visitor)
+        {
+            return visit(nodes, size, visitor, FixedSizes());
+        }
+
+        // Swap of the nodes at positions a and b
+        struct TwoNodes {
+            template <typename Tour, typename Distances>
+            static int delta(const Tour& tour, const Distances& distances, const int*, int a, int b)
+            {
+                // Swapping within a cycle of two nodes changes nothing
+                if (a == b || tour.size() < 3)
+                {
+                    return 0;
+                }
+                // Adjacent nodes are handled with a before b
+                if (a == tour.next(b))
+                {
+                    int swap = a;
+                    a = b;
+                    b = swap;
+                }
+                int nodeA = tour[a];
+                int nodeB = tour[b];
+                int prevA = tour[tour.prev(a)];
+                int nextB = tour[tour.next(b)];
+                if (b == tour.next(a))
+                {
+                    return distances(prevA, nodeB) + distances(nodeA, nextB) -
+                           distances(prevA, nodeA) - distances(nodeB, nextB);
+                }
+                int nextA = tour[tour.next(a)];
+                int prevB = tour[tour.prev(b)];
+                return distances(prevA, nodeB) + distances(nodeB, nextA) + distances(prevB, nodeA) +
+                       distances(nodeA, nextB) - distances(prevA, nodeA) - distances(nodeA, nextA) -
+                       distances(prevB, nodeB) - distances(nodeB, nextB);
+            }
+        };
+
+        // 2-opt removing the edges leaving positions a and b; 0 for identical or adjacent edges
+        struct TwoEdges {
+            template <typename Tour, typename Distances>
+            static int delta(const Tour& tour, const Distances& distances, const int*, int a, int b)
+            {
+                int nextA = tour.next(a);
+                int nextB = tour.next(b);
+                if (a == b || nextA == b || nextB == a)
+                {
+                    return 0;
+                }
+                return distances(tour[a], tour[b]) + distances(tour[nextA], tour[nextB]) -
+                       distances(tour[a], tour[nextA]) - distances(tour[b], tour[nextB]);
+            }
+        };
+
+        // Replacement of the node at position a by the unselected node b
+        struct InterRoute {
+            template <typename Tour, typename Distances>
+            static int delta(const Tour& tour, const Distances& distances, const int* costs, int a, int b)
+            {
+                int node = tour[a];
+                int prev = tour[tour.prev(a)];
+                int next = tour[tour.next(a)];
+                return costs[b] - costs[node] + distances(prev, b) + distances(b, next) -
+                       distances(prev, node) - distances(node, next);
+            }
+        };
+
+        template <typename Neighborhood, typename Tour, typename Distances>
+        int delta(const Tour& tour, const Distances& distances, const int* costs, int a, int b)
+        {
+            return Neighborhood::delta(tour, distances, costs, a, b);
+        }
+
+        // Length of the cycle plus the costs of its nodes, 0 for an empty tour
+        template <typename Tour, typename Distances>
+        int evaluate(const Tour& tour, const Distances& distances, const int* costs)
+        {
+            int size = tour.size();
+            if (size == 0)
+            {
+                return 0;
+            }
+            int total = costs[tour[0]] + distances(tour[size - 1], tour[0]);
+            for (int i = 1; i < size; ++i)
+            {
+                total += costs[tour[i]] + distances(tour[i - 1], tour[i]);
+            }
+            return total;
+        }
+
+        // Reverses the cyclic segment nodes[start..end] in place, which applies the 2-opt
+        // move TwoEdges prices for the edges leaving start - 1 and end
+        inline void reverseSegment(int* nodes, int size, int start, int end)
+        {
+            int i = start;
+            int j = end;
+            while (i != j && (i == 0 ? size - 1 : i - 1) != j)
+            {
+                int swap = nodes[i];
+                nodes[i] = nodes[j];
+                nodes[j] = swap;
+                i = i + 1 == size ? 0 : i + 1;
+                j = j == 0 ? size - 1 : j - 1;
+            }
+        }
+
+    }
+
+}
+
+#endif // LS_TOUR_CORE_H
@@ -0,0 +1,73 @@
+#include "TourHash.h"
+
+namespace LS {
+
+    uint64_t TourHash::of(const std::vector<int>& nodes)
+    {
+        uint64_t hash = 0;
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+            hash ^= node(nodes[i]);
+            hash ^= edge(nodes[i], nodes[i + 1 == nodes.size() ? 0 : i + 1]);
+        }
+        return hash;
+    }
+
+    SeenSet::SeenSet(std::size_t capacity)
+    {
+        std::size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        slots = std::vector<std::atomic<uint64_t>>(size);
+        mask = size - 1;
+        clear();
+    }
+
+    bool SeenSet::contains(uint64_t hash) const
+    {
+        hash = hash != 0 ? hash : 1;
+        for (std::size_t probe = 0; probe < MAX_PROBES; ++probe)
+        {
+            uint64_t slot = slots[(hash + probe) & mask].load(std::memory_order_relaxed);
+            if (slot == hash)
+            {
+                return true;
+            }
+            if (slot == 0)
+            {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool SeenSet::insert(uint64_t hash)
+    {
+        hash = hash != 0 ? hash : 1;
+        for (std::size_t probe = 0; probe < MAX_PROBES; ++probe)
+        {
+            uint64_t expected = 0;
+            if (slots[(hash + probe) & mask].compare_exchange_strong(expected, hash, std::memory_order_relaxed))
+            {
+                return true;
+            }
+            // The slot was taken, by this very hash if it was inserted before
+            if (expected == hash)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void SeenSet::clear()
+    {
+        for (auto& slot : slots)
+        {
+            slot.store(0, std::memory_order_relaxed);
+        }
+    }
+
+}
@@ -0,0 +1,69 @@
+#ifndef LS_TOUR_HASH_H
+#define LS_TOUR_HASH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LS {
+
+    // Zobrist-style hash of a tour: the XOR of a key per selected node and a key per undirected
+    // edge of the cycle, so rotations and reversals hash equally and every move updates it in
+    // O(1) by toggling the keys it changes. Keys are mixed from the node indices rather than
+    // drawn from a table, and equal those of 01_greedy_heuristics/include/tour_hash.h.
+    namespace TourHash {
+
+        inline uint64_t mix(uint64_t z)
+        {
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        // The top bit keeps node keys apart from every edge key
+        inline uint64_t node(int n)
+        {
+            return mix(static_cast<uint64_t>(static_cast<uint32_t>(n)) | (1ULL << 63));
+        }
+
+        inline uint64_t edge(int a, int b)
+        {
+            uint32_t low = static_cast<uint32_t>(a < b ? a : b);
+            uint32_t high = static_cast<uint32_t>(a < b ? b : a);
+            return mix((static_cast<uint64_t>(low) << 32) | high);
+        }
+
+        // Hash of the cycle nodes, computed from scratch
+        uint64_t of(const std::vector<int>& nodes);
+
+    }
+
+    // Fixed-capacity set of tour hashes shared by concurrent searches without locks: open
+    // addressing over atomic slots, filled with compare-and-swap. A hash that finds no free
+    // slot within MAX_PROBES is left out, so a full set filters less instead of failing.
+    class SeenSet {
+    public:
+        static const int MAX_PROBES = 32;
+
+    private:
+        std::vector<std::atomic<uint64_t>> slots; // 0 marks an empty slot, hash 0 is stored as 1
+        std::size_t mask;
+
+    public:
+        // Room for about capacity hashes, rounded up to a power of two
+        explicit SeenSet(std::size_t capacity);
+
+        SeenSet(const SeenSet&) = delete;
+        SeenSet& operator=(const SeenSet&) = delete;
+
+        bool contains(uint64_t hash) const;
+        // Returns false if hash was inserted before, true otherwise
+        bool insert(uint64_t hash);
+        // Must not run concurrently with the other members
+        void clear();
+    };
+
+}
+
+#endif // LS_TOUR_HASH_H
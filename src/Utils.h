@@ -1,5 +1,5 @@
-#ifndef UTILS_H
-#define UTILS_H
+#ifndef LS_UTILS_H
+#define LS_UTILS_H
 
 #include <vector>
 #include <string>
@@ -46,4 +46,4 @@ namespace LS {
 
 }
 
-#endif // UTILS_H
+#endif // LS_UTILS_H
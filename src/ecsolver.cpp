@@ -0,0 +1,190 @@
+#include "ecsolver.h"
+#include "EmbeddedSolver.h"
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct ecs_instance {
+    std::shared_ptr<const LS::DistanceMatrix> matrix;
+};
+
+struct ecs_solver {
+    std::shared_ptr<const LS::DistanceMatrix> matrix;
+    LS::SolverOptions options;
+    // Rebuilt when an option changes, never while a solve runs
+    std::unique_ptr<LS::EmbeddedSolver> solver;
+    bool solved = false;
+};
+
+namespace {
+
+    thread_local std::string lastError;
+
+    // Runs body, turning an exception into the thread's last error and the failure value
+    template <typename T, typename Body>
+    T guarded(T failure, Body body)
+    {
+        try
+        {
+            lastError.clear();
+            return body();
+        }
+        catch (const std::exception& e)
+        {
+            lastError = e.what();
+        }
+        catch (...)
+        {
+            lastError = "Unknown error";
+        }
+        return failure;
+    }
+
+}
+
+extern "C" {
+
+const char* ecs_last_error(void)
+{
+    return lastError.c_str();
+}
+
+ecs_instance* ecs_instance_create(const int* xs, const int* ys, const int* costs, int count)
+{
+    return guarded<ecs_instance*>(nullptr, [&]()
+    {
+        if (!xs || !ys || !costs || count < 1)
+        {
+            throw std::runtime_error("Instance needs at least one node with coordinates and a cost");
+        }
+        std::unique_ptr<ecs_instance> instance(new ecs_instance());
+        instance->matrix = LS::DistanceMatrix::fromCoordinates(std::vector<int>(xs, xs + count),
+                                                               std::vector<int>(ys, ys + count),
+                                                               std::vector<int>(costs, costs + count));
+        return instance.release();
+    });
+}
+
+ecs_instance* ecs_instance_load(const char* filename)
+{
+    return guarded<ecs_instance*>(nullptr, [&]()
+    {
+        if (!filename)
+        {
+            throw std::runtime_error("No instance file given");
+        }
+        std::unique_ptr<ecs_instance> instance(new ecs_instance());
+        instance->matrix = LS::DistanceMatrix::load(filename);
+        if (instance->matrix->getCosts().empty())
+        {
+            throw std::runtime_error(std::string("No nodes read from ") + filename);
+        }
+        return instance.release();
+    });
+}
+
+int ecs_instance_size(const ecs_instance* instance)
+{
+    return instance ? static_cast<int>(instance->matrix->getCosts().size()) : 0;
+}
+
+void ecs_instance_destroy(ecs_instance* instance)
+{
+    delete instance;
+}
+
+ecs_solver* ecs_solver_create(const ecs_instance* instance, const char* algorithm)
+{
+    return guarded<ecs_solver*>(nullptr, [&]()
+    {
+        if (!instance || !algorithm)
+        {
+            throw std::runtime_error("An instance and an algorithm are required");
+        }
+        std::unique_ptr<ecs_solver> solver(new ecs_solver());
+        solver->matrix = instance->matrix;
+        solver->options.algorithm = algorithm;
+        solver->solver.reset(new LS::EmbeddedSolver(solver->matrix, solver->options));
+        return solver.release();
+    });
+}
+
+int ecs_solver_set(ecs_solver* solver, const char* key, const char* value)
+{
+    return guarded<int>(-1, [&]()
+    {
+        if (!solver || !key || !value)
+        {
+            throw std::runtime_error("A solver, a key and a value are required");
+        }
+        // The solver is only replaced once the new options proved valid
+        LS::SolverOptions options = solver->options;
+        options.apply(key, value);
+        solver->solver.reset(new LS::EmbeddedSolver(solver->matrix, options));
+        solver->options = options;
+        solver->solved = false;
+        return 0;
+    });
+}
+
+int ecs_solve(ecs_solver* solver, double time_limit_ms)
+{
+    return guarded<int>(-1, [&]()
+    {
+        if (!solver)
+        {
+            throw std::runtime_error("No solver given");
+        }
+        solver->solver->solve(time_limit_ms);
+        solver->solved = true;
+        return 0;
+    });
+}
+
+void ecs_cancel(ecs_solver* solver)
+{
+    if (solver)
+    {
+        solver->solver->cancel();
+    }
+}
+
+int ecs_result_evaluation(const ecs_solver* solver)
+{
+    return solver && solver->solved ? solver->solver->getResult().evaluation : -1;
+}
+
+int ecs_result_tour(const ecs_solver* solver, int* nodes, int capacity)
+{
+    if (!solver || !solver->solved)
+    {
+        return 0;
+    }
+    const std::vector<int>& tour = solver->solver->getResult().tour;
+    if (nodes && capacity > 0)
+    {
+        std::copy_n(tour.begin(), std::min<std::size_t>(capacity, tour.size()), nodes);
+    }
+    return static_cast<int>(tour.size());
+}
+
+int ecs_result_iterations(const ecs_solver* solver)
+{
+    return solver && solver->solved ? solver->solver->getResult().iterations : 0;
+}
+
+double ecs_result_time_ms(const ecs_solver* solver)
+{
+    return solver && solver->solved ? solver->solver->getResult().elapsedMs : 0.0;
+}
+
+void ecs_solver_destroy(ecs_solver* solver)
+{
+    delete solver;
+}
+
+}
@@ -0,0 +1,95 @@
+#ifndef ECSOLVER_H
+#define ECSOLVER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief C interface of libecsolver, a thin layer over LS::EmbeddedSolver.
+ * Handles are opaque and options are set by name, so that new options never change the ABI.
+ * Functions returning int return 0 on success and -1 on failure, pointers NULL on failure;
+ * ecs_last_error then describes the failure.
+ */
+typedef struct ecs_instance ecs_instance;
+typedef struct ecs_solver ecs_solver;
+
+/**
+ * @brief Message of the last failure on the calling thread, "" if none. Valid until the
+ * next call on that thread.
+ */
+const char* ecs_last_error(void);
+
+/**
+ * @brief Instance of count nodes held in memory; the arrays are copied.
+ */
+ecs_instance* ecs_instance_create(const int* xs, const int* ys, const int* costs, int count);
+
+/**
+ * @brief Instance read from a file of x;y;cost lines like TSPA.csv.
+ */
+ecs_instance* ecs_instance_load(const char* filename);
+
+int ecs_instance_size(const ecs_instance* instance);
+
+/**
+ * @brief Solvers created from the instance keep their own reference to it, so it may be
+ * destroyed before them. NULL is ignored.
+ */
+void ecs_instance_destroy(ecs_instance* instance);
+
+/**
+ * @brief Solver of the given algorithm: "ls", "lns", "lns-ls", "hea", "hea-ls", "ils",
+ * "nn-end" or "nn-anywhere".
+ */
+ecs_solver* ecs_solver_create(const ecs_instance* instance, const char* algorithm);
+
+/**
+ * @brief Sets one option: fraction, seed, population, workers, perturbation or
+ * eval-threads (see LS::SolverOptions). Options set after the first solve restart the
+ * solver's random stream.
+ */
+int ecs_solver_set(ecs_solver* solver, const char* key, const char* value);
+
+/**
+ * @brief Runs the solver for time_limit_ms milliseconds.
+ */
+int ecs_solve(ecs_solver* solver, double time_limit_ms);
+
+/**
+ * @brief Ends the running ecs_solve early, which then returns the best solution found so far;
+ * the only function that may be called from another thread while it runs. "nn-end" and
+ * "nn-anywhere" ignore it and complete their constructions.
+ */
+void ecs_cancel(ecs_solver* solver);
+
+/**
+ * @brief Objective of the last solve, -1 before the first.
+ */
+int ecs_result_evaluation(const ecs_solver* solver);
+
+/**
+ * @brief Copies up to capacity nodes of the best tour of the last solve into nodes.
+ *
+ * @return The number of nodes of the tour, which may exceed capacity; 0 before the first solve.
+ */
+int ecs_result_tour(const ecs_solver* solver, int* nodes, int capacity);
+
+/**
+ * @brief Iterations of the last LNS, HEA or ILS solve, constructions of "nn-end" and
+ * "nn-anywhere", 0 for "ls".
+ */
+int ecs_result_iterations(const ecs_solver* solver);
+
+double ecs_result_time_ms(const ecs_solver* solver);
+
+/**
+ * @brief NULL is ignored.
+ */
+void ecs_solver_destroy(ecs_solver* solver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECSOLVER_H
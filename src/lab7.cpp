@@ -1,6 +1,13 @@
 #include "LSNLocalSearchSolver.h"
+#include "HEASolver.h"
 #include "Utils.h"
 #include "RandomSolution.h"
+#include "ThreadPool.h"
+#include "RandomGenerator.h"
+#include "Instrumentation.h"
+#include "ConvergenceTrace.h"
+#include "ExperimentConfig.h"
+#include "SharedIncumbent.h"
 
 #include <vector>
 #include <iostream>
@@ -8,64 +15,136 @@
 #include <limits>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <chrono>
+#include <ctime>
+#include <type_traits>
 namespace LS {
 
-    // List of instances
-    std::vector<std::string> instances = {
-        "data/TSPA.csv",
-        "data/TSPB.csv"
+    // Outcome of a single LNS or HEA repetition, filled in by the worker that ran it
+    struct RepetitionResult {
+        int evaluation;
+        int initialEvaluation;
+        int iterations;
+        int restarts;
+        double generationTime;
+        std::vector<int> nodes;
+        RunCounters counters;
     };
 
-    void runExperiment(bool innerLocalSearch)
+    // Solver is LSNLocalSearchSolver or HEASolver; label names it in the report and output files.
+    // evalPool, if any, splits the steepest sweeps of the runs, which pool then runs one at a time
+    template <typename Solver>
+    void runExperiment(const ExperimentConfig& config, bool innerLocalSearch, ThreadPool& pool, ThreadPool* heaPool,
+                       ThreadPool* evalPool, const std::string& label)
     {
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
-        const int repetitions = 20   ;
-        // Time limits in microseconds
-        std::vector<double> timeLimits = { 20173.5*1000 , 22698.6*1000 };
+        // The seed is printed so that any experiment can be replayed bit for bit
+        const uint64_t baseSeed = config.seed;
+        std::cout << "Seed: " << baseSeed << std::endl;
+        const int repetitions = config.repetitions;
 
         int instanceIdx = 0;
-        for (const auto& instance : instances)
+        for (const auto& instance : config.instances)
         {
-            std::cout << "Processing Instance: " << instance.substr(instance.find_last_of("/\\") + 1, 4) << std::endl;
+            // Instance data is loaded once and shared read-only by every worker's solver
+            auto instanceData = DistanceMatrix::load(instance);
+            std::string instanceName = BaseSolver::instanceNameFromFilename(instance);
+            std::cout << "Processing Instance: " << instanceName << std::endl;
 
-            double timeLimitMicroseconds = timeLimits[instanceIdx];
+            double timeLimitMicroseconds = config.timeLimitMs(instanceIdx) * 1000;
             ++instanceIdx;
 
+            // One independent stream for the shared initial solution and one per repetition
+            std::vector<Rng> streams = Rng::split(baseSeed + instanceIdx, repetitions + 1);
+            Rng& initialRng = streams[repetitions];
+            int totalNodes = static_cast<int>(instanceData->getCosts().size());
             RandomSolution initialSolution;
-            initialSolution.generate(200, 100); // Adjust parameters as needed
+            initialSolution.generate(totalNodes, static_cast<int>(totalNodes * config.fractionNodes), initialRng);
 
-            LSNLocalSearchSolver lsnlss(instance, 0.5, initialSolution);
+            // Concurrent runs share their best solution only when restarts are enabled
+            SharedIncumbent incumbent(totalNodes);
+            std::vector<std::unique_ptr<Solver>> solvers;
+            for (unsigned int w = 0; w < pool.size(); ++w)
+            {
+                solvers.emplace_back(new Solver(instanceData, instanceName, config.fractionNodes, initialSolution));
+                if constexpr (std::is_same_v<Solver, HEASolver>)
+                {
+                    solvers.back()->setPopulationSize(config.populationSize);
+                    solvers.back()->setWorkerPool(heaPool);
+                }
+                if (evalPool != nullptr)
+                {
+                    solvers.back()->setParallelEvaluation(evalPool);
+                }
+                if (config.restartAfter > 0)
+                {
+                    solvers.back()->setIncumbent(&incumbent, config.restartAfter);
+                }
+            }
+
+            std::vector<RepetitionResult> results(repetitions);
+            // Convergence of every repetition, to find the smallest budget reaching the plateau
+            std::vector<ConvergenceTrace> traces(repetitions);
+            pool.parallelFor(repetitions, [&](int rep, unsigned int worker)
+            {
+                Solver& solver = *solvers[worker];
+                // The stream depends only on the repetition, not on the worker that picked it up
+                solver.setRng(streams[rep]);
+                solver.setTrace(&traces[rep]);
+
+                auto runStart = std::chrono::steady_clock::now();
+                solver.run(timeLimitMicroseconds, innerLocalSearch);
+                auto runEnd = std::chrono::steady_clock::now();
+
+                RepetitionResult& result = results[rep];
+                result.generationTime = std::chrono::duration_cast<std::chrono::microseconds>(runEnd - runStart).count();
+                result.evaluation = solver.getBestSolutionEval();
+                result.initialEvaluation = solver.getInitialLocalSearchEval();
+                result.iterations = solver.getIterationCounts().back();
+                result.restarts = solver.getRestartCount();
+                result.nodes = solver.getBestSolution();
+                result.counters = solver.getRunCounters();
+            });
+
+            // Aggregate in repetition order so the report does not depend on scheduling
             std::vector<int> bestEvaluations;
             std::vector<double> generationTimes;
+            std::vector<int> iterationCounts;
             Solution bestSol = initialSolution;
             int bestEval = std::numeric_limits<int>::max();
 
-            for (int i = 0; i < repetitions; ++i)
+            for (int rep = 0; rep < repetitions; ++rep)
             {
-                auto runStart = std::chrono::steady_clock::now();
-                lsnlss.run(timeLimitMicroseconds, innerLocalSearch);
-                auto runEnd = std::chrono::steady_clock::now();
-
-                double generationTime = std::chrono::duration_cast<std::chrono::microseconds>(runEnd - runStart).count();
-                generationTimes.emplace_back(generationTime);
+                const RepetitionResult& result = results[rep];
+                std::cout << result.initialEvaluation << std::endl;
+                std::cout << "Best found in run of " << label << ": " << result.evaluation << std::endl;
+                if (Instrumentation::enabled)
+                {
+                    std::cout << result.counters.toJson(
+                        "\"instance\": \"" + instanceName + "\", \"repetition\": " + std::to_string(rep) +
+                        ", \"inner_local_search\": " + (innerLocalSearch ? "true" : "false") +
+                        ", \"iterations\": " + std::to_string(result.iterations) +
+                        ", \"restarts\": " + std::to_string(result.restarts) +
+                        ", \"best\": " + std::to_string(result.evaluation)) << std::endl;
+                }
 
-                int eval = lsnlss.getBestSolutionEval();
-                bestEvaluations.emplace_back(eval);
+                generationTimes.emplace_back(result.generationTime);
+                bestEvaluations.emplace_back(result.evaluation);
+                iterationCounts.emplace_back(result.iterations);
 
-                if (eval < bestEval)
+                if (result.evaluation < bestEval)
                 {
-                    bestEval = eval;
-                    bestSol.setNodes(lsnlss.getBestSolution());
+                    bestEval = result.evaluation;
+                    bestSol.setNodes(result.nodes);
                 }
             }
 
             // Ensure output directory exists
-            std::string instanceName = instance.substr(instance.find_last_of("/\\") + 1, 4);
-            std::string dir = "lab7/solutions/" + instanceName + "/";
+            std::string dir = config.outputDir + "/" + instanceName + "/";
             std::filesystem::create_directories(dir);
 
-            std::string filename = innerLocalSearch ? "LSNLS_INNER_LOCAL_SEARCH.txt" : "LSNLS_NO_INNER_LOCAL_SEARCH.txt";
-            int totalCost = bestSol.evaluate(lsnlss.getDistanceMatrix(), lsnlss.getCosts());
+            std::string filename = label + (innerLocalSearch ? "_INNER_LOCAL_SEARCH.txt" : "_NO_INNER_LOCAL_SEARCH.txt");
+            int totalCost = bestSol.evaluate(instanceData->getDistanceMatrix(), instanceData->getCosts());
 
             // Open the text file for writing
             std::ofstream outfile(dir + filename);
@@ -84,35 +163,98 @@ namespace LS {
             // Close the file
             outfile.close();
 
+            std::string traceDir = dir + "traces/";
+            std::filesystem::create_directories(traceDir);
+            std::string tracePrefix = label + (innerLocalSearch ? "_INNER_LOCAL_SEARCH" : "_NO_INNER_LOCAL_SEARCH");
+            for (int rep = 0; rep < repetitions; ++rep)
+            {
+                traces[rep].writeCSV(traceDir + tracePrefix + "_" + std::to_string(rep) + ".csv");
+            }
+
             // bestSol.writeToCSV(dir + filename + ".txt");
 
 
             int minEval, maxEval;
             double avgEval;
             Utils::calculateStats(bestEvaluations, minEval, avgEval, maxEval);
-            std::cout << "EVAL LSNLS " << avgEval << " (" << minEval << "-" << maxEval << ")" << std::endl;
+            std::cout << "EVAL " << label << " " << avgEval << " (" << minEval << "-" << maxEval << ")" << std::endl;
 
             double minTime, avgTime, maxTime;
             Utils::calculateStats(generationTimes, minTime, avgTime, maxTime);
             // Convert to milliseconds for output
-            std::cout << "TIME LSNLS " << avgTime / 1000 << " ms (" << minTime / 1000 << "-" << maxTime / 1000 << " ms)" << std::endl;
+            std::cout << "TIME " << label << " " << avgTime / 1000 << " ms (" << minTime / 1000 << "-" << maxTime / 1000 << " ms)" << std::endl;
 
-            double avgIterations = lsnlss.getAverageIterations();
+            double avgIterations = Utils::mean(iterationCounts);
             std::cout << "Average number of iterations: " << avgIterations << std::endl;
+            if (config.restartAfter > 0)
+            {
+                int restarts = 0;
+                for (const auto& result : results) restarts += result.restarts;
+                std::cout << "Restarts from incumbent: " << restarts << " (" << incumbent.getPublications()
+                          << " publications)" << std::endl;
+            }
         }
     }
 
 }
 
-int main()
+int main(int argc, char** argv)
 {
-    std::cout << "RUNNING WITHOUT INNER LOCAL SEARCH" << std::endl;
-    bool innerLocalSearch = false;
-    LS::runExperiment(innerLocalSearch);
+    LS::ExperimentConfig config;
+    try
+    {
+        config = LS::ExperimentConfig::parse(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl << LS::ExperimentConfig::usage(argv[0]);
+        return 1;
+    }
+    if (config.helpRequested)
+    {
+        std::cout << LS::ExperimentConfig::usage(argv[0]);
+        return 0;
+    }
+
+    bool hea = config.solver == "hea";
+    // Repetitions are independent, so they are spread over all hardware threads, unless each
+    // HEA run already evolves its population on several
+    std::unique_ptr<LS::ThreadPool> heaPool;
+    if (hea && config.heaWorkers > 1)
+    {
+        heaPool.reset(new LS::ThreadPool(config.heaWorkers));
+    }
+    // A pool runs one parallelFor at a time, so sweeps split over it serve one run at a time
+    std::unique_ptr<LS::ThreadPool> evalPool;
+    if (config.evalThreads > 1)
+    {
+        evalPool.reset(new LS::ThreadPool(config.evalThreads));
+    }
+    LS::ThreadPool pool(heaPool || evalPool ? 1 : config.threads);
 
-    std::cout << std::endl << "RUNNING WITH INNER LOCAL SEARCH" << std::endl;
-    innerLocalSearch = true;
-    LS::runExperiment(innerLocalSearch);
+    auto run = [&](bool innerLocalSearch)
+    {
+        if (hea)
+        {
+            LS::runExperiment<LS::HEASolver>(config, innerLocalSearch, pool, heaPool.get(), evalPool.get(), "HEA");
+        }
+        else
+        {
+            LS::runExperiment<LS::LSNLocalSearchSolver>(config, innerLocalSearch, pool, nullptr, evalPool.get(), "LSNLS");
+        }
+    };
+
+    if (config.runWithoutInnerLocalSearch)
+    {
+        std::cout << "RUNNING WITHOUT INNER LOCAL SEARCH" << std::endl;
+        run(false);
+    }
+
+    if (config.runWithInnerLocalSearch)
+    {
+        std::cout << std::endl << "RUNNING WITH INNER LOCAL SEARCH" << std::endl;
+        run(true);
+    }
 
     return 0;
 }
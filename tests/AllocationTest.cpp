@@ -0,0 +1,114 @@
+#include "LSNLocalSearchSolver.h"
+#include "RandomSolution.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+// Steady-state allocation check of the LNS loop: every operator new is counted, and two runs
+// from the same seed are compared. They follow the same trajectory, so a run given six times
+// the budget allocates exactly as often as the short one, which covers the setup and the
+// warm-up of the buffers, unless its additional iterations allocate.
+namespace {
+
+    std::atomic<long long> allocations(0);
+
+    void* countedAllocation(std::size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        if (void* memory = std::malloc(size == 0 ? 1 : size))
+        {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+
+    void* countedAlignedAllocation(std::size_t size, std::align_val_t alignment)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        std::size_t align = static_cast<std::size_t>(alignment);
+        // aligned_alloc needs a size that is a multiple of the alignment
+        if (void* memory = std::aligned_alloc(align, (size + align - 1) / align * align))
+        {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+
+}
+
+void* operator new(std::size_t size) { return countedAllocation(size); }
+void* operator new[](std::size_t size) { return countedAllocation(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return countedAlignedAllocation(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return countedAlignedAllocation(size, alignment); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+namespace LS {
+
+    struct RunAllocations {
+        long long allocations;
+        int iterations;
+    };
+
+    RunAllocations countRun(std::shared_ptr<const DistanceMatrix> instance, bool innerLocalSearch, double timeLimitMs)
+    {
+        const double fractionNodes = 0.5;
+        int totalNodes = static_cast<int>(instance->getCosts().size());
+        Rng rng(7);
+        RandomSolution initialSolution;
+        initialSolution.generate(totalNodes, static_cast<int>(totalNodes * fractionNodes), rng);
+        LSNLocalSearchSolver solver(instance, "allocations", fractionNodes, initialSolution);
+        solver.setRng(rng);
+
+        long long before = allocations.load();
+        solver.run(timeLimitMs * 1000, innerLocalSearch);
+        return RunAllocations{ allocations.load() - before, solver.getIterationCounts().back() };
+    }
+
+    // Returns false if the iterations beyond the short run allocated
+    bool checkSteadyState(std::shared_ptr<const DistanceMatrix> instance, bool innerLocalSearch)
+    {
+        const char* name = innerLocalSearch ? "LNS with local search" : "LNS";
+        RunAllocations warmedUp = countRun(instance, innerLocalSearch, 100);
+        RunAllocations longer = countRun(instance, innerLocalSearch, 600);
+        std::cout << name << ": " << warmedUp.allocations << " allocations in " << warmedUp.iterations
+                  << " iterations, " << longer.allocations << " in " << longer.iterations << std::endl;
+        if (longer.iterations <= warmedUp.iterations)
+        {
+            std::cout << "FAILED " << name << ": the longer run did not get more iterations" << std::endl;
+            return false;
+        }
+        if (longer.allocations != warmedUp.allocations)
+        {
+            std::cout << "FAILED " << name << ": " << longer.allocations - warmedUp.allocations << " allocations in "
+                      << longer.iterations - warmedUp.iterations << " steady-state iterations" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+}
+
+int main()
+{
+    try
+    {
+        auto instance = LS::DistanceMatrix::load(TEST_DATA_DIR "/TSPA.csv");
+        bool passed = LS::checkSteadyState(instance, false);
+        passed = LS::checkSteadyState(instance, true) && passed;
+        return passed ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,266 @@
+#include "ecsolver.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Drives every algorithm of libecsolver through its C interface only: ecs_instance_create,
+// ecs_solver_set, ecs_solve and ecs_cancel from another thread. Every tour must select the
+// floor(n * fraction) nodes of the fraction set, whichever codebase the algorithm comes from,
+// and be priced as its reported evaluation.
+
+#define NUM_NODES 101
+
+static const char *ALGORITHMS[] = {"ls", "lns", "lns-ls", "hea", "hea-ls", "ils", "nn-end", "nn-anywhere"};
+#define NUM_ALGORITHMS ((int)(sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0])))
+
+static int passed = 1;
+static int xs[NUM_NODES];
+static int ys[NUM_NODES];
+static int costs[NUM_NODES];
+
+static void fail(const char *algorithm, const char *message)
+{
+    printf("FAILED %s: %s\n", algorithm, message);
+    passed = 0;
+}
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void sleep_ms(long ms)
+{
+    struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+// Checks that the last result of solver is a tour of expected_size distinct nodes whose
+// objective, recomputed here, is the reported evaluation
+static void check_result(const char *algorithm, const ecs_solver *solver, int expected_size)
+{
+    int tour[NUM_NODES];
+    int size = ecs_result_tour(solver, tour, NUM_NODES);
+    if (size != expected_size)
+    {
+        char message[96];
+        snprintf(message, sizeof(message), "tour of %d nodes instead of %d", size, expected_size);
+        fail(algorithm, message);
+        return;
+    }
+
+    char used[NUM_NODES] = {0};
+    long long objective = 0;
+    for (int i = 0; i < size; i++)
+    {
+        int node = tour[i];
+        if (node < 0 || node >= NUM_NODES || used[node])
+        {
+            fail(algorithm, "tour repeats a node or holds an invalid one");
+            return;
+        }
+        used[node] = 1;
+        int next = tour[(i + 1) % size];
+        double dx = xs[node] - xs[next];
+        double dy = ys[node] - ys[next];
+        objective += (long long)round(sqrt(dx * dx + dy * dy)) + costs[node];
+    }
+    if (objective != ecs_result_evaluation(solver))
+    {
+        fail(algorithm, "reported evaluation differs from the tour's objective");
+    }
+}
+
+static ecs_solver *create_solver(const ecs_instance *instance, const char *algorithm, const char *fraction)
+{
+    ecs_solver *solver = ecs_solver_create(instance, algorithm);
+    if (!solver || ecs_solver_set(solver, "seed", "7") != 0 || ecs_solver_set(solver, "fraction", fraction) != 0)
+    {
+        fail(algorithm, ecs_last_error());
+        ecs_solver_destroy(solver);
+        return NULL;
+    }
+    return solver;
+}
+
+// Short solves with two fractions: on 101 nodes 0.5 selects 50 nodes, not 51
+static void check_fractions(const ecs_instance *instance, const char *algorithm)
+{
+    const char *fractions[] = {"0.5", "0.3"};
+    const int sizes[] = {50, 30};
+    for (int k = 0; k < 2; k++)
+    {
+        ecs_solver *solver = create_solver(instance, algorithm, fractions[k]);
+        if (!solver)
+        {
+            continue;
+        }
+        if (ecs_solve(solver, 50.0) != 0)
+        {
+            fail(algorithm, ecs_last_error());
+        }
+        else
+        {
+            check_result(algorithm, solver, sizes[k]);
+            // HEA may spend so short a solve on its initial population, with no generation
+            int iterations = ecs_result_iterations(solver);
+            int valid;
+            if (strcmp(algorithm, "ls") == 0)
+                valid = iterations == 0;
+            else if (strncmp(algorithm, "nn-", 3) == 0)
+                valid = iterations == NUM_NODES;
+            else if (strncmp(algorithm, "hea", 3) == 0)
+                valid = iterations >= 0;
+            else
+                valid = iterations > 0;
+            if (!valid)
+            {
+                fail(algorithm, "unexpected iteration count");
+            }
+        }
+        ecs_solver_destroy(solver);
+    }
+}
+
+typedef struct
+{
+    ecs_solver *solver;
+    int status;
+    atomic_int done;
+} SolveTask;
+
+static void *run_solve(void *arg)
+{
+    SolveTask *task = (SolveTask *)arg;
+    task->status = ecs_solve(task->solver, 60000.0);
+    atomic_store(&task->done, 1);
+    return NULL;
+}
+
+// A minute-long solve on another thread, cancelled from this one, must return a valid tour
+// well before its time limit. Cancels issued before ecs_solve starts have no effect, so
+// cancelling repeats until the solve returns.
+static void check_cancel(const ecs_instance *instance, const char *algorithm)
+{
+    ecs_solver *solver = create_solver(instance, algorithm, "0.5");
+    if (!solver)
+    {
+        return;
+    }
+    SolveTask task;
+    task.solver = solver;
+    task.status = -1;
+    atomic_init(&task.done, 0);
+
+    double start = now_ms();
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, run_solve, &task) != 0)
+    {
+        fail(algorithm, "could not start the solving thread");
+        ecs_solver_destroy(solver);
+        return;
+    }
+    sleep_ms(100);
+    while (!atomic_load(&task.done))
+    {
+        ecs_cancel(solver);
+        sleep_ms(10);
+    }
+    pthread_join(thread, NULL);
+    double elapsed = now_ms() - start;
+
+    if (task.status != 0)
+    {
+        fail(algorithm, ecs_last_error());
+    }
+    else
+    {
+        check_result(algorithm, solver, 50);
+        if (elapsed > 20000.0)
+        {
+            fail(algorithm, "cancelled solve ran on");
+        }
+    }
+
+    // A cancel while no solve runs does not cut the next one short
+    ecs_cancel(solver);
+    if (ecs_solve(solver, 20.0) != 0 || ecs_result_evaluation(solver) < 0)
+    {
+        fail(algorithm, "solve after a cancel failed");
+    }
+    ecs_solver_destroy(solver);
+}
+
+// Invalid options fail and leave the solver usable with its previous options
+static void check_rejected_options(const ecs_instance *instance)
+{
+    ecs_solver *solver = create_solver(instance, "ils", "0.5");
+    if (!solver)
+    {
+        return;
+    }
+    // 0.02 of 101 nodes selects 2, fewer than a cycle needs
+    const char *keys[] = {"fraction", "fraction", "seed", "workers", "eval-threads"};
+    const char *values[] = {"0.02", "1.5", "-1", "-2", "-1"};
+    for (int k = 0; k < 5; k++)
+    {
+        if (ecs_solver_set(solver, keys[k], values[k]) == 0 || ecs_last_error()[0] == '\0')
+        {
+            char message[96];
+            snprintf(message, sizeof(message), "accepted %s = %s", keys[k], values[k]);
+            fail("ils", message);
+        }
+    }
+    if (ecs_solve(solver, 20.0) != 0)
+    {
+        fail("ils", ecs_last_error());
+    }
+    else
+    {
+        check_result("ils", solver, 50);
+    }
+    ecs_solver_destroy(solver);
+}
+
+int main(void)
+{
+    // A fixed linear congruential sequence, so the instance needs nothing beyond the C API
+    unsigned int state = 12345;
+    for (int i = 0; i < NUM_NODES; i++)
+    {
+        state = state * 1103515245u + 12345u;
+        xs[i] = (int)((state >> 8) % 2000);
+        state = state * 1103515245u + 12345u;
+        ys[i] = (int)((state >> 8) % 1000);
+        state = state * 1103515245u + 12345u;
+        costs[i] = (int)((state >> 8) % 500);
+    }
+    ecs_instance *instance = ecs_instance_create(xs, ys, costs, NUM_NODES);
+    if (!instance)
+    {
+        printf("FAILED ecs_instance_create: %s\n", ecs_last_error());
+        return 1;
+    }
+
+    for (int a = 0; a < NUM_ALGORITHMS; a++)
+    {
+        check_fractions(instance, ALGORITHMS[a]);
+        check_cancel(instance, ALGORITHMS[a]);
+    }
+    check_rejected_options(instance);
+    ecs_cancel(NULL);
+    ecs_instance_destroy(instance);
+
+    if (passed)
+    {
+        printf("%d algorithms solved, cancelled and selected floor(n * fraction) nodes\n", NUM_ALGORITHMS);
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+#include "InstanceGenerator.h"
+#include "RandomGenerator.h"
+
+#include "arena.h"
+#include "insertion.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+// insertion_insert updates the cheapest and second-cheapest insertion of every node from the
+// two new edges and rescans only the nodes whose entries referred to the replaced edge. After
+// every insertion of a construction, the cache is compared with costs recomputed over every
+// edge of the cycle: equal costs, and edges of the cycle that have those costs. On ties the
+// cache may name any of the tied edges.
+namespace {
+
+    struct CInstance {
+        std::vector<std::vector<int>> nodes;
+        std::vector<int*> data;
+        int** distances;
+        std::vector<int> costs;
+
+        explicit CInstance(const LS::InstanceData& instance)
+            : nodes(instance.size()), data(instance.size()), costs(instance.costs)
+        {
+            for (int i = 0; i < instance.size(); ++i)
+            {
+                nodes[i] = { instance.xs[i], instance.ys[i], instance.costs[i] };
+                data[i] = nodes[i].data();
+            }
+            distances = calcDistances(data.data(), instance.size());
+        }
+
+        ~CInstance()
+        {
+            free_distances(distances, static_cast<int>(data.size()));
+        }
+    };
+
+    enum class Order { Cheapest, LargestRegret, Random };
+
+    // Returns the number of cache entries that differ from the recomputation over cycle and
+    // reports the first one unless a previous check already reported one
+    int checkCache(const CInstance& instance, const InsertionCache& cache, const std::vector<int>& cycle, bool& reported)
+    {
+        int n = cache.num_nodes;
+        // successor[tail] is the head of the edge named by tail, -1 if tail is not in the cycle
+        std::vector<int> successor(n, -1);
+        for (std::size_t i = 0; i < cycle.size(); ++i)
+        {
+            successor[cycle[i]] = cycle[i + 1 == cycle.size() ? 0 : i + 1];
+        }
+        auto cost = [&](int tail, int k)
+        {
+            int head = successor[tail];
+            return instance.distances[tail][k] + instance.distances[k][head] - instance.distances[tail][head] + instance.costs[k];
+        };
+
+        int mismatches = 0;
+        std::vector<int> edgeCosts;
+        for (int k = 0; k < n; ++k)
+        {
+            if (successor[k] >= 0) continue;
+            edgeCosts.clear();
+            for (int tail : cycle)
+            {
+                edgeCosts.push_back(cost(tail, k));
+            }
+            std::partial_sort(edgeCosts.begin(), edgeCosts.begin() + 2, edgeCosts.end());
+            bool valid = cache.best_cost[k] == edgeCosts[0] && cache.second_cost[k] == edgeCosts[1] &&
+                         cache.best_edge[k] >= 0 && successor[cache.best_edge[k]] >= 0 &&
+                         cost(cache.best_edge[k], k) == edgeCosts[0] &&
+                         cache.second_edge[k] >= 0 && successor[cache.second_edge[k]] >= 0 &&
+                         cache.second_edge[k] != cache.best_edge[k] &&
+                         cost(cache.second_edge[k], k) == edgeCosts[1];
+            if (!valid)
+            {
+                if (!reported)
+                {
+                    reported = true;
+                    std::cout << "FAILED node " << k << " with " << cycle.size() << " nodes in the cycle: cached ("
+                              << cache.best_cost[k] << ", " << cache.second_cost[k] << "), recomputed ("
+                              << edgeCosts[0] << ", " << edgeCosts[1] << ")" << std::endl;
+                }
+                ++mismatches;
+            }
+        }
+        return mismatches;
+    }
+
+    int checkConstruction(const CInstance& instance, Order order, LS::Rng& rng)
+    {
+        int n = static_cast<int>(instance.costs.size());
+        Arena scratch;
+        if (!arena_init(&scratch, insertion_scratch_size(n)))
+        {
+            throw std::runtime_error("Could not allocate the cache");
+        }
+        int first = static_cast<int>(rng.bounded(n));
+        int second = (first + 1 + static_cast<int>(rng.bounded(n - 1))) % n;
+        InsertionCache cache;
+        insertion_init(&cache, const_cast<const int**>(instance.distances), instance.costs.data(), n, first, second, &scratch);
+        std::vector<int> cycle = { first, second };
+
+        bool reported = false;
+        int mismatches = checkCache(instance, cache, cycle, reported);
+        while (static_cast<int>(cycle.size()) < n)
+        {
+            int node = -1;
+            for (int k = 0; k < n; ++k)
+            {
+                if (cache.in_cycle[k]) continue;
+                if (node < 0 ||
+                    (order == Order::Cheapest && cache.best_cost[k] < cache.best_cost[node]) ||
+                    (order == Order::LargestRegret &&
+                     cache.second_cost[k] - cache.best_cost[k] > cache.second_cost[node] - cache.best_cost[node]))
+                {
+                    node = k;
+                }
+            }
+            if (order == Order::Random)
+            {
+                node = static_cast<int>(rng.bounded(n));
+                while (cache.in_cycle[node]) node = node + 1 == n ? 0 : node + 1;
+            }
+
+            int tail = cache.best_edge[node];
+            insertion_insert(&cache, node);
+            cycle.insert(std::find(cycle.begin(), cycle.end(), tail) + 1, node);
+            mismatches += checkCache(instance, cache, cycle, reported);
+        }
+
+        // The cache's own cycle is the one built here
+        std::vector<int> written(n);
+        insertion_write_cycle(&cache, first, written.data());
+        if (written != cycle)
+        {
+            std::cout << "FAILED the cached cycle differs from the inserted one" << std::endl;
+            ++mismatches;
+        }
+        arena_destroy(&scratch);
+        return mismatches;
+    }
+
+    bool check(const char* name, const LS::GeneratorConfig& config)
+    {
+        LS::InstanceData data = LS::generateInstance(config);
+        CInstance instance(data);
+        if (!instance.distances)
+        {
+            throw std::runtime_error("Could not build the instance");
+        }
+
+        LS::Rng rng(config.seed);
+        int mismatches = 0;
+        for (Order order : { Order::Cheapest, Order::LargestRegret, Order::Random })
+        {
+            mismatches += checkConstruction(instance, order, rng);
+        }
+        std::cout << name << ": " << mismatches << " mismatching cache entries" << std::endl;
+        return mismatches == 0;
+    }
+
+}
+
+int main()
+{
+    try
+    {
+        LS::GeneratorConfig uniform;
+        uniform.size = 400;
+        uniform.seed = 31;
+        LS::GeneratorConfig clustered = uniform;
+        clustered.layout = LS::Layout::Clustered;
+        clustered.seed = 32;
+        // Many equal distances and costs, so that edges often tie
+        LS::GeneratorConfig dense = uniform;
+        dense.width = 30;
+        dense.height = 20;
+        dense.minCost = 1;
+        dense.maxCost = 5;
+        dense.seed = 33;
+
+        bool passed = check("uniform", uniform);
+        passed = check("clustered", clustered) && passed;
+        passed = check("dense", dense) && passed;
+        return passed ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
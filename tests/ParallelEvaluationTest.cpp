@@ -0,0 +1,116 @@
+#include "LocalSearchSolver.h"
+#include "InstanceGenerator.h"
+#include "RandomSolution.h"
+#include "ThreadPool.h"
+#include "Deadline.h"
+
+#include <iostream>
+#include <string>
+
+// Steepest sweeps split over a pool must find the move a serial sweep finds, ties included.
+// Two solvers descend from the same start on an instance above the parallel threshold, one
+// of them with its sweeps split over a pool, and every neighborhood is compared after every
+// move of the descent.
+namespace LS {
+
+    struct Move {
+        int delta;
+        int arg1;
+        int arg2;
+    };
+
+    Move sweep(LocalSearchSolver& solver, int neighborhood)
+    {
+        Deadline unlimited;
+        Move move{};
+        if (neighborhood == 0)
+            solver.findBestInterNeighbor(move.delta, move.arg1, move.arg2, "STEEPEST", unlimited);
+        else if (neighborhood == 1)
+            solver.findBestIntraNeighborNodes(move.delta, move.arg1, move.arg2, "STEEPEST", unlimited);
+        else
+            solver.findBestIntraNeighborEdges(move.delta, move.arg1, move.arg2, "STEEPEST", unlimited);
+        return move;
+    }
+
+    bool checkDescent(const GeneratorConfig& generator, int steps)
+    {
+        InstanceData data = generateInstance(generator);
+        auto instance = DistanceMatrix::fromCoordinates(data.xs, data.ys, data.costs);
+        const double fractionNodes = 0.5;
+        Rng rng(generator.seed);
+        RandomSolution start;
+        start.generate(data.size(), static_cast<int>(data.size() * fractionNodes), rng);
+
+        LocalSearchSolver serial(instance, "serial", fractionNodes, start);
+        LocalSearchSolver parallel(instance, "parallel", fractionNodes, start);
+        ThreadPool pool(4);
+        parallel.setParallelEvaluation(&pool);
+
+        static const char* names[] = { "inter", "intra_nodes", "intra_edges" };
+        for (int step = 0; step < steps; ++step)
+        {
+            Move best{};
+            int bestNeighborhood = -1;
+            for (int neighborhood = 0; neighborhood < 3; ++neighborhood)
+            {
+                Move expected = sweep(serial, neighborhood);
+                Move actual = sweep(parallel, neighborhood);
+                if (actual.delta != expected.delta || actual.arg1 != expected.arg1 || actual.arg2 != expected.arg2)
+                {
+                    std::cout << "FAILED " << data.size() << " nodes, step " << step << ", " << names[neighborhood]
+                              << ": parallel (" << actual.delta << ", " << actual.arg1 << ", " << actual.arg2
+                              << "), serial (" << expected.delta << ", " << expected.arg1 << ", " << expected.arg2
+                              << ")" << std::endl;
+                    return false;
+                }
+                if (expected.delta < best.delta)
+                {
+                    best = expected;
+                    bestNeighborhood = neighborhood;
+                }
+            }
+            if (bestNeighborhood < 0)
+            {
+                break;
+            }
+            serial.applyMove(names[bestNeighborhood], best.arg1, best.arg2);
+            parallel.applyMove(names[bestNeighborhood], best.arg1, best.arg2);
+        }
+
+        if (parallel.getBestSolution() != serial.getBestSolution())
+        {
+            std::cout << "FAILED " << data.size() << " nodes: the descents reached different tours" << std::endl;
+            return false;
+        }
+        std::cout << data.size() << " nodes: the same moves over " << steps << " steps" << std::endl;
+        return true;
+    }
+
+}
+
+int main()
+{
+    try
+    {
+        LS::GeneratorConfig uniform;
+        uniform.size = 2 * LS::LocalSearchSolver::DEFAULT_PARALLEL_THRESHOLD;
+        uniform.seed = 11;
+        // A small grid of points has many equal distances, so ties between chunks are common
+        LS::GeneratorConfig grid = uniform;
+        grid.layout = LS::Layout::Grid;
+        grid.width = 40;
+        grid.height = 40;
+        grid.minCost = 1;
+        grid.maxCost = 3;
+        grid.seed = 12;
+
+        bool passed = LS::checkDescent(uniform, 25);
+        passed = LS::checkDescent(grid, 25) && passed;
+        return passed ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,161 @@
+#include "RandomGenerator.h"
+#include "rng.h"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// The seedable RNG layer has a C implementation (01_greedy_heuristics/src/rng.c) and a C++ one
+// (LS::Rng) that must produce the same streams, so that a seed means the same run in both
+// codebases. Both are checked against the reference vectors of xoshiro256** and splitmix64
+// and against fixed outputs, bounded values and jumped streams for one seed.
+namespace {
+
+    bool passed = true;
+
+    void expectEqual(const char* what, int index, uint64_t actual, uint64_t expected)
+    {
+        if (actual != expected)
+        {
+            std::cout << "FAILED " << what << " [" << index << "]: " << actual << " instead of " << expected << std::endl;
+            passed = false;
+        }
+    }
+
+    // Outputs of xoshiro256** from the state {1, 2, 3, 4}
+    const uint64_t XOSHIRO_REFERENCE[] = { 11520ULL, 0ULL, 1509978240ULL, 1215971899390074240ULL,
+                                           1216172134540287360ULL, 607988272756665600ULL };
+
+    // First outputs of splitmix64 seeded with 1234567, the state rng_seed derives from that seed
+    const uint64_t SPLITMIX_SEED = 1234567ULL;
+    const uint64_t SPLITMIX_REFERENCE[] = { 6457827717110365317ULL, 3203168211198807973ULL,
+                                            9817491932198370423ULL, 4593380528125082431ULL };
+
+    // Seed 42: the first outputs, bounded(10), bounded(100), ... of a fresh generator, and the
+    // first outputs of the second and third streams of a split
+    const uint64_t SEED = 42ULL;
+    const uint64_t SEEDED_OUTPUTS[] = { 1546998764402558742ULL, 6990951692964543102ULL,
+                                        12544586762248559009ULL, 17057574109182124193ULL };
+    const uint32_t BOUNDS[] = { 10, 100, 7, 1000, 200, 3 };
+    const uint32_t BOUNDED_OUTPUTS[] = { 0, 37, 4, 924, 198, 2 };
+    const uint64_t SPLIT_OUTPUTS[2][3] = {
+        { 5766981335298035530ULL, 13414075677763163907ULL, 6818771422820058410ULL },
+        { 9689321145619467905ULL, 2258870915674454393ULL, 13756082229112209005ULL }
+    };
+
+    void checkC()
+    {
+        Rng rng = { { 1, 2, 3, 4 } };
+        for (int i = 0; i < 6; ++i)
+        {
+            expectEqual("C reference outputs", i, rng_next(&rng), XOSHIRO_REFERENCE[i]);
+        }
+
+        rng_seed(&rng, SPLITMIX_SEED);
+        for (int i = 0; i < 4; ++i)
+        {
+            expectEqual("C splitmix64 seeding", i, rng.s[i], SPLITMIX_REFERENCE[i]);
+        }
+
+        rng_seed(&rng, SEED);
+        for (int i = 0; i < 4; ++i)
+        {
+            expectEqual("C seeded outputs", i, rng_next(&rng), SEEDED_OUTPUTS[i]);
+        }
+
+        rng_seed(&rng, SEED);
+        for (int i = 0; i < 6; ++i)
+        {
+            expectEqual("C bounded", i, rng_bounded(&rng, BOUNDS[i]), BOUNDED_OUTPUTS[i]);
+        }
+
+        Rng streams[3];
+        rng_split(streams, 3, SEED);
+        for (int i = 0; i < 4; ++i)
+        {
+            expectEqual("C first stream", i, rng_next(&streams[0]), SEEDED_OUTPUTS[i]);
+        }
+        for (int stream = 1; stream < 3; ++stream)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                expectEqual("C split stream", stream * 10 + i, rng_next(&streams[stream]), SPLIT_OUTPUTS[stream - 1][i]);
+            }
+        }
+    }
+
+    void checkCpp()
+    {
+        // The state of LS::Rng is private: its splitmix64 seeding is checked through the
+        // xoshiro256** outputs of the reference state
+        Rng reference = { { SPLITMIX_REFERENCE[0], SPLITMIX_REFERENCE[1], SPLITMIX_REFERENCE[2], SPLITMIX_REFERENCE[3] } };
+        LS::Rng seeded(SPLITMIX_SEED);
+        for (int i = 0; i < 6; ++i)
+        {
+            expectEqual("C++ splitmix64 seeding", i, seeded(), rng_next(&reference));
+        }
+
+        LS::Rng rng(SEED);
+        for (int i = 0; i < 4; ++i)
+        {
+            expectEqual("C++ seeded outputs", i, rng(), SEEDED_OUTPUTS[i]);
+        }
+
+        rng.seed(SEED);
+        for (int i = 0; i < 6; ++i)
+        {
+            expectEqual("C++ bounded", i, rng.bounded(BOUNDS[i]), BOUNDED_OUTPUTS[i]);
+        }
+
+        std::vector<LS::Rng> streams = LS::Rng::split(SEED, 3);
+        for (int i = 0; i < 4; ++i)
+        {
+            expectEqual("C++ first stream", i, streams[0](), SEEDED_OUTPUTS[i]);
+        }
+        for (int stream = 1; stream < 3; ++stream)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                expectEqual("C++ split stream", stream * 10 + i, streams[stream](), SPLIT_OUTPUTS[stream - 1][i]);
+            }
+        }
+    }
+
+    // Both implementations side by side over a longer stream, with bounds that reject
+    void checkSameStreams()
+    {
+        Rng c;
+        rng_seed(&c, 2024);
+        LS::Rng cpp(2024);
+        for (int i = 0; i < 1000; ++i)
+        {
+            expectEqual("C and C++ outputs", i, cpp(), rng_next(&c));
+            uint32_t bound = 3000000000U - static_cast<uint32_t>(i);
+            expectEqual("C and C++ bounded", i, cpp.bounded(bound), rng_bounded(&c, bound));
+        }
+
+        Rng cStreams[4];
+        rng_split(cStreams, 4, 2024);
+        std::vector<LS::Rng> cppStreams = LS::Rng::split(2024, 4);
+        for (int stream = 0; stream < 4; ++stream)
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                expectEqual("C and C++ split streams", stream * 1000 + i, cppStreams[stream](), rng_next(&cStreams[stream]));
+            }
+        }
+    }
+
+}
+
+int main()
+{
+    checkC();
+    checkCpp();
+    checkSameStreams();
+    if (passed)
+    {
+        std::cout << "C and C++ generators match the reference and each other" << std::endl;
+    }
+    return passed ? 0 : 1;
+}
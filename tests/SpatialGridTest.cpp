@@ -0,0 +1,171 @@
+#include "InstanceGenerator.h"
+#include "RandomGenerator.h"
+
+#include "arena.h"
+#include "spatial_grid.h"
+#include "utils.h"
+
+#include <climits>
+#include <iostream>
+#include <vector>
+
+// spatial_view_nearest stops its ring search at a lower bound instead of scanning every node.
+// Along constructions that remove nodes one after another, every query is compared with a
+// scan of the whole row over the nodes still available: same minimum, same tied nodes in
+// index order, with and without node costs.
+namespace {
+
+    struct CInstance {
+        std::vector<std::vector<int>> nodes;
+        std::vector<int*> data;
+        int** distances;
+        std::vector<int> costs;
+
+        explicit CInstance(const LS::InstanceData& instance)
+            : nodes(instance.size()), data(instance.size()), costs(instance.costs)
+        {
+            for (int i = 0; i < instance.size(); ++i)
+            {
+                nodes[i] = { instance.xs[i], instance.ys[i], instance.costs[i] };
+                data[i] = nodes[i].data();
+            }
+            distances = calcDistances(data.data(), instance.size());
+        }
+
+        ~CInstance()
+        {
+            free_distances(distances, static_cast<int>(data.size()));
+        }
+    };
+
+    // Every available node attaining the minimum of distances[from][j] + costs[j], in index order
+    std::vector<int> scanRow(const CInstance& instance, const std::vector<char>& available, const int* costs, int from)
+    {
+        std::vector<int> nearest;
+        int best = INT_MAX;
+        for (int j = 0; j < static_cast<int>(available.size()); ++j)
+        {
+            if (!available[j]) continue;
+            int value = instance.distances[from][j] + (costs ? costs[j] : 0);
+            if (value < best)
+            {
+                best = value;
+                nearest.clear();
+            }
+            if (value == best)
+            {
+                nearest.push_back(j);
+            }
+        }
+        return nearest;
+    }
+
+    // Walks from a random start to the nearest node, and now and then removes a random node
+    // as well, until no node is left; returns the number of mismatching queries
+    int checkConstruction(const CInstance& instance, const SpatialGrid& grid, const int* costs, LS::Rng& rng)
+    {
+        int n = grid.num_nodes;
+        Arena scratch;
+        if (!arena_init(&scratch, spatial_view_scratch_size(&grid)))
+        {
+            throw std::runtime_error("Could not allocate the view");
+        }
+        SpatialView view;
+        spatial_view_init(&view, &grid, &scratch);
+
+        std::vector<char> available(n, 1);
+        std::vector<int> nearest(n);
+        int left = n;
+        auto remove = [&](int node)
+        {
+            spatial_view_remove(&view, node);
+            available[node] = 0;
+            --left;
+        };
+
+        int mismatches = 0;
+        int current = static_cast<int>(rng.bounded(n));
+        remove(current);
+        while (left > 0)
+        {
+            const int** distances = const_cast<const int**>(instance.distances);
+            int count = spatial_view_nearest(&view, distances, costs, current, nearest.data());
+            std::vector<int> expected = scanRow(instance, available, costs, current);
+            if (std::vector<int>(nearest.begin(), nearest.begin() + count) != expected)
+            {
+                if (mismatches == 0)
+                {
+                    std::cout << "FAILED query from " << current << " with " << left << " nodes left: grid found "
+                              << count << " nodes, the scan " << expected.size() << std::endl;
+                }
+                ++mismatches;
+            }
+
+            current = expected[rng.bounded(static_cast<uint32_t>(expected.size()))];
+            remove(current);
+            if (left > 0 && rng.bounded(4) == 0)
+            {
+                int skipped = static_cast<int>(rng.bounded(n));
+                while (!available[skipped]) skipped = skipped + 1 == n ? 0 : skipped + 1;
+                remove(skipped);
+            }
+        }
+        arena_destroy(&scratch);
+        return mismatches;
+    }
+
+    bool check(const char* name, const LS::GeneratorConfig& config)
+    {
+        LS::InstanceData data = LS::generateInstance(config);
+        CInstance instance(data);
+        SpatialGrid grid;
+        if (!instance.distances || !spatial_grid_build(&grid, instance.data.data(), data.size()))
+        {
+            throw std::runtime_error("Could not build the instance");
+        }
+
+        LS::Rng rng(config.seed);
+        int mismatches = 0;
+        for (int run = 0; run < 3; ++run)
+        {
+            mismatches += checkConstruction(instance, grid, instance.costs.data(), rng);
+            mismatches += checkConstruction(instance, grid, nullptr, rng);
+        }
+        std::cout << name << ": " << grid.cells_x << "x" << grid.cells_y << " cells, " << mismatches
+                  << " mismatching queries" << std::endl;
+        spatial_grid_free(&grid);
+        return mismatches == 0;
+    }
+
+}
+
+int main()
+{
+    try
+    {
+        LS::GeneratorConfig uniform;
+        uniform.size = 1000;
+        uniform.seed = 21;
+        LS::GeneratorConfig clustered = uniform;
+        clustered.layout = LS::Layout::Clustered;
+        clustered.seed = 22;
+        // Cells of the minimum size 1 and many equal distances and costs
+        LS::GeneratorConfig dense = uniform;
+        dense.size = 600;
+        dense.width = 30;
+        dense.height = 20;
+        dense.minCost = 1;
+        dense.maxCost = 5;
+        dense.seed = 23;
+
+        bool passed = check("uniform", uniform);
+        passed = check("clustered", clustered) && passed;
+        passed = check("dense", dense) && passed;
+        return passed ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,196 @@
+#include "Solution.h"
+#include "TourHash.h"
+#include "RandomGenerator.h"
+
+#include "delta_local_search.h"
+#include "tour_hash.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Every move updates the tour hash incrementally; a hash that drifts from the tour makes a
+// SeenSet skip descents it has not seen. Random moves of every kind are applied to a
+// Solution and its hash is compared with TourHash::of and tour_hash after each one. The
+// descents of delta_local_search.c are built with TOUR_HASH_CHECK, which compares the
+// running hash with tour_hash after each move they apply.
+namespace {
+
+    bool passed = true;
+
+    void fail(const std::string& message)
+    {
+        std::cout << "FAILED " << message << std::endl;
+        passed = false;
+    }
+
+    void checkSolutionMoves(int totalNodes, int steps, uint64_t seed)
+    {
+        LS::Rng rng(seed);
+        LS::Solution solution;
+        std::vector<int> unselected(totalNodes);
+        for (int i = 0; i < totalNodes; ++i) unselected[i] = i;
+        auto takeUnselected = [&]()
+        {
+            int k = static_cast<int>(rng.bounded(static_cast<uint32_t>(unselected.size())));
+            int node = unselected[k];
+            unselected[k] = unselected.back();
+            unselected.pop_back();
+            return node;
+        };
+
+        static const char* names[] = { "addNode", "removeNode", "removeNodes", "exchangeNodeAtIndex",
+                                       "exchangeTwoNodes", "exchangeTwoEdges", "setNodes" };
+        int mismatches = 0;
+        int largest = 0;
+        for (int step = 0; step < steps; ++step)
+        {
+            int size = solution.getNumberOfNodes();
+            // Adds are drawn three times as often, balancing the removals of one and of up to
+            // three nodes, so tours wander between empty and full
+            int move = static_cast<int>(rng.bounded(9));
+            if (move > 6) move = 0;
+            if (size == 0 || (move == 3 && unselected.empty()) || (move == 0 && size > 0 && unselected.empty()))
+            {
+                move = size == 0 ? 0 : 1;
+            }
+            int index1 = size > 0 ? static_cast<int>(rng.bounded(size)) : 0;
+            int index2 = size > 0 ? static_cast<int>(rng.bounded(size)) : 0;
+            switch (move)
+            {
+            case 0:
+                solution.addNode(takeUnselected());
+                break;
+            case 1:
+                unselected.push_back(solution.getNodeAtIndex(index1));
+                solution.removeNode(index1);
+                break;
+            case 2:
+            {
+                int amount = std::min(size - index1, 1 + static_cast<int>(rng.bounded(3)));
+                for (int k = 0; k < amount; ++k) unselected.push_back(solution.getNodeAtIndex(index1 + k));
+                solution.removeNodes(index1, amount);
+                break;
+            }
+            case 3:
+            {
+                int node = takeUnselected();
+                unselected.push_back(solution.getNodeAtIndex(index1));
+                solution.exchangeNodeAtIndex(index1, node);
+                break;
+            }
+            case 4:
+                solution.exchangeTwoNodes(index1, index2);
+                break;
+            case 5:
+                solution.exchangeTwoEdges(index1, index2);
+                break;
+            default:
+            {
+                // A rotated copy hashes like the tour, and setNodes recomputes the hash
+                std::vector<int> rotated(solution.getNodes());
+                std::rotate(rotated.begin(), rotated.begin() + index1, rotated.end());
+                uint64_t before = solution.getHash();
+                solution.setNodes(rotated);
+                if (solution.getHash() != before) ++mismatches;
+                break;
+            }
+            }
+
+            const std::vector<int>& nodes = solution.getNodes();
+            largest = std::max(largest, static_cast<int>(nodes.size()));
+            uint64_t expected = LS::TourHash::of(nodes);
+            if (solution.getHash() != expected || tour_hash(nodes.data(), static_cast<int>(nodes.size())) != expected)
+            {
+                if (mismatches == 0)
+                {
+                    fail(std::string(names[move]) + " at step " + std::to_string(step) + " on " +
+                         std::to_string(size) + " nodes: the running hash differs from TourHash::of");
+                }
+                ++mismatches;
+            }
+        }
+        std::cout << "Solution, " << totalNodes << " nodes: " << steps << " moves on tours of up to " << largest
+                  << " nodes, " << mismatches << " mismatches" << std::endl;
+        if (mismatches > 0) passed = false;
+    }
+
+    void checkDescents(const char* filename, int starts)
+    {
+        int numNodes = 0;
+        int** data = read_file(filename, &numNodes);
+        if (!data)
+        {
+            throw std::runtime_error(std::string("Could not read ") + filename);
+        }
+        int** distances = calcDistances(data, numNodes);
+        const int** rows = const_cast<const int**>(distances);
+        std::vector<int> costs(numNodes);
+        for (int i = 0; i < numNodes; ++i) costs[i] = data[i][2];
+
+        int solutionSize = (numNodes + 1) / 2;
+        std::vector<int> all(numNodes);
+        for (int i = 0; i < numNodes; ++i) all[i] = i;
+        Arena scratch;
+        if (!arena_init(&scratch, delta_local_search_scratch_size(numNodes)))
+        {
+            throw std::runtime_error("Could not allocate the descent scratch");
+        }
+        ::Rng rng;
+        rng_seed(&rng, 5);
+
+        tour_hash_checked_moves = 0;
+        tour_hash_check_failures = 0;
+        for (int start = 0; start < starts; ++start)
+        {
+            rng_shuffle(&rng, all.data(), numNodes);
+            std::vector<int> solution(all.begin(), all.begin() + solutionSize);
+            SeenSet* seen = seen_set_create(1 << 16);
+            arena_reset(&scratch);
+            int cost = delta_local_search_run(solution.data(), solutionSize, rows, costs.data(), numNodes, &scratch, nullptr, seen);
+            if (cost == DESCENT_SEEN || cost == INT_MAX)
+            {
+                fail("descent from a fresh set did not complete");
+            }
+            // The last running hash went into the set: a descent from the optimum, which hashes
+            // it from scratch, finds it there
+            arena_reset(&scratch);
+            if (delta_local_search_run(solution.data(), solutionSize, rows, costs.data(), numNodes, &scratch, nullptr, seen) != DESCENT_SEEN)
+            {
+                fail("descent from a local optimum did not find it in the set");
+            }
+            seen_set_destroy(seen);
+        }
+        arena_destroy(&scratch);
+
+        std::cout << filename << ": " << tour_hash_checked_moves << " moves of " << starts << " descents, "
+                  << tour_hash_check_failures << " mismatches" << std::endl;
+        if (tour_hash_checked_moves == 0 || tour_hash_check_failures != 0)
+        {
+            fail("running hash of the descents");
+        }
+        free_distances(distances, numNodes);
+        free_data(data, numNodes);
+    }
+
+}
+
+int main()
+{
+    try
+    {
+        checkSolutionMoves(8, 20000, 1);
+        checkSolutionMoves(200, 20000, 2);
+        checkDescents(TEST_DATA_DIR "/TSPA.csv", 20);
+        checkDescents(TEST_DATA_DIR "/TSPB.csv", 20);
+        return passed ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,131 @@
+#include "InstanceGenerator.h"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// Writes a synthetic instance for scaling studies, e.g.
+//   GenerateInstance --size 100000 --layout clustered --costs exponential --seed 7 --output C100k.csv
+namespace LS {
+
+    struct GenerateOptions {
+        GeneratorConfig config;
+        std::string format = "csv";
+        std::string output;
+        bool helpRequested = false;
+    };
+
+    std::string usage(const char* program)
+    {
+        std::ostringstream out;
+        out << "Usage: " << program << " --size N --output FILE [options]\n"
+            << "  --size N               number of nodes\n"
+            << "  --output FILE          instance file, - writes to stdout\n"
+            << "  --layout NAME          uniform, clustered or grid (default uniform)\n"
+            << "  --costs NAME           uniform, normal or exponential (default uniform)\n"
+            << "  --seed N               seed (default 1)\n"
+            << "  --format NAME          csv, x;y;cost lines like TSPA.csv (default csv)\n"
+            << "  --width N, --height N  extent of the coordinates (default 4000 x 2000)\n"
+            << "  --min-cost N           lowest node cost (default 100)\n"
+            << "  --max-cost N           highest node cost (default 2000)\n"
+            << "  --clusters N           clusters of the clustered layout (default max(4, size / 1000))\n"
+            << "  --spread X             standard deviation of a cluster (default width / 40)\n"
+            << "  --help                 print this message\n";
+        return out.str();
+    }
+
+    GenerateOptions parseOptions(int argc, char** argv)
+    {
+        GenerateOptions options;
+        GeneratorConfig& config = options.config;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h")
+            {
+                options.helpRequested = true;
+                return options;
+            }
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value or unknown option: " + arg);
+            }
+            std::string value = argv[++i];
+            if (arg == "--size")
+                config.size = std::stoi(value);
+            else if (arg == "--output")
+                options.output = value;
+            else if (arg == "--layout")
+                config.layout = parseLayout(value);
+            else if (arg == "--costs")
+                config.costDistribution = parseCostDistribution(value);
+            else if (arg == "--seed")
+                config.seed = std::stoull(value);
+            else if (arg == "--format")
+                options.format = value;
+            else if (arg == "--width")
+                config.width = std::stoi(value);
+            else if (arg == "--height")
+                config.height = std::stoi(value);
+            else if (arg == "--min-cost")
+                config.minCost = std::stoi(value);
+            else if (arg == "--max-cost")
+                config.maxCost = std::stoi(value);
+            else if (arg == "--clusters")
+                config.clusters = std::stoi(value);
+            else if (arg == "--spread")
+                config.clusterSpread = std::stod(value);
+            else
+                throw std::runtime_error("Unknown option: " + arg);
+        }
+        if (options.output.empty())
+        {
+            throw std::runtime_error("--output is required");
+        }
+        config.validate();
+        return options;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    LS::GenerateOptions options;
+    std::unique_ptr<LS::InstanceWriter> writer;
+    try
+    {
+        options = LS::parseOptions(argc, argv);
+        if (options.helpRequested)
+        {
+            std::cout << LS::usage(argv[0]);
+            return 0;
+        }
+        writer = LS::makeInstanceWriter(options.format);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl << LS::usage(argv[0]);
+        return 1;
+    }
+
+    try
+    {
+        LS::InstanceData instance = LS::generateInstance(options.config);
+        if (options.output == "-")
+        {
+            writer->write(instance, std::cout);
+        }
+        else
+        {
+            writer->writeFile(instance, options.output);
+            std::cerr << "Wrote " << instance.size() << " nodes to " << options.output << std::endl;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
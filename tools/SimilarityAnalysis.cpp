@@ -0,0 +1,237 @@
+#include "LocalSearchSolver.h"
+#include "RandomSolution.h"
+#include "Similarity.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// Fitness-distance analysis: descends from random solutions and writes, for every local
+// optimum, its evaluation and the edges and nodes it shares with the best optimum and on
+// average with all others, e.g.
+//   SimilarityAnalysis --instance data/TSPA.csv --solutions 1000 --output TSPA_similarity.csv
+namespace LS {
+
+    struct AnalysisOptions {
+        std::string instance;
+        std::string output;
+        int solutions = 1000;
+        std::string neighborhood = "TWO_EDGES";
+        std::string search = "GREEDY";
+        double fractionNodes = 0.5;
+        uint64_t seed = 1;
+        unsigned int threads = 0;
+        bool helpRequested = false;
+    };
+
+    std::string usage(const char* program)
+    {
+        std::ostringstream out;
+        out << "Usage: " << program << " --instance FILE --output FILE [options]\n"
+            << "  --instance FILE        instance file like TSPA.csv\n"
+            << "  --output FILE          CSV of the local optima, - writes to stdout\n"
+            << "  --solutions N          local optima to compare (default 1000)\n"
+            << "  --neighborhood NAME    two-edges or two-nodes (default two-edges)\n"
+            << "  --search NAME          greedy or steepest (default greedy)\n"
+            << "  --fraction X           fraction of the nodes in a solution (default 0.5)\n"
+            << "  --seed N               seed (default 1)\n"
+            << "  --threads N            descents in parallel, 0 uses all hardware threads (default 0)\n"
+            << "  --help                 print this message\n";
+        return out.str();
+    }
+
+    AnalysisOptions parseOptions(int argc, char** argv)
+    {
+        AnalysisOptions options;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h")
+            {
+                options.helpRequested = true;
+                return options;
+            }
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value or unknown option: " + arg);
+            }
+            std::string value = argv[++i];
+            if (arg == "--instance")
+                options.instance = value;
+            else if (arg == "--output")
+                options.output = value;
+            else if (arg == "--solutions")
+                options.solutions = std::stoi(value);
+            else if (arg == "--neighborhood")
+            {
+                if (value != "two-edges" && value != "two-nodes")
+                    throw std::runtime_error("Unknown neighborhood: " + value);
+                options.neighborhood = value == "two-edges" ? "TWO_EDGES" : "TWO_NODES";
+            }
+            else if (arg == "--search")
+            {
+                if (value != "greedy" && value != "steepest")
+                    throw std::runtime_error("Unknown search: " + value);
+                options.search = value == "greedy" ? "GREEDY" : "STEEPEST";
+            }
+            else if (arg == "--fraction")
+                options.fractionNodes = std::stod(value);
+            else if (arg == "--seed")
+                options.seed = std::stoull(value);
+            else if (arg == "--threads")
+                options.threads = static_cast<unsigned int>(std::stoul(value));
+            else
+                throw std::runtime_error("Unknown option: " + arg);
+        }
+        if (options.instance.empty() || options.output.empty())
+        {
+            throw std::runtime_error("--instance and --output are required");
+        }
+        if (options.solutions < 2)
+        {
+            throw std::runtime_error("--solutions must be at least 2");
+        }
+        if (options.fractionNodes <= 0.0 || options.fractionNodes > 1.0)
+        {
+            throw std::runtime_error("--fraction must be in (0, 1]");
+        }
+        return options;
+    }
+
+    void writeRows(const std::vector<SimilarityRow>& rows, int reference, std::ostream& out)
+    {
+        out << "solution,evaluation,is_best,common_edges_best,common_nodes_best,avg_common_edges,avg_common_nodes\n";
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            const SimilarityRow& row = rows[i];
+            out << i << ',' << row.evaluation << ',' << (static_cast<int>(i) == reference ? 1 : 0) << ','
+                << row.edgesToReference << ',' << row.nodesToReference << ','
+                << row.averageEdges << ',' << row.averageNodes << '\n';
+        }
+    }
+
+    // Correlation of the evaluation with each similarity measure, the best optimum left out
+    // of the comparisons with itself
+    void printCorrelations(const std::vector<SimilarityRow>& rows, int reference)
+    {
+        std::vector<double> evaluations, edgesBest, nodesBest, averageEdges, averageNodes;
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            if (static_cast<int>(i) == reference)
+            {
+                continue;
+            }
+            evaluations.push_back(rows[i].evaluation);
+            edgesBest.push_back(rows[i].edgesToReference);
+            nodesBest.push_back(rows[i].nodesToReference);
+            averageEdges.push_back(rows[i].averageEdges);
+            averageNodes.push_back(rows[i].averageNodes);
+        }
+        std::cerr << "Correlation with the evaluation:\n"
+                  << "  common edges with best:    " << correlation(evaluations, edgesBest) << "\n"
+                  << "  common nodes with best:    " << correlation(evaluations, nodesBest) << "\n"
+                  << "  average common edges:      " << correlation(evaluations, averageEdges) << "\n"
+                  << "  average common nodes:      " << correlation(evaluations, averageNodes) << std::endl;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    LS::AnalysisOptions options;
+    try
+    {
+        options = LS::parseOptions(argc, argv);
+        if (options.helpRequested)
+        {
+            std::cout << LS::usage(argv[0]);
+            return 0;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl << LS::usage(argv[0]);
+        return 1;
+    }
+
+    try
+    {
+        auto instance = LS::DistanceMatrix::load(options.instance);
+        std::string instanceName = LS::BaseSolver::instanceNameFromFilename(options.instance);
+        int totalNodes = static_cast<int>(instance->getCosts().size());
+        int numNodes = static_cast<int>(totalNodes * options.fractionNodes);
+
+        // One stream per descent, so the optima do not depend on the number of threads
+        std::vector<LS::Rng> streams = LS::Rng::split(options.seed, options.solutions);
+        LS::ThreadPool pool(options.threads);
+        std::vector<std::unique_ptr<LS::LocalSearchSolver>> solvers;
+        LS::RandomSolution initialSolution;
+        LS::Rng initialRng = streams[0];
+        initialSolution.generate(totalNodes, numNodes, initialRng);
+        for (unsigned int w = 0; w < pool.size(); ++w)
+        {
+            solvers.emplace_back(new LS::LocalSearchSolver(instance, instanceName, options.fractionNodes, initialSolution));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::vector<int>> tours(options.solutions);
+        std::vector<int> evaluations(options.solutions);
+        pool.parallelFor(options.solutions, [&](int i, unsigned int worker)
+        {
+            LS::LocalSearchSolver& solver = *solvers[worker];
+            LS::Rng rng = streams[i];
+            LS::RandomSolution randomSolution;
+            randomSolution.generate(totalNodes, numNodes, rng);
+            solver.setRng(rng);
+            solver.setInitialSolutionCopy(randomSolution);
+            solver.runBasic(options.neighborhood, options.search);
+            tours[i] = solver.getBestFullSolution().getNodes();
+            evaluations[i] = solver.getBestSolutionEval();
+        });
+        auto descended = std::chrono::steady_clock::now();
+
+        LS::SimilarityIndex index(totalNodes);
+        int reference = 0;
+        for (int i = 0; i < options.solutions; ++i)
+        {
+            index.add(tours[i]);
+            if (evaluations[i] < evaluations[reference])
+            {
+                reference = i;
+            }
+        }
+        std::vector<LS::SimilarityRow> rows = LS::fitnessSimilarity(index, evaluations, reference);
+        auto compared = std::chrono::steady_clock::now();
+
+        if (options.output == "-")
+        {
+            LS::writeRows(rows, reference, std::cout);
+        }
+        else
+        {
+            std::ofstream out(options.output);
+            if (!out)
+            {
+                throw std::runtime_error("Could not open file for writing: " + options.output);
+            }
+            LS::writeRows(rows, reference, out);
+            std::cerr << "Wrote " << rows.size() << " local optima of " << instanceName << " to " << options.output << std::endl;
+        }
+
+        using Ms = std::chrono::duration<double, std::milli>;
+        std::cerr << "Best: " << evaluations[reference] << ", descents " << Ms(descended - start).count()
+                  << " ms, comparisons " << Ms(compared - descended).count() << " ms" << std::endl;
+        LS::printCorrelations(rows, reference);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}